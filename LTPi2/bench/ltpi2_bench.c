@@ -0,0 +1,575 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/utsname.h>
+#include "ltpi2.h"
+#include "nucleos.h"
+
+// --- BENCHMARK DAS PRIMITIVAS E DO CÁLCULO DE PI ---
+/*
+ * Mede multiplicação, divisão, raiz quadrada, quadrado e conversão decimal
+ * numa varredura geométrica de tamanhos (10 blocos .. 10M blocos, fator
+ * sqrt(10)) e calcular_pi de 1k a 100M dígitos, com a divisão do tempo por
+ * fase (série, fechamento, conversão).
+ *
+ * Método:
+ *   - relógio de parede monotônico (CLOCK_MONOTONIC);
+ *   - calibração: a operação é repetida em lote até uma amostra durar ao
+ *     menos AMOSTRA_MINIMA_S (as execuções da calibração servem de
+ *     aquecimento, além das --aquecimento explícitas);
+ *   - --repeticoes amostras por tamanho; guardamos mínimo, mediana, média e
+ *     máximo;
+ *   - uma série para de crescer quando a mediana passa de --limite-tempo.
+ *
+ * Os núcleos básicos (nucleos.h) são medidos em cada versão que a CPU
+ * executa (escalar, AVX2, AVX-512...), com a aceleração sobre a escalar no
+ * mesmo tamanho; o nome do resultado é "nucleo.versao".
+ *
+ * Saída em JSON, com um resultado por linha para que a própria ferramenta (e
+ * scripts simples) possam ler o arquivo de volta. Com --base, cada resultado
+ * é comparado ao mesmo (operação, tamanho) no arquivo base. O mínimo é a
+ * estatística estável (o ruído só soma tempo), e a faixa mínimo–máximo de
+ * cada execução mede o ruído dela. Uma regressão exige as três condições:
+ *   - faixas separadas: o mínimo atual passa do máximo da base;
+ *   - o mínimo atual passa de 1 + tolerância vezes o mínimo da base;
+ *   - a diferença dos mínimos passa de --piso segundos por execução, para
+ *     que núcleos de nanossegundos não reprovem por ruído de relógio.
+ * Uma máquina compartilhada pode ficar lenta por mais tempo que as amostras
+ * de um ponto; por isso um ponto que parece regressão é medido de novo (até
+ * CONFIRMACOES vezes, após 1, 2, 4... segundos, ficando a medida de menor
+ * mínimo) antes de contar. A
+ * variação entre execuções inteiras só aparece com várias bases: --base
+ * repetido junta os arquivos, e a faixa de cada ponto passa a cobrir todos.
+ * Com alguma regressão o programa sai com código 1.
+ */
+
+#define AMOSTRA_MINIMA_S 0.02
+#define PISO_PADRAO_S 1e-6
+#define CONFIRMACOES 3
+#define MAX_BASES 8
+#define MAX_RESULTADOS 1024
+#define MAX_REPETICOES 64
+
+typedef struct {
+    char operacao[32];
+    const char *unidade;
+    long tamanho;
+    int repeticoes;
+    long lote;              // Execuções por amostra
+    double minimo, mediana, media, maximo;
+    int tem_fases;
+    TemposPi fases;         // Médias por execução (só para "pi")
+} Resultado;
+
+static struct {
+    int aquecimento;
+    int repeticoes;
+    double limite_tempo;
+    long min_blocos, max_blocos;
+    long min_digitos, max_digitos;
+    int threads;
+    double tolerancia;
+    double piso;            // Diferença mínima (s por execução) para uma regressão
+    const char *saida;
+    const char *bases[MAX_BASES];   // --base, uma ou mais vezes
+    int num_bases;
+    const char *filtro;     // Só operações cujo nome contém este texto
+    const char *nucleos;    // Versão forçada dos núcleos (NULL = a escolhida por cpuid)
+    int fatores;            // "pi" medido nos dois modos: pi.simples e pi.fatores
+} config = { 1, 5, 5.0, 10, 10000000, 1000, 100000000, 1, 0.10, PISO_PADRAO_S, "bench_resultado.json", { NULL }, 0, NULL, NULL, 0 };
+
+static double relogio(void) {
+    struct timespec agora;
+    clock_gettime(CLOCK_MONOTONIC, &agora);
+    return (double)agora.tv_sec + (double)agora.tv_nsec * 1e-9;
+}
+
+// --- CASOS DE TESTE ---
+
+typedef struct {
+    GrandeNumero *a, *b, *r;
+    const NucleosBlocos *versao;  // Só para os núcleos
+    uint32_t *x, *y, *z;
+    long n;
+    long digitos;
+    TemposPi fases;         // Soma das fases das execuções de pi
+    long execucoes_pi;
+} Caso;
+
+static uint64_t estado_aleatorio = 0x9E3779B97F4A7C15ULL;
+
+static uint32_t aleatorio32(void) {
+    estado_aleatorio ^= estado_aleatorio << 13;
+    estado_aleatorio ^= estado_aleatorio >> 7;
+    estado_aleatorio ^= estado_aleatorio << 17;
+    return (uint32_t)estado_aleatorio;
+}
+
+static GrandeNumero* numero_aleatorio(long blocos) {
+    GrandeNumero *x = criar_grande_numero((int)blocos);
+    for (long i = 0; i < blocos; i++) x->blocos[i] = aleatorio32();
+    x->blocos[blocos - 1] |= 1u << 31;
+    x->quantidade_blocos = (int)blocos;
+    return x;
+}
+
+static void preparar_produto(Caso *c, long n) {
+    c->a = numero_aleatorio(n);
+    c->b = numero_aleatorio(n);
+    c->r = criar_grande_numero(1);
+}
+
+// Divisão 2n / n e raiz de 2n blocos: quociente e raiz com n blocos
+static void preparar_dobro(Caso *c, long n) {
+    c->a = numero_aleatorio(2 * n);
+    c->b = numero_aleatorio(n);
+    c->r = criar_grande_numero(1);
+}
+
+static uint32_t* vetor_aleatorio(long blocos) {
+    uint32_t *v = (uint32_t*)malloc((size_t)blocos * sizeof(uint32_t));
+    for (long i = 0; i < blocos; i++) v[i] = aleatorio32();
+    return v;
+}
+
+static void preparar_nucleo(Caso *c, long n) {
+    c->x = vetor_aleatorio(n);
+    c->y = vetor_aleatorio(n);
+    c->z = (uint32_t*)malloc(2 * (size_t)n * sizeof(uint32_t));
+    c->n = n;
+}
+
+static void preparar_pi(Caso *c, long n) {
+    c->digitos = n;
+}
+
+static void executar_multiplicacao(Caso *c) { multiplicar_grandes_numeros(c->a, c->b, c->r); }
+static void executar_quadrado(Caso *c) { elevar_ao_quadrado(c->a, c->r); }
+static void executar_divisao(Caso *c) { dividir_grande_numero(c->a, c->b, c->r); }
+static void executar_raiz(Caso *c) { raiz_quadrada(c->a, c->r); }
+static void executar_conversao(Caso *c) { free(grande_numero_para_string(c->a)); }
+
+static void executar_somar(Caso *c) { c->versao->somar(c->z, c->x, c->y, (int)c->n, 0); }
+static void executar_subtrair(Caso *c) { c->versao->subtrair(c->z, c->x, c->y, (int)c->n, 0); }
+static void executar_multiplicar_1(Caso *c) { c->versao->multiplicar_1(c->z, c->x, (int)c->n, c->y[0]); }
+static void executar_multiplicar_basico(Caso *c) { c->versao->multiplicar(c->z, c->x, (int)c->n, c->y, (int)c->n); }
+static void executar_quadrado_basico(Caso *c) { c->versao->quadrado(c->z, c->x, (int)c->n); }
+
+static void executar_pi(Caso *c) {
+    free(calcular_pi((int)c->digitos));
+    TemposPi t;
+    obter_tempos_pi(&t);
+    c->fases.serie += t.serie;
+    c->fases.fechamento += t.fechamento;
+    c->fases.conversao += t.conversao;
+    c->fases.total += t.total;
+    c->execucoes_pi++;
+}
+
+static void limpar_caso(Caso *c) {
+    liberar_grande_numero(c->a);
+    liberar_grande_numero(c->b);
+    liberar_grande_numero(c->r);
+    free(c->x);
+    free(c->y);
+    free(c->z);
+    memset(c, 0, sizeof(*c));
+}
+
+typedef struct {
+    const char *nome;
+    const char *unidade;
+    void (*preparar)(Caso *c, long n);
+    void (*executar)(Caso *c);
+    int por_versao;         // Medido em cada versão dos núcleos
+    long maximo;            // Teto próprio de tamanho (0 = o da linha de comando)
+} Operacao;
+
+static const Operacao operacoes[] = {
+    { "somar",          "blocos",  preparar_nucleo,  executar_somar,              1, 0 },
+    { "subtrair",       "blocos",  preparar_nucleo,  executar_subtrair,           1, 0 },
+    { "multiplicar_1",  "blocos",  preparar_nucleo,  executar_multiplicar_1,      1, 0 },
+    { "mult_basica",    "blocos",  preparar_nucleo,  executar_multiplicar_basico, 1, 1000 },
+    { "quad_basico",    "blocos",  preparar_nucleo,  executar_quadrado_basico,    1, 1000 },
+    { "multiplicar",    "blocos",  preparar_produto, executar_multiplicacao,      0, 0 },
+    { "quadrado",       "blocos",  preparar_produto, executar_quadrado,           0, 0 },
+    { "dividir",        "blocos",  preparar_dobro,   executar_divisao,            0, 0 },
+    { "raiz",           "blocos",  preparar_dobro,   executar_raiz,               0, 0 },
+    { "conversao",      "blocos",  preparar_produto, executar_conversao,          0, 0 },
+    { "pi",             "digitos", preparar_pi,      executar_pi,                 0, 0 },
+};
+#define NUM_OPERACOES ((int)(sizeof(operacoes) / sizeof(operacoes[0])))
+
+// --- MEDIÇÃO ---
+
+static int comparar_doubles(const void *x, const void *y) {
+    double a = *(const double*)x, b = *(const double*)y;
+    return (a > b) - (a < b);
+}
+
+// Tempo de uma amostra de 'lote' execuções, por execução
+static double amostra(const Operacao *op, Caso *c, long lote) {
+    double inicio = relogio();
+    for (long i = 0; i < lote; i++) op->executar(c);
+    return (relogio() - inicio) / (double)lote;
+}
+
+static void medir(const Operacao *op, const NucleosBlocos *versao, long tamanho, Resultado *res) {
+    Caso caso;
+    memset(&caso, 0, sizeof(caso));
+    caso.versao = versao;
+    op->preparar(&caso, tamanho);
+
+    for (int i = 0; i < config.aquecimento; i++) op->executar(&caso);
+
+    // Calibração do lote: dobra até uma amostra durar AMOSTRA_MINIMA_S
+    long lote = 1;
+    double t = amostra(op, &caso, lote);
+    while (t * (double)lote < AMOSTRA_MINIMA_S && lote < (1L << 30)) {
+        lote = (t > 0) ? (long)(AMOSTRA_MINIMA_S / t) + 1 : lote * 2;
+        if (lote > (1L << 30)) lote = 1L << 30;
+        t = amostra(op, &caso, lote);
+    }
+    memset(&caso.fases, 0, sizeof(caso.fases));
+    caso.execucoes_pi = 0;
+
+    double tempos[MAX_REPETICOES];
+    double soma = 0;
+    for (int i = 0; i < config.repeticoes; i++) {
+        tempos[i] = amostra(op, &caso, lote);
+        soma += tempos[i];
+    }
+    qsort(tempos, (size_t)config.repeticoes, sizeof(double), comparar_doubles);
+
+    if (op->por_versao) {
+        snprintf(res->operacao, sizeof(res->operacao), "%s.%s", op->nome, versao->nome);
+    } else {
+        snprintf(res->operacao, sizeof(res->operacao), "%s", op->nome);
+    }
+    res->unidade = op->unidade;
+    res->tamanho = tamanho;
+    res->repeticoes = config.repeticoes;
+    res->lote = lote;
+    res->minimo = tempos[0];
+    res->mediana = tempos[config.repeticoes / 2];
+    res->media = soma / config.repeticoes;
+    res->maximo = tempos[config.repeticoes - 1];
+    res->tem_fases = (caso.execucoes_pi > 0);
+    if (res->tem_fases) {
+        double n = (double)caso.execucoes_pi;
+        res->fases.serie = caso.fases.serie / n;
+        res->fases.fechamento = caso.fases.fechamento / n;
+        res->fases.conversao = caso.fases.conversao / n;
+        res->fases.total = caso.fases.total / n;
+    }
+    limpar_caso(&caso);
+}
+
+// Modo do binary splitting em "pi" (-1 = o padrão da biblioteca, sem sufixo)
+static void medir_ponto(const Operacao *op, const NucleosBlocos *versao, int modo_fatores, long tamanho, Resultado *res) {
+    if (modo_fatores < 0) {
+        medir(op, versao, tamanho, res);
+        return;
+    }
+    definir_modo_fatores(modo_fatores);
+    medir(op, versao, tamanho, res);
+    definir_modo_fatores(0);
+    snprintf(res->operacao, sizeof(res->operacao), "%s.%s", op->nome, modo_fatores ? "fatores" : "simples");
+}
+
+// --- JSON ---
+
+static void escrever_resultado_json(FILE *f, const Resultado *r, int ultimo) {
+    fprintf(f, "    {\"operacao\": \"%s\", \"unidade\": \"%s\", \"tamanho\": %ld, \"repeticoes\": %d, \"lote\": %ld, "
+               "\"min_s\": %.9e, \"mediana_s\": %.9e, \"media_s\": %.9e, \"max_s\": %.9e",
+            r->operacao, r->unidade, r->tamanho, r->repeticoes, r->lote, r->minimo, r->mediana, r->media, r->maximo);
+    if (r->tem_fases) {
+        fprintf(f, ", \"fases\": {\"serie_s\": %.6e, \"fechamento_s\": %.6e, \"conversao_s\": %.6e, \"total_s\": %.6e}",
+                r->fases.serie, r->fases.fechamento, r->fases.conversao, r->fases.total);
+    }
+    fprintf(f, "}%s\n", ultimo ? "" : ",");
+}
+
+static int escrever_json(const char *caminho, const Resultado *resultados, int n) {
+    FILE *f = fopen(caminho, "w");
+    if (f == NULL) {
+        printf("ERRO: Não foi possível criar '%s'\n", caminho);
+        return -1;
+    }
+
+    char data[64];
+    time_t agora = time(NULL);
+    strftime(data, sizeof(data), "%Y-%m-%dT%H:%M:%S%z", localtime(&agora));
+    struct utsname maquina;
+    if (uname(&maquina) != 0) strcpy(maquina.machine, "?");
+
+    fprintf(f, "{\n");
+    fprintf(f, "  \"formato\": \"ltpi2-bench-1\",\n");
+    fprintf(f, "  \"data\": \"%s\",\n", data);
+    fprintf(f, "  \"maquina\": \"%s %s\",\n", maquina.nodename, maquina.machine);
+    fprintf(f, "  \"compilador\": \"%s\",\n", __VERSION__);
+    fprintf(f, "  \"threads\": %d,\n", config.threads);
+    fprintf(f, "  \"nucleos\": \"%s\",\n", nucleos_ativos->nome);
+    fprintf(f, "  \"aquecimento\": %d,\n", config.aquecimento);
+    fprintf(f, "  \"resultados\": [\n");
+    for (int i = 0; i < n; i++) escrever_resultado_json(f, &resultados[i], i == n - 1);
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+    return 0;
+}
+
+// Valor de "chave" numa linha de resultado (formato escrito acima)
+static const char* procurar_chave(const char *linha, const char *chave) {
+    char padrao[64];
+    snprintf(padrao, sizeof(padrao), "\"%s\": ", chave);
+    const char *p = strstr(linha, padrao);
+    return (p != NULL) ? p + strlen(padrao) : NULL;
+}
+
+// Mesmo (operação, tamanho) na base, ou NULL
+static const Resultado* procurar_na_base(const Resultado *r, const Resultado *base, int n_base) {
+    for (int j = 0; j < n_base; j++) {
+        if (strcmp(base[j].operacao, r->operacao) == 0 && base[j].tamanho == r->tamanho && base[j].minimo > 0) return &base[j];
+    }
+    return NULL;
+}
+
+// Lê os resultados de um arquivo gerado por esta ferramenta e os junta aos n
+// já lidos: um ponto presente em vários arquivos fica com a faixa que cobre
+// todas. Retorna o novo total, ou -1.
+static int ler_json(const char *caminho, Resultado *resultados, int n, int capacidade) {
+    FILE *f = fopen(caminho, "r");
+    if (f == NULL) {
+        printf("ERRO: Não foi possível abrir a base '%s'\n", caminho);
+        return -1;
+    }
+    char linha[1024];
+    while (fgets(linha, sizeof(linha), f) != NULL) {
+        const char *operacao = procurar_chave(linha, "operacao");
+        const char *tamanho = procurar_chave(linha, "tamanho");
+        const char *mediana = procurar_chave(linha, "mediana_s");
+        const char *minimo = procurar_chave(linha, "min_s");
+        const char *maximo = procurar_chave(linha, "max_s");
+        if (operacao == NULL || tamanho == NULL || mediana == NULL) continue;
+
+        Resultado lido;
+        memset(&lido, 0, sizeof(lido));
+        if (sscanf(operacao, "\"%31[^\"]\"", lido.operacao) != 1) continue;
+        lido.tamanho = strtol(tamanho, NULL, 10);
+        lido.mediana = strtod(mediana, NULL);
+        // Bases antigas não têm o máximo: a faixa fica mínimo–mediana
+        lido.minimo = (minimo != NULL) ? strtod(minimo, NULL) : lido.mediana;
+        lido.maximo = (maximo != NULL) ? strtod(maximo, NULL) : lido.mediana;
+        if (lido.minimo <= 0) continue;
+
+        Resultado *r = (Resultado*)procurar_na_base(&lido, resultados, n);
+        if (r != NULL) {
+            if (lido.minimo < r->minimo) r->minimo = lido.minimo;
+            if (lido.maximo > r->maximo) r->maximo = lido.maximo;
+        } else if (n < capacidade) {
+            resultados[n++] = lido;
+        }
+    }
+    fclose(f);
+    return n;
+}
+
+static int regrediu(const Resultado *a, const Resultado *b) {
+    return a->minimo > b->maximo && a->minimo > b->minimo * (1 + config.tolerancia) &&
+           a->minimo - b->minimo > config.piso;
+}
+
+static int melhorou(const Resultado *a, const Resultado *b) {
+    return a->maximo < b->minimo && a->minimo < b->minimo * (1 - config.tolerancia) &&
+           b->minimo - a->minimo > config.piso;
+}
+
+// Compara com a base; retorna o número de regressões
+static int comparar_com_base(const Resultado *atuais, int n, const Resultado *base, int n_base) {
+    int regressoes = 0, comparados = 0;
+    printf("\nComparação dos mínimos com %d base(s) (tolerância %.0f%%, piso %.1e s):\n",
+           config.num_bases, config.tolerancia * 100, config.piso);
+    printf("  %-20s %12s %14s %14s %8s\n", "operação", "tamanho", "base (s)", "atual (s)", "razão");
+    for (int i = 0; i < n; i++) {
+        const Resultado *a = &atuais[i];
+        const Resultado *b = procurar_na_base(a, base, n_base);
+        if (b == NULL) continue;
+
+        const char *marca = "";
+        if (regrediu(a, b)) {
+            marca = "  REGRESSÃO";
+            regressoes++;
+        } else if (melhorou(a, b)) {
+            marca = "  melhora";
+        }
+        printf("  %-20s %12ld %14.6e %14.6e %8.3f%s\n",
+               a->operacao, a->tamanho, b->minimo, a->minimo, a->minimo / b->minimo, marca);
+        comparados++;
+    }
+    printf("%d resultados comparados, %d regressões\n", comparados, regressoes);
+    return regressoes;
+}
+
+// --- LINHA DE COMANDO ---
+
+static void uso(const char *programa) {
+    printf("Uso: %s [opções]\n", programa);
+    printf("  --saida ARQ          JSON de saída (padrão %s)\n", config.saida);
+    printf("  --base ARQ           compara com um JSON anterior e sai com 1 se houver regressão; repetida (até %d),\n", MAX_BASES);
+    printf("                       a faixa de cada ponto cobre todas as bases\n");
+    printf("  --tolerancia X       razão dos mínimos acima de 1+X, com as faixas separadas, é regressão (padrão %.2f)\n", config.tolerancia);
+    printf("  --piso S             diferenças menores que S segundos por execução nunca são regressão (padrão %.0e)\n", config.piso);
+    printf("  --repeticoes N       amostras por tamanho (padrão %d, máx. %d)\n", config.repeticoes, MAX_REPETICOES);
+    printf("  --aquecimento N      execuções descartadas antes da calibração (padrão %d)\n", config.aquecimento);
+    printf("  --limite-tempo S     para uma série quando a mediana passa de S segundos (padrão %.1f)\n", config.limite_tempo);
+    printf("  --blocos MIN:MAX     varredura das primitivas (padrão %ld:%ld)\n", config.min_blocos, config.max_blocos);
+    printf("  --digitos MIN:MAX    varredura de calcular_pi (padrão %ld:%ld)\n", config.min_digitos, config.max_digitos);
+    printf("  --threads N          threads de calcular_pi (padrão %d)\n", config.threads);
+    printf("  --filtro NOME        só operações cujo nome contém NOME\n");
+    printf("  --fatores            mede calcular_pi sem e com o modo com fatores (pi.simples e pi.fatores)\n");
+    printf("  --nucleos NOME       força a versão dos núcleos (escalar, avx2, avx512, avx512ifma) nas operações\n");
+    printf("                       da biblioteca; os núcleos básicos só são medidos na escalar e nesta\n");
+}
+
+static int ler_intervalo(const char *texto, long *minimo, long *maximo) {
+    return (sscanf(texto, "%ld:%ld", minimo, maximo) == 2 && *minimo > 0 && *maximo >= *minimo) ? 0 : -1;
+}
+
+static int ler_argumentos(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        const char *opcao = argv[i];
+        const char *valor = (i + 1 < argc) ? argv[i + 1] : NULL;
+        int ok = 1;
+        if (strcmp(opcao, "--ajuda") == 0 || strcmp(opcao, "-h") == 0) {
+            uso(argv[0]);
+            exit(0);
+        } else if (strcmp(opcao, "--fatores") == 0) {
+            config.fatores = 1;
+            continue;
+        } else if (valor == NULL) {
+            ok = 0;
+        } else if (strcmp(opcao, "--saida") == 0) {
+            config.saida = valor;
+        } else if (strcmp(opcao, "--base") == 0) {
+            ok = (config.num_bases < MAX_BASES);
+            if (ok) config.bases[config.num_bases++] = valor;
+        } else if (strcmp(opcao, "--tolerancia") == 0) {
+            config.tolerancia = atof(valor);
+        } else if (strcmp(opcao, "--piso") == 0) {
+            config.piso = atof(valor);
+            ok = (config.piso >= 0);
+        } else if (strcmp(opcao, "--repeticoes") == 0) {
+            config.repeticoes = atoi(valor);
+            ok = (config.repeticoes >= 1 && config.repeticoes <= MAX_REPETICOES);
+        } else if (strcmp(opcao, "--aquecimento") == 0) {
+            config.aquecimento = atoi(valor);
+        } else if (strcmp(opcao, "--limite-tempo") == 0) {
+            config.limite_tempo = atof(valor);
+        } else if (strcmp(opcao, "--blocos") == 0) {
+            ok = (ler_intervalo(valor, &config.min_blocos, &config.max_blocos) == 0);
+        } else if (strcmp(opcao, "--digitos") == 0) {
+            ok = (ler_intervalo(valor, &config.min_digitos, &config.max_digitos) == 0);
+        } else if (strcmp(opcao, "--threads") == 0) {
+            config.threads = atoi(valor);
+        } else if (strcmp(opcao, "--filtro") == 0) {
+            config.filtro = valor;
+        } else if (strcmp(opcao, "--nucleos") == 0) {
+            config.nucleos = valor;
+            ok = (definir_nucleos(valor) == 0);
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            printf("ERRO: Opção inválida ou sem valor: %s\n", opcao);
+            uso(argv[0]);
+            return -1;
+        }
+        i++;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (ler_argumentos(argc, argv) != 0) return 2;
+    definir_numero_threads(config.threads);
+
+    static Resultado resultados[MAX_RESULTADOS];
+    int n = 0;
+
+    // A base é lida antes das medidas, para confirmar as regressões aparentes
+    static Resultado base[MAX_RESULTADOS];
+    int n_base = 0;
+    for (int i = 0; i < config.num_bases; i++) {
+        n_base = ler_json(config.bases[i], base, n_base, MAX_RESULTADOS);
+        if (n_base < 0) return 2;
+    }
+
+    const NucleosBlocos *versoes[8];
+    int num_versoes = listar_nucleos(versoes, 8);
+    if (config.nucleos != NULL) {
+        // Só a escalar (referência da aceleração) e a forçada
+        versoes[1] = nucleos_ativos;
+        num_versoes = (nucleos_ativos == versoes[0]) ? 1 : 2;
+    }
+    printf("Núcleos da biblioteca: %s\n", nucleos_ativos->nome);
+
+    printf("%-20s %12s %10s %14s %14s\n", "operação", "tamanho", "lote", "mediana (s)", "mínimo (s)");
+    for (int k = 0; k < NUM_OPERACOES; k++) {
+        const Operacao *op = &operacoes[k];
+        if (config.filtro != NULL && strstr(op->nome, config.filtro) == NULL) continue;
+
+        // Varredura geométrica: blocos com fator sqrt(10), dígitos com fator 10
+        int eh_pi = (strcmp(op->unidade, "digitos") == 0);
+        long minimo = eh_pi ? config.min_digitos : config.min_blocos;
+        long maximo = eh_pi ? config.max_digitos : config.max_blocos;
+        if (op->maximo > 0 && op->maximo < maximo) maximo = op->maximo;
+        double fator = eh_pi ? 10.0 : sqrt(10.0);
+
+        for (double x = (double)minimo; x <= (double)maximo * 1.0001; x *= fator) {
+            long tamanho = (long)llround(x);
+            // Com --fatores, "pi" é medido nos dois modos como se fossem versões
+            int modos = (eh_pi && config.fatores);
+            int versoes_medidas = op->por_versao ? num_versoes : modos ? 2 : 1;
+            if (n + versoes_medidas > MAX_RESULTADOS) break;
+
+            double referencia = 0;   // Mediana da versão escalar (ou do modo simples)
+            for (int v = 0; v < versoes_medidas; v++) {
+                Resultado *r = &resultados[n++];
+                const NucleosBlocos *versao = op->por_versao ? versoes[v] : versoes[0];
+                int modo = modos ? v : -1;
+                medir_ponto(op, versao, modo, tamanho, r);
+                const Resultado *b = procurar_na_base(r, base, n_base);
+                for (int c = 0; c < CONFIRMACOES && b != NULL && regrediu(r, b); c++) {
+                    // Espera crescente, para sair de um período lento da máquina
+                    sleep(1u << c);
+                    Resultado outra;
+                    medir_ponto(op, versao, modo, tamanho, &outra);
+                    if (outra.minimo < r->minimo) *r = outra;
+                }
+
+                printf("%-20s %12ld %10ld %14.6e %14.6e", r->operacao, r->tamanho, r->lote, r->mediana, r->minimo);
+                if (r->tem_fases) {
+                    printf("   série %.3fs, fechamento %.3fs, conversão %.3fs",
+                           r->fases.serie, r->fases.fechamento, r->fases.conversao);
+                }
+                if (op->por_versao || modos) {
+                    if (v == 0) referencia = r->mediana;
+                    else printf("   aceleração %.2fx", referencia / r->mediana);
+                }
+                printf("\n");
+                fflush(stdout);
+            }
+            if (resultados[n - versoes_medidas].mediana > config.limite_tempo) break;
+        }
+    }
+
+    if (escrever_json(config.saida, resultados, n) != 0) return 2;
+    printf("\nResultados salvos em '%s'.\n", config.saida);
+
+    if (config.num_bases > 0 && comparar_com_base(resultados, n, base, n_base) > 0) return 1;
+    return 0;
+}
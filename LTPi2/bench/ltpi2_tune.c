@@ -0,0 +1,341 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <time.h>
+#include <math.h>
+#include <sys/utsname.h>
+#include "grandes_numeros.h"
+
+// --- AJUSTE DOS LIMIARES PARA ESTA MÁQUINA ---
+/*
+ * Para cada limiar, compara o algoritmo de cima com o de baixo no próprio
+ * tamanho n, no estilo do tuneup do GMP: com o limiar em n o nível mais alto
+ * da recursão usa o algoritmo novo e os subproblemas (menores que n) seguem
+ * com os limiares já ajustados; com o limiar logo acima de n, o nível mais
+ * alto usa o algoritmo anterior. Os limiares ainda não ajustados ficam no
+ * "infinito", então cada comparação envolve só os dois vizinhos.
+ *
+ * A vantagem em n é a mediana das razões t_novo / t_anterior de várias
+ * amostras intercaladas (o ruído da máquina afeta os dois lados igualmente).
+ * Supondo uma única troca na faixa de busca, uma bissecção geométrica acha
+ * o menor n com razão < 1; perto da troca as curvas quase se tocam, então
+ * um erro de alguns por cento no limiar custa pouco.
+ *
+ * Ordem: multiplicação (Karatsuba, Toom-3, Toom-4, NTT), quadrados, divisão
+ * exata, divisão de Newton (que já usa os produtos ajustados) e conversão
+ * decimal (que usa as divisões). A raiz quadrada não tem limiar próprio:
+ * é Newton do início ao fim e herda os limiares de produtos e quadrados.
+ *
+ * Saída: um limiares.h no formato do repositório (--saida) e/ou um arquivo
+ * de parâmetros para carregar_limiares (--parametros).
+ */
+
+#define INFINITO (1 << 30)
+#define MAX_REPETICOES 64
+
+static struct {
+    int repeticoes;
+    double amostra_minima;     // Segundos por amostra
+    const char *saida;
+    const char *parametros;
+    const char *filtro;
+} config = { 7, 0.005, NULL, NULL, NULL };
+
+static double relogio(void) {
+    struct timespec agora;
+    clock_gettime(CLOCK_MONOTONIC, &agora);
+    return (double)agora.tv_sec + (double)agora.tv_nsec * 1e-9;
+}
+
+// --- CASOS DE TESTE ---
+
+typedef struct {
+    GrandeNumero *a, *b, *r;
+} Caso;
+
+static uint64_t estado_aleatorio = 0x2545F4914F6CDD1DULL;
+
+static uint32_t aleatorio32(void) {
+    estado_aleatorio ^= estado_aleatorio << 13;
+    estado_aleatorio ^= estado_aleatorio >> 7;
+    estado_aleatorio ^= estado_aleatorio << 17;
+    return (uint32_t)estado_aleatorio;
+}
+
+static GrandeNumero* numero_aleatorio(int blocos) {
+    GrandeNumero *x = criar_grande_numero(blocos);
+    for (int i = 0; i < blocos; i++) x->blocos[i] = aleatorio32();
+    x->blocos[blocos - 1] |= 1u << 31;
+    x->quantidade_blocos = blocos;
+    return x;
+}
+
+static void preparar_produto(Caso *c, int n) {
+    c->a = numero_aleatorio(n);
+    c->b = numero_aleatorio(n);
+    c->r = criar_grande_numero(1);
+}
+
+// Divisão 2n / n: divisor e quociente com n blocos
+static void preparar_divisao(Caso *c, int n) {
+    c->a = numero_aleatorio(2 * n);
+    c->b = numero_aleatorio(n);
+    c->r = criar_grande_numero(1);
+}
+
+// Dividendo múltiplo exato de um divisor ímpar de n blocos
+static void preparar_divisao_exata(Caso *c, int n) {
+    GrandeNumero *q = numero_aleatorio(n);
+    c->b = numero_aleatorio(n);
+    c->b->blocos[0] |= 1;
+    c->a = criar_grande_numero(2 * n);
+    multiplicar_grandes_numeros(q, c->b, c->a);
+    liberar_grande_numero(q);
+    c->r = criar_grande_numero(1);
+}
+
+static void executar_multiplicacao(Caso *c) { multiplicar_grandes_numeros(c->a, c->b, c->r); }
+static void executar_quadrado(Caso *c) { elevar_ao_quadrado(c->a, c->r); }
+static void executar_divisao(Caso *c) { dividir_grande_numero(c->a, c->b, c->r); }
+static void executar_divisao_exata(Caso *c) { dividir_exato(c->a, c->b, c->r); }
+static void executar_conversao(Caso *c) { free(grande_numero_para_string(c->a)); }
+
+static void limpar_caso(Caso *c) {
+    liberar_grande_numero(c->a);
+    liberar_grande_numero(c->b);
+    liberar_grande_numero(c->r);
+}
+
+// --- PARÂMETROS ---
+
+typedef struct {
+    const char *nome;          // Campo de Limiares / chave do arquivo de parâmetros
+    const char *macro;         // Nome em limiares.h
+    size_t deslocamento;
+    int inclusivo;             // 1: algoritmo anterior enquanto n <= limiar; 0: enquanto n < limiar
+    size_t piso;               // Campo cujo valor ajustado é o início da busca (ou -1)
+    int minimo, maximo;        // Faixa da busca
+    void (*preparar)(Caso *c, int n);
+    void (*executar)(Caso *c);
+} Parametro;
+
+#define CAMPO(x) offsetof(Limiares, x)
+#define SEM_PISO ((size_t)-1)
+
+static const Parametro parametros[] = {
+    { "karatsuba",          "LIMIAR_KARATSUBA",          CAMPO(karatsuba),          0, SEM_PISO,                   8,  128,    preparar_produto, executar_multiplicacao },
+    { "toom3",              "LIMIAR_TOOM3",              CAMPO(toom3),              0, CAMPO(karatsuba),           24, 2048,   preparar_produto, executar_multiplicacao },
+    { "toom4",              "LIMIAR_TOOM4",              CAMPO(toom4),              0, CAMPO(toom3),               32, 8192,   preparar_produto, executar_multiplicacao },
+    { "ntt",                "LIMIAR_NTT",                CAMPO(ntt),                0, CAMPO(toom4),               64, 131072, preparar_produto, executar_multiplicacao },
+    { "quadrado_karatsuba", "LIMIAR_QUADRADO_KARATSUBA", CAMPO(quadrado_karatsuba), 0, SEM_PISO,                   8,  192,    preparar_produto, executar_quadrado },
+    { "quadrado_toom3",     "LIMIAR_QUADRADO_TOOM3",     CAMPO(quadrado_toom3),     0, CAMPO(quadrado_karatsuba),  24, 2048,   preparar_produto, executar_quadrado },
+    { "quadrado_toom4",     "LIMIAR_QUADRADO_TOOM4",     CAMPO(quadrado_toom4),     0, CAMPO(quadrado_toom3),      32, 8192,   preparar_produto, executar_quadrado },
+    { "quadrado_ntt",       "LIMIAR_QUADRADO_NTT",       CAMPO(quadrado_ntt),       0, CAMPO(quadrado_toom4),      64, 131072, preparar_produto, executar_quadrado },
+    { "divisao_exata",      "LIMIAR_DIVISAO_EXATA",      CAMPO(divisao_exata),      1, SEM_PISO,                   8,  8192,   preparar_divisao_exata, executar_divisao_exata },
+    { "divisao_newton",     "LIMIAR_DIVISAO_NEWTON",     CAMPO(divisao_newton),     0, SEM_PISO,                   64, 16384,  preparar_divisao, executar_divisao },
+    { "conversao",          "LIMIAR_CONVERSAO",          CAMPO(conversao),          1, SEM_PISO,                   8,  1024,   preparar_produto, executar_conversao },
+};
+#define NUM_PARAMETROS ((int)(sizeof(parametros) / sizeof(parametros[0])))
+
+static int* campo(Limiares *l, size_t deslocamento) {
+    return (int*)((char*)l + deslocamento);
+}
+
+// --- MEDIÇÃO ---
+
+static Limiares atuais;
+
+// Tempo por execução de um lote, com o limiar do parâmetro em 'valor'
+static double amostra(const Parametro *p, Caso *c, int valor, long lote) {
+    *campo(&atuais, p->deslocamento) = valor;
+    definir_limiares(&atuais);
+    double inicio = relogio();
+    for (long i = 0; i < lote; i++) p->executar(c);
+    return (relogio() - inicio) / (double)lote;
+}
+
+static int comparar_doubles(const void *x, const void *y) {
+    double a = *(const double*)x, b = *(const double*)y;
+    return (a > b) - (a < b);
+}
+
+// Mediana de t_novo / t_anterior no tamanho n (< 1: o algoritmo novo vence)
+static double razao_em(const Parametro *p, int n) {
+    int anterior = p->inclusivo ? n : n + 1;
+    int novo = p->inclusivo ? n - 1 : n;
+
+    Caso caso;
+    p->preparar(&caso, n);
+
+    // Aquecimento e calibração do lote (pelo algoritmo anterior)
+    long lote = 1;
+    amostra(p, &caso, novo, 1);
+    double t = amostra(p, &caso, anterior, lote);
+    while (t * (double)lote < config.amostra_minima) {
+        lote = (t > 0) ? (long)(config.amostra_minima / t) + 1 : lote * 2;
+        t = amostra(p, &caso, anterior, lote);
+    }
+
+    double razoes[MAX_REPETICOES];
+    for (int i = 0; i < config.repeticoes; i++) {
+        // Alterna a ordem para não favorecer quem roda com o cache quente
+        double t_anterior, t_novo;
+        if (i % 2 == 0) {
+            t_anterior = amostra(p, &caso, anterior, lote);
+            t_novo = amostra(p, &caso, novo, lote);
+        } else {
+            t_novo = amostra(p, &caso, novo, lote);
+            t_anterior = amostra(p, &caso, anterior, lote);
+        }
+        razoes[i] = t_novo / t_anterior;
+    }
+    limpar_caso(&caso);
+
+    qsort(razoes, (size_t)config.repeticoes, sizeof(double), comparar_doubles);
+    double razao = razoes[config.repeticoes / 2];
+    printf("    n = %-7d razão %.3f\n", n, razao);
+    fflush(stdout);
+    return razao;
+}
+
+// Menor n na faixa em que o algoritmo novo vence
+static int ajustar(const Parametro *p, int minimo, int maximo) {
+    if (razao_em(p, maximo) >= 1.0) {
+        printf("  AVISO: %s não vence até %d blocos; limiar fica em %d\n", p->nome, maximo, maximo);
+        return maximo;
+    }
+    if (razao_em(p, minimo) < 1.0) return minimo;
+
+    int baixo = minimo, alto = maximo;   // razão(baixo) >= 1 > razão(alto)
+    while (alto - baixo > 1 && (double)alto > (double)baixo * 1.06) {
+        int meio = (int)lround(sqrt((double)baixo * (double)alto));
+        if (meio <= baixo) meio = baixo + 1;
+        if (meio >= alto) meio = alto - 1;
+        if (razao_em(p, meio) < 1.0) alto = meio; else baixo = meio;
+    }
+    return alto;
+}
+
+// --- SAÍDA ---
+
+static int escrever_cabecalho(const char *caminho, const Limiares *l) {
+    FILE *f = fopen(caminho, "w");
+    if (f == NULL) {
+        printf("ERRO: Não foi possível criar '%s'\n", caminho);
+        return -1;
+    }
+    char data[32];
+    time_t agora = time(NULL);
+    strftime(data, sizeof(data), "%Y-%m-%d", localtime(&agora));
+    struct utsname maquina;
+    if (uname(&maquina) != 0) strcpy(maquina.machine, "?");
+
+    fprintf(f, "#ifndef LIMIARES_H\n#define LIMIARES_H\n\n");
+    fprintf(f, "// Limiares de troca de algoritmo, em blocos de 32 bits (ver Limiares em\n");
+    fprintf(f, "// grandes_numeros.h). Gerado por `make tune` em %s (%s %s).\n\n",
+            data, maquina.nodename, maquina.machine);
+    for (int i = 0; i < NUM_PARAMETROS; i++) {
+        fprintf(f, "#define %s %d\n", parametros[i].macro, *campo((Limiares*)l, parametros[i].deslocamento));
+    }
+    fprintf(f, "\n#endif // LIMIARES_H\n");
+    fclose(f);
+    return 0;
+}
+
+static int escrever_parametros(const char *caminho, const Limiares *l) {
+    FILE *f = fopen(caminho, "w");
+    if (f == NULL) {
+        printf("ERRO: Não foi possível criar '%s'\n", caminho);
+        return -1;
+    }
+    fprintf(f, "# Limiares para carregar_limiares(), gerados por ltpi2_tune\n");
+    for (int i = 0; i < NUM_PARAMETROS; i++) {
+        fprintf(f, "%s %d\n", parametros[i].nome, *campo((Limiares*)l, parametros[i].deslocamento));
+    }
+    fclose(f);
+    return 0;
+}
+
+// --- LINHA DE COMANDO ---
+
+static void uso(const char *programa) {
+    printf("Uso: %s [opções]\n", programa);
+    printf("  --saida ARQ        grava um limiares.h com os valores ajustados\n");
+    printf("  --parametros ARQ   grava um arquivo para carregar_limiares()\n");
+    printf("  --repeticoes N     pares de amostras por tamanho (padrão %d, máx. %d)\n", config.repeticoes, MAX_REPETICOES);
+    printf("  --amostra-ms X     duração mínima de cada amostra (padrão %.0f)\n", config.amostra_minima * 1000);
+    printf("  --filtro NOME      ajusta só os limiares cujo nome contém NOME (os demais\n");
+    printf("                     ficam com o valor atual)\n");
+}
+
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        const char *opcao = argv[i];
+        const char *valor = (i + 1 < argc) ? argv[i + 1] : NULL;
+        int ok = 1;
+        if (strcmp(opcao, "--ajuda") == 0 || strcmp(opcao, "-h") == 0) {
+            uso(argv[0]);
+            return 0;
+        } else if (valor == NULL) {
+            ok = 0;
+        } else if (strcmp(opcao, "--saida") == 0) {
+            config.saida = valor;
+        } else if (strcmp(opcao, "--parametros") == 0) {
+            config.parametros = valor;
+        } else if (strcmp(opcao, "--repeticoes") == 0) {
+            config.repeticoes = atoi(valor);
+            ok = (config.repeticoes >= 1 && config.repeticoes <= MAX_REPETICOES);
+        } else if (strcmp(opcao, "--amostra-ms") == 0) {
+            config.amostra_minima = atof(valor) / 1000;
+        } else if (strcmp(opcao, "--filtro") == 0) {
+            config.filtro = valor;
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            printf("ERRO: Opção inválida ou sem valor: %s\n", opcao);
+            uso(argv[0]);
+            return 2;
+        }
+        i++;
+    }
+
+    // Limiares a ajustar começam no "infinito"; os filtrados mantêm o valor atual
+    Limiares iniciais;
+    obter_limiares(&iniciais);
+    atuais = iniciais;
+    for (int i = 0; i < NUM_PARAMETROS; i++) {
+        const Parametro *p = &parametros[i];
+        if (config.filtro != NULL && strstr(p->nome, config.filtro) == NULL) continue;
+        if (p->deslocamento != CAMPO(conversao)) *campo(&atuais, p->deslocamento) = INFINITO;
+    }
+
+    double inicio = relogio();
+    for (int i = 0; i < NUM_PARAMETROS; i++) {
+        const Parametro *p = &parametros[i];
+        if (config.filtro != NULL && strstr(p->nome, config.filtro) == NULL) continue;
+
+        int minimo = p->minimo;
+        if (p->piso != SEM_PISO && *campo(&atuais, p->piso) > minimo) minimo = *campo(&atuais, p->piso);
+        if (minimo >= p->maximo) minimo = p->maximo - 1;
+
+        printf("%s (%d .. %d blocos):\n", p->nome, minimo, p->maximo);
+        int valor = ajustar(p, minimo, p->maximo);
+        *campo(&atuais, p->deslocamento) = valor;
+        definir_limiares(&atuais);
+        printf("  %s = %d (antes %d)\n", p->nome, valor, *campo(&iniciais, p->deslocamento));
+    }
+    printf("\nAjuste concluído em %.1f segundos.\n", relogio() - inicio);
+
+    if (config.saida != NULL) {
+        if (escrever_cabecalho(config.saida, &atuais) != 0) return 2;
+        printf("Limiares salvos em '%s'.\n", config.saida);
+    }
+    if (config.parametros != NULL) {
+        if (escrever_parametros(config.parametros, &atuais) != 0) return 2;
+        printf("Parâmetros salvos em '%s'.\n", config.parametros);
+    }
+    return 0;
+}
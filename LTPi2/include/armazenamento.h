@@ -0,0 +1,56 @@
+#ifndef ARMAZENAMENTO_H
+#define ARMAZENAMENTO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Armazenamento dos vetores de blocos: memória comum ou arquivos mapeados.
+//
+// Por padrão tudo vai para o heap. Com o modo em disco configurado, vetores
+// grandes (acima do limiar) ou que estourariam o orçamento de memória passam
+// a viver em arquivos temporários mapeados com mmap no diretório escolhido.
+// O kernel pagina esses arquivos sob demanda, de modo que o tamanho máximo
+// do cálculo passa a ser limitado pelo disco, e não pela RAM.
+//
+// Os arquivos são removidos do diretório logo após a criação; o espaço é
+// devolvido ao sistema quando o vetor é liberado (ou o processo termina).
+//
+// A ordem de acesso não muda: os núcleos leem os vetores mapeados como leriam
+// os da memória. O que varia é o conselho dado ao kernel — leitura adiante
+// com descarte cedo para os números, paginação comum para os rascunhos (ver
+// armazenamento.c). Não há NTT em blocos: uma transformada cujos buffers não
+// cabem na RAM pagina a cada passada de passo grande.
+
+// Vetores menores que isso nunca vão para o disco, mesmo sem orçamento livre
+#define DISCO_TAMANHO_MINIMO ((size_t)1 << 20)
+
+// Ativa o modo em disco. limiar_bytes: vetores a partir desse tamanho vão
+// para o disco (0 = sem limiar). orcamento_bytes: memória comum máxima para
+// vetores de blocos (0 = sem limite). Retorna 0, ou -1 se o diretório não
+// permite criar arquivos.
+int configurar_armazenamento_disco(const char *diretorio, size_t limiar_bytes, size_t orcamento_bytes);
+void desativar_armazenamento_disco(void);
+
+// Alocação de vetores de blocos; a versão zerada equivale a calloc.
+// Para os blocos de números, percorridos em ordem crescente.
+uint32_t* armazenamento_alocar(size_t quantidade);
+uint32_t* armazenamento_alocar_zerado(size_t quantidade);
+// Para rascunhos acessados fora de ordem (Karatsuba/Toom, NTT, divisão)
+uint32_t* armazenamento_alocar_rascunho(size_t quantidade);
+uint32_t* armazenamento_alocar_rascunho_zerado(size_t quantidade);
+// Cresce (ou encolhe) o vetor preservando o conteúdo, como realloc
+uint32_t* armazenamento_realocar(uint32_t *blocos, size_t nova_quantidade);
+void armazenamento_liberar(uint32_t *blocos);
+
+// Bytes atualmente em vetores na memória comum e em arquivos mapeados
+size_t armazenamento_bytes_memoria(void);
+size_t armazenamento_bytes_disco(void);
+
+// Maior valor dos contadores acima desde o último armazenamento_reiniciar_picos
+// (que os traz para o uso atual). Com realloc, o valor antigo e o novo não
+// são somados: o pico vê só o tamanho final de cada vetor.
+size_t armazenamento_pico_memoria(void);
+size_t armazenamento_pico_disco(void);
+void armazenamento_reiniciar_picos(void);
+
+#endif // ARMAZENAMENTO_H
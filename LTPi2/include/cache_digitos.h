@@ -0,0 +1,50 @@
+#ifndef CACHE_DIGITOS_H
+#define CACHE_DIGITOS_H
+
+#include <stddef.h>
+
+// Cache persistente dos dígitos decimais de Pi: um arquivo com "3.1415..."
+// em texto, precedido de um cabeçalho e seguido de um índice de somas de
+// verificação por bloco. Um pedido de n <= N casas é servido mapeando só os
+// blocos que cobrem as n casas e conferindo as somas deles; o arquivo é
+// sempre substituído por inteiro (temporário + fsync + rename), de modo que
+// leitores concorrentes, inclusive de outros processos, nunca o veem pela
+// metade.
+
+// Bytes de texto por soma de verificação do índice
+#define CACHE_BYTES_POR_BLOCO ((size_t)1 << 20)
+
+// Deslocamento do texto no arquivo (uma página: o texto mapeado fica alinhado)
+#define CACHE_DESLOCAMENTO_TEXTO 4096
+
+// Faixa "3." + 'digitos' casas mapeada do cache
+typedef struct {
+    const char *texto;       // Não termina em '\0'
+    size_t tamanho;          // digitos + 2
+    void *mapa;
+    size_t bytes_mapa;
+} VisaoDigitosPi;
+
+// Casas decimais guardadas no cache (0 se o arquivo não existe), ou -1 se
+// ele existe mas o cabeçalho é inválido
+long long cache_digitos_disponiveis(const char *caminho);
+
+// Mapeia as primeiras 'digitos' casas e confere as somas dos blocos que as
+// cobrem. Retorna 0, ou -1 se o cache não tem tantas casas ou está corrompido.
+int cache_digitos_mapear(const char *caminho, long long digitos, VisaoDigitosPi *visao);
+void cache_digitos_fechar(VisaoDigitosPi *visao);
+
+// Gravação de um cache novo: o texto "3.1415..." é escrito em sequência em
+// 'fd' (já posicionado no deslocamento do texto); concluir gera o índice e o
+// cabeçalho e troca o arquivo de 'caminho' pelo novo.
+typedef struct {
+    int fd;
+    char caminho[4096];
+    char temporario[4096 + 16];
+} GravacaoCacheDigitos;
+
+int cache_digitos_iniciar_gravacao(const char *caminho, GravacaoCacheDigitos *gravacao);
+int cache_digitos_concluir_gravacao(GravacaoCacheDigitos *gravacao, long long digitos);
+void cache_digitos_abandonar_gravacao(GravacaoCacheDigitos *gravacao);
+
+#endif // CACHE_DIGITOS_H
@@ -0,0 +1,42 @@
+#ifndef CLIENTE_DIGITOS_H
+#define CLIENTE_DIGITOS_H
+
+#include <stdint.h>
+
+// Cliente do servidor de faixas de dígitos (servidor_digitos.h): vários
+// processos consultam as casas decimais de Pi de um único arquivo mapeado
+// pelo servidor, através de um socket Unix, sem cada um manter sua cópia.
+//
+// Protocolo (inteiros little-endian), repetível na mesma conexão:
+//   pedido     inicio, fim (uint64): casas [inicio, fim), 0 = primeira
+//              depois do ponto (3.1415... -> "1415...")
+//   resposta   estado (uint32), reservado (uint32), quantidade (uint64),
+//              seguidos de 'quantidade' bytes ASCII
+// Pedidos podem ser enviados em sequência sem esperar as respostas, que
+// chegam na mesma ordem.
+
+#define DIGITOS_ESTADO_OK 0
+// fim passa das casas do arquivo, inicio > fim, ou a faixa tem mais de
+// DIGITOS_MAXIMO_POR_PEDIDO casas (pedidos maiores vão em partes)
+#define DIGITOS_ESTADO_FORA 1
+#define DIGITOS_MAXIMO_POR_PEDIDO ((uint64_t)1 << 32)
+
+#define DIGITOS_BYTES_PEDIDO 16
+#define DIGITOS_BYTES_RESPOSTA 16
+
+// Conecta ao socket do servidor. Retorna o descritor da conexão, ou -1.
+int conectar_servidor_digitos(const char *caminho_socket);
+
+// Copia as casas [inicio, fim) para 'destino' (fim - inicio bytes, sem
+// '\0'). Retorna 0, DIGITOS_ESTADO_FORA se a faixa não existe no arquivo
+// do servidor ou passa de DIGITOS_MAXIMO_POR_PEDIDO casas, ou -1 em erro de
+// conexão (a conexão deve ser fechada).
+int pedir_digitos(int conexao, uint64_t inicio, uint64_t fim, char *destino);
+
+// As casas [inicio, fim) escritas direto no descritor 'saida', em pedaços,
+// sem montar a faixa inteira na memória. Mesmos retornos de pedir_digitos.
+int pedir_digitos_fd(int conexao, uint64_t inicio, uint64_t fim, int saida);
+
+void desconectar_servidor_digitos(int conexao);
+
+#endif // CLIENTE_DIGITOS_H
@@ -0,0 +1,51 @@
+#ifndef FORMATO_ARQUIVOS_H
+#define FORMATO_ARQUIVOS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+// Peças comuns dos formatos em disco — checkpoints da série, cache de
+// dígitos (cache_digitos.h) e dígitos compactos (digitos_compactos.h):
+// inteiros little-endian, somas de Fletcher de 64 bits, E/S posicionada
+// completa e a troca de um arquivo pelo novo sem expor meio arquivo.
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define PALAVRA_LE(x) __builtin_bswap32(x)
+#define PALAVRA64_LE(x) __builtin_bswap64(x)
+#else
+#define PALAVRA_LE(x) (x)
+#define PALAVRA64_LE(x) (x)
+#endif
+
+// Soma de Fletcher de 64 bits: soma1 e soma2, cada uma em (lo, hi)
+#define SOMA_FLETCHER_PALAVRAS 4
+
+typedef struct {
+    uint64_t soma1;
+    uint64_t soma2;
+} SomaFletcher;
+
+// Acumula palavras na ordem da máquina (somas em fluxo, como nos checkpoints)
+void soma_fletcher_acumular(SomaFletcher *soma, const uint32_t *palavras, size_t n);
+// As quatro palavras da soma, na ordem da máquina
+void soma_fletcher_exportar(const SomaFletcher *soma, uint32_t saida[SOMA_FLETCHER_PALAVRAS]);
+
+// Soma de uma vez só: de palavras na ordem da máquina, de palavras como
+// estão no arquivo (little-endian) ou de bytes
+void soma_fletcher_palavras(const uint32_t *palavras, size_t n, uint32_t soma[SOMA_FLETCHER_PALAVRAS]);
+void soma_fletcher_palavras_le(const uint32_t *palavras, size_t n, uint32_t soma[SOMA_FLETCHER_PALAVRAS]);
+void soma_fletcher_bytes(const void *dados, size_t n, uint32_t soma[SOMA_FLETCHER_PALAVRAS]);
+
+// pread/pwrite até o fim do pedido (repetindo leituras e escritas parciais
+// e interrupções). Retornam 0, ou -1 em erro ou fim de arquivo.
+int arquivo_ler_tudo(int fd, void *destino, size_t tamanho, off_t posicao);
+int arquivo_escrever_tudo(int fd, const void *origem, size_t tamanho, off_t posicao);
+
+// Conclui um arquivo escrito em 'temporario' (aberto em fd): fsync, close,
+// rename para 'caminho' e fsync do diretório, para que o novo nome também
+// sobreviva a uma queda. fd é sempre fechado; em falha o temporário é
+// removido. Retorna 0 ou -1.
+int arquivo_publicar(int fd, const char *temporario, const char *caminho);
+
+#endif // FORMATO_ARQUIVOS_H
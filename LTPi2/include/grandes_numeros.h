@@ -3,9 +3,15 @@
 
 #include <stdint.h>
 
-// Definição da base para os cálculos (10^9 permite caber em uint32_t e facilita impressão)
-#define BASE_NUMERICA 1000000000
-#define DIGITOS_POR_BLOCO 9
+// Blocos binários: cada bloco guarda 32 bits (base 2^32), de modo que os carries
+// saem de graça do estouro de 64 bits. O decimal só é produzido na saída,
+// pela conversão de raiz dividir-para-conquistar (grande_numero_para_string).
+#define BITS_POR_BLOCO 32
+#define BASE_NUMERICA (1ULL << BITS_POR_BLOCO)
+
+// Tamanho dos pedaços decimais (10^9) usados nas conversões de/para string
+#define DIGITOS_POR_PEDACO_DECIMAL 9
+#define BASE_PEDACO_DECIMAL 1000000000
 
 // Estrutura para representar um número grande
 typedef struct {
@@ -19,17 +25,67 @@ typedef struct {
 GrandeNumero* criar_grande_numero(int capacidade_inicial);
 void liberar_grande_numero(GrandeNumero *numero);
 void copiar_grande_numero(GrandeNumero *destino, const GrandeNumero *origem);
+// Descarta o valor (passa a valer zero) e ajusta o buffer para exatamente
+// 'capacidade' blocos, para receber um resultado sem alocar um vetor novo
+void reaproveitar_grande_numero(GrandeNumero *numero, int capacidade);
 void definir_valor_inteiro(GrandeNumero *numero, int valor);
+void definir_valor_inteiro64(GrandeNumero *numero, int64_t valor);
 void definir_valor_string(GrandeNumero *numero, const char *valor_str);
 
 // Operações matemáticas básicas
 void somar_grandes_numeros(const GrandeNumero *a, const GrandeNumero *b, GrandeNumero *resultado);
 void subtrair_grandes_numeros(const GrandeNumero *a, const GrandeNumero *b, GrandeNumero *resultado);
 void multiplicar_grandes_numeros(const GrandeNumero *a, const GrandeNumero *b, GrandeNumero *resultado);
+// resultado = a²; multiplicar_grandes_numeros(x, x, r) também cai neste caminho
+void elevar_ao_quadrado(const GrandeNumero *a, GrandeNumero *resultado);
 void multiplicar_por_inteiro(const GrandeNumero *a, int b, GrandeNumero *resultado);
 void dividir_grande_numero(const GrandeNumero *dividendo, const GrandeNumero *divisor, GrandeNumero *quociente);
+void dividir_com_resto(const GrandeNumero *dividendo, const GrandeNumero *divisor, GrandeNumero *quociente, GrandeNumero *resto);
 void dividir_por_inteiro(const GrandeNumero *dividendo, int divisor, GrandeNumero *quociente);
+// Divisão exata (Hensel): só vale quando divisor divide dividendo; é mais
+// barata que dividir_grande_numero por dispensar estimativas e correções
+void dividir_exato(const GrandeNumero *dividendo, const GrandeNumero *divisor, GrandeNumero *quociente);
 void raiz_quadrada(const GrandeNumero *numero, GrandeNumero *resultado);
+void raiz_quadrada_resto(const GrandeNumero *numero, GrandeNumero *raiz, GrandeNumero *resto);
+void potencia_inteira(int base, int expoente, GrandeNumero *resultado);
+
+// resultado = a * 2^(32k); com k < 0 os |k| blocos inferiores são descartados
+void deslocar_blocos(const GrandeNumero *a, int k, GrandeNumero *resultado);
+
+// Conversão decimal (dividir-para-conquistar com potências 10^(9*2^i) em cache)
+// Retorna string alocada com malloc (o chamador libera com free)
+char* grande_numero_para_string(const GrandeNumero *numero);
+
+// Escreve o número em decimal direto no descritor fd, em blocos grandes e
+// sem montar a string completa na memória. digitos_inteiros > 0 insere o
+// ponto decimal após esse número de dígitos; max_digitos >= 0 trunca a saída
+// nesse total de dígitos (sem contar sinal e ponto).
+// Retorna a quantidade de dígitos escritos, ou -1 em caso de erro.
+long long escrever_grande_numero_fd(const GrandeNumero *numero, int fd, long long digitos_inteiros, long long max_digitos);
+
+// Limiares de troca de algoritmo, em blocos de 32 bits. Os valores iniciais
+// vêm de limiares.h (regravado por `make tune`); carregar_limiares lê um
+// arquivo de parâmetros com linhas "nome valor" (mesmos nomes dos campos).
+// Não devem ser trocados durante um cálculo em andamento.
+typedef struct {
+    int karatsuba;           // Menor operando a partir do qual Karatsuba substitui o tradicional
+    int toom3;               // ... Toom-3 substitui Karatsuba
+    int toom4;               // ... Toom-4 substitui Toom-3
+    int ntt;                 // ... a NTT substitui Toom-4
+    int quadrado_karatsuba;  // Os mesmos quatro limiares para quadrados
+    int quadrado_toom3;
+    int quadrado_toom4;
+    int quadrado_ntt;
+    int divisao_newton;      // Divisor e quociente a partir dos quais Newton substitui o Algoritmo D
+    int divisao_exata;       // Acima disto a divisão de Hensel usa o inverso por Newton
+    int conversao;           // Até isto a conversão decimal usa divisões sucessivas por 10^9
+} Limiares;
+
+void obter_limiares(Limiares *limiares);
+// Valores fora da faixa segura são ajustados (com AVISO)
+void definir_limiares(const Limiares *limiares);
+// Retorna 0, ou -1 se o arquivo não puder ser lido ou tiver linhas inválidas
+int carregar_limiares(const char *caminho);
 
 // Funções auxiliares e de exibição
 void imprimir_grande_numero(const GrandeNumero *numero);
@@ -0,0 +1,20 @@
+#ifndef LIMIARES_H
+#define LIMIARES_H
+
+// Limiares de troca de algoritmo, em blocos de 32 bits (ver Limiares em
+// grandes_numeros.h). `make tune` mede esta máquina e regrava este arquivo;
+// os valores abaixo foram escolhidos à mão e são o padrão do repositório.
+
+#define LIMIAR_KARATSUBA 32
+#define LIMIAR_TOOM3 192
+#define LIMIAR_TOOM4 768
+#define LIMIAR_NTT 24576
+#define LIMIAR_QUADRADO_KARATSUBA 48
+#define LIMIAR_QUADRADO_TOOM3 256
+#define LIMIAR_QUADRADO_TOOM4 1024
+#define LIMIAR_QUADRADO_NTT 32768
+#define LIMIAR_DIVISAO_NEWTON 2048
+#define LIMIAR_DIVISAO_EXATA 64
+#define LIMIAR_CONVERSAO 32
+
+#endif // LIMIARES_H
@@ -2,9 +2,118 @@
 #define LTPI2_H
 
 #include "grandes_numeros.h"
+#include "armazenamento.h"
+
+// Termos da série de Chudnovsky para 'digitos' casas (~14,18 dígitos por termo)
+#define PI_TERMOS_PARA_DIGITOS(digitos) ((digitos) / 14 + 1)
 
 // Calcula Pi com a precisão especificada (número de dígitos)
 // Retorna uma string com o valor de Pi
 char* calcular_pi(int digitos);
 
+// Calcula Pi e escreve "3.1415..." direto no descritor fd, em fluxo, sem
+// montar a string completa na memória. Retorna 0, ou -1 em erro de escrita.
+int calcular_pi_fd(int digitos, int fd);
+
+// Verificação independente: recalcula Pi com 'digitos' casas pela série 1/π
+// de Ramanujan (binary splitting próprio, mesmos núcleos de multiplicação e
+// divisão) e compara 'ultimos' — os últimos strlen(ultimos) dígitos do
+// resultado a conferir, por exemplo lidos do arquivo de calcular_pi_fd.
+// Retorna -1 se coincidem, a casa decimal (1 = primeira depois do ponto) do
+// primeiro dígito diferente, ou -2 em erro. Os tempos ficam em obter_tempos_pi.
+long long verificar_pi(int digitos, const char *ultimos);
+
+// Dígitos hexadecimais de Pi a partir de 'posicao' (0 = primeiro depois do
+// ponto: 3.243F6A88... -> "243F6A88"), sem calcular os anteriores: fórmula
+// de Bellard com exponenciação modular de 64 bits, tempo O(n log n) e
+// memória constante, dividida entre as threads de definir_numero_threads.
+// Cada avaliação rende 16 dígitos. Retorna string com 'quantidade' dígitos
+// (alocada com malloc), ou NULL se a posição passa de 2^58.
+char* calcular_pi_hex(long long posicao, int quantidade);
+
+// Tempos (segundos de relógio de parede) das fases do último cálculo de Pi
+typedef struct {
+    double serie;        // Binary splitting: P, Q e T
+    double fechamento;   // sqrt(10005), produto e divisão em ponto fixo
+    double conversao;    // Binário -> decimal (string ou escrita em fluxo)
+    double checkpoint;   // Gravação de checkpoints (já incluída em serie)
+    double cache;        // Leitura (ou índice e troca) do cache de dígitos
+    double total;        // Inclui a criação e o encerramento do pool de threads
+} TemposPi;
+
+void obter_tempos_pi(TemposPi *tempos);
+
+// Pico de memória (bytes em vetores de blocos, ver armazenamento.h) das fases
+// do último cálculo de Pi ou verificação. Não inclui pilhas, crivo e buffers
+// de E/S; arquivos mapeados são contados à parte.
+typedef struct {
+    size_t serie;
+    size_t fechamento;
+    size_t conversao;
+    size_t total;        // Maior dos três
+    size_t disco;        // Pico em arquivos mapeados, se o modo em disco estiver ativo
+} MemoriaPi;
+
+void obter_memoria_pi(MemoriaPi *memoria);
+
+// Modo paralelo: número de threads usadas por calcular_pi (1 = serial, padrão).
+// O resultado é idêntico bit a bit ao do modo serial.
+void definir_numero_threads(int num_threads);
+
+// Menor subárvore (em termos da série) publicada como tarefa no modo paralelo.
+// 0 = automático (~16 subárvores por thread)
+void definir_grao_paralelo(int termos);
+
+// Binary splitting com fatores: cada nó guarda a fatoração de P e Q (via
+// crivo) e o mdc(P_esq, Q_dir) é removido antes de cada merge, reduzindo os
+// operandos. Desligado por padrão; o resultado é o mesmo nos dois modos.
+void definir_modo_fatores(int ativo);
+
+// Checkpoint da série: subárvores concluídas do binary splitting são gravadas
+// em 'diretorio' (arquivos com soma de verificação, escritos em .tmp e
+// renomeados), limitando a parada a poucos por cento do tempo; a raiz é
+// sempre gravada. intervalo_segundos: espaço mínimo entre gravações (0 = só
+// o limite de custo). retomar = 1 reaproveita os arquivos já presentes, e o
+// próximo calcular_pi pula as subárvores salvas; retomar = 0 apaga os antigos.
+// Os arquivos são removidos quando o cálculo termina. Retorna o número de
+// subárvores disponíveis para retomada, ou -1 se o diretório não serve.
+int configurar_checkpoint(const char *diretorio, double intervalo_segundos, int retomar);
+void desativar_checkpoint(void);
+
+// Série em vários processos: os termos são divididos em 'fatias' nós da
+// árvore do binary splitting, cada um calculado por um processo
+// independente e gravado em 'diretorio' (compartilhado) no formato dos
+// checkpoints de subárvore — little-endian, com soma de verificação, o mesmo
+// em qualquer máquina. Com definir_modo_fatores, todos os processos devem
+// usar o mesmo modo.
+//
+// Termos [inicio, fim) da fatia 'indice' (0..fatias-1). Retorna 0, ou -1 se
+// a divisão não serve (fatias com menos de 256 termos).
+int faixa_fatia_pi(int digitos, int fatias, int indice, int *inicio, int *fim);
+
+// Calcula a fatia 'indice' e grava seu arquivo. Retorna 0, ou -1 em erro.
+// Os tempos ficam em obter_tempos_pi (serie, checkpoint = gravação, total).
+int calcular_fatia_pi(int digitos, int fatias, int indice, const char *diretorio);
+
+// Quantas fatias faltam (ou são de outro cálculo) em 'diretorio', avisando
+// cada uma; -1 se a divisão não serve
+int conferir_fatias_pi(int digitos, int fatias, const char *diretorio);
+
+// Combina as fatias — merges acima delas, fechamento e conversão — e
+// escreve "3.1415..." em fd, como calcular_pi_fd. O diretório é usado como
+// checkpoint retomado durante a combinação e os arquivos são removidos no
+// fim. Retorna 0, ou -1 se falta alguma fatia ou a escrita falhou.
+int combinar_fatias_pi(int digitos, int fatias, const char *diretorio, int fd);
+
+// Cache persistente de dígitos (cache_digitos.h): com ele configurado,
+// calcular_pi(n) e calcular_pi_fd(n) são servidos do arquivo quando ele já
+// tem N >= n casas, sem cálculo; com n > N, Pi é calculado com n casas e o
+// arquivo é trocado pelo novo, maior. Retorna as casas já disponíveis, ou -1
+// se o caminho não serve.
+int configurar_cache_digitos(const char *caminho);
+void desativar_cache_digitos(void);
+
+// Modo fora do núcleo: para guardar os números grandes em arquivos mapeados,
+// chame configurar_armazenamento_disco (armazenamento.h) antes de calcular_pi.
+
 #endif // LTPI2_H
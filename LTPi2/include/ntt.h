@@ -0,0 +1,26 @@
+#ifndef NTT_H
+#define NTT_H
+
+#include <stdint.h>
+
+// Maior comprimento de transformada suportado pelos três primos (2^25 pontos).
+// O produto completo (na + nb blocos) precisa caber nesse comprimento.
+#define NTT_TAMANHO_MAXIMO (1 << 25)
+
+// Maior operando menor (em blocos de 32 bits) para que os coeficientes da
+// convolução, até min(na, nb) * 2^64, caibam no produto dos três primos (~2^87)
+#define NTT_MENOR_OPERANDO_MAXIMO (1 << 22)
+
+// Multiplica dois vetores de blocos (base 2^32, ordem little-endian)
+// usando NTT com três primos e reconstrução por CRT (Garner).
+// 'resultado' deve ter espaço para na + nb blocos e não pode sobrepor a ou b.
+// Retorna 0 em caso de sucesso, -1 se o tamanho excede NTT_TAMANHO_MAXIMO
+// ou se faltou memória.
+// Quando a e b são o mesmo vetor (a == b, na == nb) o quadrado é detectado
+// e cada primo faz só uma transformada direta.
+int multiplicar_ntt_blocos(const uint32_t *a, int na, const uint32_t *b, int nb, uint32_t *resultado);
+
+// resultado[0..2na) = a^2; mesmas condições de multiplicar_ntt_blocos
+int elevar_ao_quadrado_ntt_blocos(const uint32_t *a, int na, uint32_t *resultado);
+
+#endif // NTT_H
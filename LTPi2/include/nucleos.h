@@ -0,0 +1,40 @@
+#ifndef NUCLEOS_H
+#define NUCLEOS_H
+
+#include <stdint.h>
+
+// Núcleos básicos da aritmética sobre vetores de blocos de 32 bits (ordem
+// little-endian), com versões escalar, AVX2, AVX-512 e AVX-512 IFMA. A melhor
+// versão suportada pela CPU (cpuid) é escolhida na carga do programa; todas
+// produzem resultados idênticos bit a bit.
+typedef struct {
+    const char *nome;
+
+    // r = a + b + carry (n blocos); retorna o carry final. r pode coincidir com a ou b.
+    uint32_t (*somar)(uint32_t *r, const uint32_t *a, const uint32_t *b, int n, uint32_t carry);
+
+    // r = a - b - emprestimo (n blocos); retorna o empréstimo final. Mesmas regras de somar.
+    uint32_t (*subtrair)(uint32_t *r, const uint32_t *a, const uint32_t *b, int n, uint32_t emprestimo);
+
+    // r = a * m (n blocos); retorna o bloco mais alto do produto. r pode coincidir com a.
+    uint32_t (*multiplicar_1)(uint32_t *r, const uint32_t *a, int n, uint32_t m);
+
+    // r[0..na+nb) = a * b, com na, nb >= 1; r não pode sobrepor a nem b
+    void (*multiplicar)(uint32_t *r, const uint32_t *a, int na, const uint32_t *b, int nb);
+
+    // r[0..2n) = a², com n >= 1; r não pode sobrepor a
+    void (*quadrado)(uint32_t *r, const uint32_t *a, int n);
+} NucleosBlocos;
+
+// Versão ativa (lida diretamente pelos laços quentes)
+extern const NucleosBlocos *nucleos_ativos;
+
+// Preenche 'lista' com as versões que esta CPU executa (a escalar é sempre
+// a primeira) e retorna quantas são
+int listar_nucleos(const NucleosBlocos **lista, int maximo);
+
+// Troca a versão ativa pelo nome ("escalar", "avx2", "avx512", "avx512ifma").
+// Retorna -1 se o nome não existe ou a CPU não suporta a versão.
+int definir_nucleos(const char *nome);
+
+#endif // NUCLEOS_H
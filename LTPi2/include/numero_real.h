@@ -0,0 +1,44 @@
+#ifndef NUMERO_REAL_H
+#define NUMERO_REAL_H
+
+#include "grandes_numeros.h"
+
+// Número real de precisão fixa sobre GrandeNumero:
+//   valor = mantissa * 2^(32 * expoente)
+//
+// O expoente conta blocos inteiros, de modo que multiplicar ou dividir por
+// potências de 2^32 é só somar ao expoente (O(1), sem mexer nos blocos).
+// Cada operação recebe a precisão de trabalho explícita, em blocos, e só
+// usa os blocos mais significativos dos operandos: o resultado é truncado
+// para essa precisão (erro relativo menor que 2^(-32 * (precisao - 1))).
+typedef struct {
+    GrandeNumero *mantissa;
+    long expoente;          // Em blocos de 32 bits
+} NumeroReal;
+
+// Blocos necessários para representar 'digitos' dígitos decimais
+int precisao_para_digitos(long digitos);
+
+NumeroReal* criar_numero_real(void);
+void liberar_numero_real(NumeroReal *numero);
+
+void real_de_inteiro(NumeroReal *numero, int valor);
+// Copia 'valor' mantendo só os 'precisao' blocos mais significativos
+void real_de_grande_numero(NumeroReal *numero, const GrandeNumero *valor, int precisao);
+
+// numero *= 2^(32k), em O(1)
+void real_deslocar_blocos(NumeroReal *numero, long k);
+// Descarta os blocos inferiores até restarem no máximo 'precisao' blocos
+void real_truncar(NumeroReal *numero, int precisao);
+
+// Operações truncadas: os operandos são lidos só até 'precisao' (+ guarda)
+// blocos e o resultado sai com no máximo 'precisao' blocos
+void real_multiplicar(const NumeroReal *a, const NumeroReal *b, NumeroReal *resultado, int precisao);
+void real_multiplicar_por_inteiro(const NumeroReal *a, int b, NumeroReal *resultado);
+void real_dividir(const NumeroReal *a, const NumeroReal *b, NumeroReal *resultado, int precisao);
+void real_raiz_quadrada(const NumeroReal *a, NumeroReal *resultado, int precisao);
+
+// Parte inteira (truncada em direção a zero)
+void real_parte_inteira(const NumeroReal *numero, GrandeNumero *resultado);
+
+#endif // NUMERO_REAL_H
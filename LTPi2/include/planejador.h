@@ -0,0 +1,68 @@
+#ifndef PLANEJADOR_H
+#define PLANEJADOR_H
+
+#include <stddef.h>
+
+// Planejamento de um cálculo de Pi antes de começar: tamanhos da árvore do
+// binary splitting, pico de memória de cada fase e tempo esperado, e uma
+// estratégia (threads, modo com fatores, memória ou disco) que cabe no
+// limite de memória dado. As estimativas vêm de fórmulas fechadas para os
+// tamanhos e de um modelo de custo M(n) medido na própria máquina.
+
+#define PLANO_NIVEIS_MAXIMOS 40
+
+typedef struct {
+    int nos;                 // Nós no nível (o nível 0 é a raiz)
+    int termos_por_no;
+    long long blocos_p;      // Blocos de 32 bits do maior nó do nível (o mais à direita)
+    long long blocos_q;
+    long long blocos_t;
+} NivelPlano;
+
+typedef struct {
+    int digitos;
+    size_t memoria_limite;   // 0 = sem limite
+
+    // Árvore e fechamento
+    int termos;
+    int niveis;
+    NivelPlano nivel[PLANO_NIVEIS_MAXIMOS];
+    int precisao;            // Blocos de trabalho do fechamento
+
+    // Pico de memória dos vetores de blocos, em bytes, por fase
+    size_t pico_arvore;
+    size_t pico_raiz;        // sqrt(10005) com a raiz da árvore ainda viva
+    size_t pico_divisao;     // Q·426880·sqrt / T
+    size_t pico_conversao;
+    size_t pico;
+
+    // Tempo esperado (segundos de parede), sem contar E/S de disco
+    double tempo_serie;
+    double tempo_fechamento;
+    double tempo_conversao;
+    double tempo_total;
+
+    // Estratégia escolhida
+    int threads;
+    int grao;                // Grão paralelo (termos por tarefa)
+    int modo_fatores;
+    int usar_disco;
+    size_t orcamento_memoria;   // Para configurar_armazenamento_disco quando usar_disco
+    int cabe;                   // 0 = nem a estratégia mais econômica cabe no limite (com disco:
+                                // o limite não cobre a folga fixa do processo e um orçamento mínimo)
+} PlanoPi;
+
+// Preenche 'plano' para calcular_pi(digitos). threads_maximas: 0 = número de
+// CPUs. diretorio_disco: onde vetores podem ir para arquivos mapeados quando
+// a memória não basta (NULL = nunca). Mede M(n) com multiplicações curtas e
+// uma execução pequena de calcular_pi (fração de segundo). Retorna 0, ou -1
+// com entrada inválida.
+int planejar_pi(int digitos, size_t memoria_limite, int threads_maximas, const char *diretorio_disco, PlanoPi *plano);
+
+void imprimir_plano_pi(const PlanoPi *plano);
+
+// Configura threads, grão, modo com fatores e armazenamento conforme o plano.
+// Retorna 0, ou -1 se o armazenamento em disco não pôde ser configurado.
+int aplicar_plano_pi(const PlanoPi *plano, const char *diretorio_disco);
+
+#endif // PLANEJADOR_H
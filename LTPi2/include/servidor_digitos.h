@@ -0,0 +1,21 @@
+#ifndef SERVIDOR_DIGITOS_H
+#define SERVIDOR_DIGITOS_H
+
+// Servidor local de faixas de dígitos de Pi (protocolo em cliente_digitos.h).
+//
+// O arquivo de dígitos é aberto uma vez; cada resposta vai do cache de
+// páginas para o socket por sendfile, sem passar pela memória do servidor,
+// e todos os consumidores dividem a mesma cópia das páginas. Um laço epoll
+// de uma thread atende milhares de conexões com pedidos encadeados.
+
+// Conexões simultâneas aceitas (as demais esperam na fila do listen)
+#define SERVIDOR_CONEXOES_MAXIMAS 16384
+
+// Serve 'arquivo' — um cache de dígitos (cache_digitos.h, conferido por
+// inteiro na abertura) ou um arquivo "3.1415..." de calcular_pi_fd — no
+// socket Unix 'caminho_socket' até receber SIGINT ou SIGTERM. O socket é
+// criado (um arquivo antigo no caminho é substituído) e removido no fim.
+// Retorna 0, ou -1 se o arquivo ou o socket não puderam ser abertos.
+int servir_digitos(const char *arquivo, const char *caminho_socket);
+
+#endif // SERVIDOR_DIGITOS_H
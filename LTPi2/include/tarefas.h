@@ -0,0 +1,37 @@
+#ifndef TAREFAS_H
+#define TAREFAS_H
+
+#include <stdatomic.h>
+
+// Pool de threads fork-join com roubo de trabalho (work stealing).
+//
+// Cada thread do pool tem sua própria fila dupla: a dona empilha e desempilha
+// tarefas pelo fundo (LIFO, boa localidade), enquanto threads ociosas roubam
+// pelo topo (as tarefas mais antigas, que tendem a ser as maiores).
+// A thread que chama iniciar_pool_tarefas participa como trabalhador 0.
+//
+// Quando o pool não está ativo, tarefa_criar executa a função imediatamente,
+// de modo que o mesmo código serve para os modos serial e paralelo.
+
+typedef void (*FuncaoTarefa)(void *argumento);
+
+typedef struct {
+    FuncaoTarefa funcao;
+    void *argumento;
+    atomic_int concluida;
+} Tarefa;
+
+// Inicia o pool com num_threads trabalhadores (incluindo a thread chamadora).
+// Retorna 0 em caso de sucesso; com num_threads <= 1 nada é criado.
+int iniciar_pool_tarefas(int num_threads);
+void finalizar_pool_tarefas(void);
+int pool_tarefas_ativo(void);
+int numero_threads_pool(void);
+
+// Publica uma tarefa que pode ser roubada por outra thread
+void tarefa_criar(Tarefa *tarefa, FuncaoTarefa funcao, void *argumento);
+
+// Espera a tarefa terminar, executando outras tarefas enquanto isso
+void tarefa_aguardar(Tarefa *tarefa);
+
+#endif // TAREFAS_H
@@ -0,0 +1,276 @@
+#define _GNU_SOURCE
+#include "armazenamento.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+// --- ARMAZENAMENTO EM MEMÓRIA OU EM DISCO ---
+/*
+ * Cada vetor de blocos é precedido por um cabeçalho que diz onde ele mora:
+ *
+ *   [ cabeçalho (64 bytes) | blocos ... ]
+ *                          ^ ponteiro devolvido ao chamador
+ *
+ * Para a memória comum o conjunto vem de malloc; para o disco, de um mmap
+ * compartilhado de um arquivo temporário já removido do diretório. O
+ * descritor fica aberto no cabeçalho para que o vetor possa crescer com
+ * ftruncate + mremap sem copiar o conteúdo.
+ *
+ * Cada vetor guarda também o conselho de acesso dado ao kernel:
+ *
+ *   - Números (ACESSO_SEQUENCIAL): somas, subtrações, deslocamentos, cópias,
+ *     a conversão para decimal e a gravação percorrem os blocos em ordem
+ *     crescente, e a multiplicação lê cada operando em pedaços contíguos.
+ *     MADV_SEQUENTIAL: o kernel lê adiante e descarta cedo as páginas já
+ *     percorridas, em vez de disputar a RAM.
+ *   - Rascunhos (ACESSO_ESPALHADO): o rascunho de Karatsuba/Toom é reusado
+ *     em cada nível da recursão, as borboletas da NTT andam em passos que
+ *     dobram a cada passada e o algoritmo D relê uma janela que desce pelo
+ *     dividendo. Com leitura adiante e descarte cedo, páginas que voltam a
+ *     ser usadas logo seriam jogadas fora; esses ficam com MADV_NORMAL.
+ *
+ * Nenhuma ordem de acesso própria para o disco é imposta aos núcleos.
+ */
+
+#define TAMANHO_CABECALHO 64
+
+#define ACESSO_SEQUENCIAL 0
+#define ACESSO_ESPALHADO 1
+
+typedef struct {
+    size_t bytes;            // Bytes úteis do vetor
+    size_t bytes_mapeados;   // Tamanho do mapeamento (0 = memória comum)
+    int descritor;           // Arquivo por trás do mapeamento, ou -1
+    int acesso;              // ACESSO_SEQUENCIAL ou ACESSO_ESPALHADO
+} CabecalhoBlocos;
+
+static struct {
+    int ativo;
+    char diretorio[4096];
+    size_t limiar;
+    size_t orcamento;
+} config_disco;
+
+static atomic_size_t bytes_memoria;
+static atomic_size_t bytes_disco;
+static atomic_size_t pico_memoria;
+static atomic_size_t pico_disco;
+
+// pico = max(pico, contador + bytes), depois de somar bytes ao contador
+static void somar_bytes(atomic_size_t *contador, atomic_size_t *pico, size_t bytes) {
+    size_t atual = atomic_fetch_add(contador, bytes) + bytes;
+    size_t maximo = atomic_load(pico);
+    while (atual > maximo && !atomic_compare_exchange_weak(pico, &maximo, atual)) {
+    }
+}
+
+static CabecalhoBlocos* cabecalho_de(uint32_t *blocos) {
+    return (CabecalhoBlocos*)((char*)blocos - TAMANHO_CABECALHO);
+}
+
+static uint32_t* blocos_de(CabecalhoBlocos *cabecalho) {
+    return (uint32_t*)((char*)cabecalho + TAMANHO_CABECALHO);
+}
+
+static size_t arredondar_pagina(size_t bytes) {
+    size_t pagina = (size_t)sysconf(_SC_PAGESIZE);
+    return (bytes + pagina - 1) / pagina * pagina;
+}
+
+// Decide se um vetor de 'bytes' deve ir para o disco, supondo que 'liberados'
+// bytes de memória comum serão devolvidos no mesmo passo (realocação)
+static int deve_ir_para_disco(size_t bytes, size_t liberados) {
+    if (!config_disco.ativo || bytes < DISCO_TAMANHO_MINIMO) return 0;
+    if (config_disco.limiar > 0 && bytes >= config_disco.limiar) return 1;
+    if (config_disco.orcamento > 0) {
+        size_t em_uso = atomic_load(&bytes_memoria);
+        em_uso = (em_uso > liberados) ? em_uso - liberados : 0;
+        if (em_uso + bytes > config_disco.orcamento) return 1;
+    }
+    return 0;
+}
+
+static void aconselhar_acesso(void *mapa, size_t tamanho, int acesso) {
+    madvise(mapa, tamanho, (acesso == ACESSO_SEQUENCIAL) ? MADV_SEQUENTIAL : MADV_NORMAL);
+}
+
+static CabecalhoBlocos* alocar_disco(size_t bytes, int acesso) {
+    char caminho[4096 + 32];
+    snprintf(caminho, sizeof(caminho), "%s/ltpi2-blocos-XXXXXX", config_disco.diretorio);
+
+    int fd = mkstemp(caminho);
+    if (fd < 0) return NULL;
+    unlink(caminho);
+
+    size_t tamanho = arredondar_pagina(TAMANHO_CABECALHO + bytes);
+    if (ftruncate(fd, (off_t)tamanho) != 0) {
+        close(fd);
+        return NULL;
+    }
+    void *mapa = mmap(NULL, tamanho, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapa == MAP_FAILED) {
+        close(fd);
+        return NULL;
+    }
+    aconselhar_acesso(mapa, tamanho, acesso);
+
+    CabecalhoBlocos *cabecalho = (CabecalhoBlocos*)mapa;
+    cabecalho->bytes = bytes;
+    cabecalho->bytes_mapeados = tamanho;
+    cabecalho->descritor = fd;
+    cabecalho->acesso = acesso;
+    somar_bytes(&bytes_disco, &pico_disco, tamanho);
+    return cabecalho;
+}
+
+static CabecalhoBlocos* alocar_memoria(size_t bytes, int zerar, int acesso) {
+    CabecalhoBlocos *cabecalho = zerar ? (CabecalhoBlocos*)calloc(1, TAMANHO_CABECALHO + bytes)
+                                       : (CabecalhoBlocos*)malloc(TAMANHO_CABECALHO + bytes);
+    if (cabecalho == NULL) return NULL;
+    cabecalho->bytes = bytes;
+    cabecalho->bytes_mapeados = 0;
+    cabecalho->descritor = -1;
+    cabecalho->acesso = acesso;
+    somar_bytes(&bytes_memoria, &pico_memoria, bytes);
+    return cabecalho;
+}
+
+static uint32_t* alocar(size_t quantidade, int zerar, int acesso) {
+    size_t bytes = quantidade * sizeof(uint32_t);
+    CabecalhoBlocos *cabecalho = NULL;
+
+    if (deve_ir_para_disco(bytes, 0)) {
+        // Arquivos novos já vêm zerados
+        cabecalho = alocar_disco(bytes, acesso);
+        if (cabecalho == NULL) {
+            printf("AVISO: Falha ao mapear %zu bytes em '%s'; usando memória\n", bytes, config_disco.diretorio);
+        }
+    }
+    if (cabecalho == NULL) cabecalho = alocar_memoria(bytes, zerar, acesso);
+    return (cabecalho != NULL) ? blocos_de(cabecalho) : NULL;
+}
+
+uint32_t* armazenamento_alocar(size_t quantidade) {
+    return alocar(quantidade, 0, ACESSO_SEQUENCIAL);
+}
+
+uint32_t* armazenamento_alocar_zerado(size_t quantidade) {
+    return alocar(quantidade, 1, ACESSO_SEQUENCIAL);
+}
+
+uint32_t* armazenamento_alocar_rascunho(size_t quantidade) {
+    return alocar(quantidade, 0, ACESSO_ESPALHADO);
+}
+
+uint32_t* armazenamento_alocar_rascunho_zerado(size_t quantidade) {
+    return alocar(quantidade, 1, ACESSO_ESPALHADO);
+}
+
+void armazenamento_liberar(uint32_t *blocos) {
+    if (blocos == NULL) return;
+    CabecalhoBlocos *cabecalho = cabecalho_de(blocos);
+
+    if (cabecalho->descritor >= 0) {
+        int fd = cabecalho->descritor;
+        size_t tamanho = cabecalho->bytes_mapeados;
+        munmap(cabecalho, tamanho);
+        close(fd);
+        atomic_fetch_sub(&bytes_disco, tamanho);
+    } else {
+        atomic_fetch_sub(&bytes_memoria, cabecalho->bytes);
+        free(cabecalho);
+    }
+}
+
+uint32_t* armazenamento_realocar(uint32_t *blocos, size_t nova_quantidade) {
+    if (blocos == NULL) return armazenamento_alocar(nova_quantidade);
+
+    CabecalhoBlocos *cabecalho = cabecalho_de(blocos);
+    size_t novos_bytes = nova_quantidade * sizeof(uint32_t);
+
+    if (cabecalho->descritor >= 0) {
+        // Em disco: crescer o arquivo e o mapeamento no lugar
+        size_t tamanho = arredondar_pagina(TAMANHO_CABECALHO + novos_bytes);
+        if (tamanho <= cabecalho->bytes_mapeados) {
+            cabecalho->bytes = novos_bytes;
+            return blocos;
+        }
+        size_t antigo = cabecalho->bytes_mapeados;
+        if (ftruncate(cabecalho->descritor, (off_t)tamanho) == 0) {
+            void *mapa = mremap(cabecalho, antigo, tamanho, MREMAP_MAYMOVE);
+            if (mapa != MAP_FAILED) {
+                cabecalho = (CabecalhoBlocos*)mapa;
+                aconselhar_acesso(mapa, tamanho, cabecalho->acesso);
+                cabecalho->bytes = novos_bytes;
+                cabecalho->bytes_mapeados = tamanho;
+                somar_bytes(&bytes_disco, &pico_disco, tamanho - antigo);
+                return blocos_de(cabecalho);
+            }
+        }
+        return NULL;
+    }
+
+    if (deve_ir_para_disco(novos_bytes, cabecalho->bytes)) {
+        // Passou do limiar ou do orçamento: migrar para um arquivo mapeado
+        CabecalhoBlocos *novo = alocar_disco(novos_bytes, cabecalho->acesso);
+        if (novo != NULL) {
+            size_t copiar = (cabecalho->bytes < novos_bytes) ? cabecalho->bytes : novos_bytes;
+            memcpy(blocos_de(novo), blocos, copiar);
+            armazenamento_liberar(blocos);
+            return blocos_de(novo);
+        }
+        printf("AVISO: Falha ao mapear %zu bytes em '%s'; usando memória\n", novos_bytes, config_disco.diretorio);
+    }
+
+    size_t antigo = cabecalho->bytes;
+    CabecalhoBlocos *novo = (CabecalhoBlocos*)realloc(cabecalho, TAMANHO_CABECALHO + novos_bytes);
+    if (novo == NULL) return NULL;
+    novo->bytes = novos_bytes;
+    if (novos_bytes >= antigo) {
+        somar_bytes(&bytes_memoria, &pico_memoria, novos_bytes - antigo);
+    } else {
+        atomic_fetch_sub(&bytes_memoria, antigo - novos_bytes);
+    }
+    return blocos_de(novo);
+}
+
+int configurar_armazenamento_disco(const char *diretorio, size_t limiar_bytes, size_t orcamento_bytes) {
+    if (diretorio == NULL || strlen(diretorio) >= sizeof(config_disco.diretorio)) return -1;
+    if (access(diretorio, W_OK | X_OK) != 0) {
+        printf("ERRO: Diretório '%s' não permite criar arquivos temporários\n", diretorio);
+        return -1;
+    }
+    strcpy(config_disco.diretorio, diretorio);
+    config_disco.limiar = limiar_bytes;
+    config_disco.orcamento = orcamento_bytes;
+    config_disco.ativo = (limiar_bytes > 0 || orcamento_bytes > 0);
+    return 0;
+}
+
+void desativar_armazenamento_disco(void) {
+    config_disco.ativo = 0;
+}
+
+size_t armazenamento_bytes_memoria(void) {
+    return atomic_load(&bytes_memoria);
+}
+
+size_t armazenamento_bytes_disco(void) {
+    return atomic_load(&bytes_disco);
+}
+
+size_t armazenamento_pico_memoria(void) {
+    return atomic_load(&pico_memoria);
+}
+
+size_t armazenamento_pico_disco(void) {
+    return atomic_load(&pico_disco);
+}
+
+void armazenamento_reiniciar_picos(void) {
+    atomic_store(&pico_memoria, atomic_load(&bytes_memoria));
+    atomic_store(&pico_disco, atomic_load(&bytes_disco));
+}
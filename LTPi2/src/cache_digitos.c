@@ -0,0 +1,216 @@
+#include "cache_digitos.h"
+#include "formato_arquivos.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// --- CACHE DE DÍGITOS EM DISCO ---
+/*
+ * Formato (palavras de 32 bits little-endian no cabeçalho e no índice):
+ *
+ *   [ cabeçalho | zeros até 4096 | "3.1415..." (N + 2 bytes) | índice ]
+ *
+ *   cabeçalho   "LTPI" "DIGC" versão bytes_por_bloco N(lo, hi) blocos
+ *               deslocamento_indice(lo, hi) 0, e a soma das 10 palavras
+ *   índice      por bloco de bytes_por_bloco bytes do texto (o último pode
+ *               ser menor): soma1, soma2 em (lo, hi)
+ *
+ * As somas são Fletcher de 64 bits (formato_arquivos.h), como nos checkpoints (sobre
+ * bytes no texto, sobre palavras no cabeçalho). O texto começa numa página
+ * para que o mapeamento o entregue alinhado, e vem antes do índice para que
+ * a gravação seja um fluxo sequencial, direto da conversão decimal.
+ *
+ * Um pedido de n casas só toca o cabeçalho, os ceil((n + 2) / bloco)
+ * primeiros blocos do texto e as entradas deles no índice: o custo é o de
+ * ler n bytes, qualquer que seja o tamanho do cache.
+ */
+
+#define CACHE_VERSAO 1
+#define CACHE_MAGICA 0x4950544Cu          // "LTPI"
+#define CACHE_MAGICA_DIGITOS 0x43474944u  // "DIGC"
+#define CACHE_PALAVRAS_CABECALHO 10
+#define CACHE_PALAVRAS_SOMA SOMA_FLETCHER_PALAVRAS
+
+typedef struct {
+    size_t bytes_por_bloco;
+    long long digitos;
+    long long blocos;
+    long long deslocamento_indice;
+} CabecalhoCache;
+
+static long long blocos_do_texto(long long bytes) {
+    return (bytes + (long long)CACHE_BYTES_POR_BLOCO - 1) / (long long)CACHE_BYTES_POR_BLOCO;
+}
+
+// Lê e confere o cabeçalho contra o tamanho do arquivo. Retorna 0 ou -1.
+static int ler_cabecalho(int fd, CabecalhoCache *cabecalho) {
+    uint32_t palavras[CACHE_PALAVRAS_CABECALHO + CACHE_PALAVRAS_SOMA], soma[CACHE_PALAVRAS_SOMA];
+    struct stat info;
+    if (fstat(fd, &info) != 0 || arquivo_ler_tudo(fd, palavras, sizeof(palavras), 0) != 0) return -1;
+    for (int i = 0; i < CACHE_PALAVRAS_CABECALHO + CACHE_PALAVRAS_SOMA; i++) palavras[i] = PALAVRA_LE(palavras[i]);
+    soma_fletcher_palavras(palavras, CACHE_PALAVRAS_CABECALHO, soma);
+    if (palavras[0] != CACHE_MAGICA || palavras[1] != CACHE_MAGICA_DIGITOS || palavras[2] != CACHE_VERSAO ||
+        memcmp(soma, palavras + CACHE_PALAVRAS_CABECALHO, sizeof(soma)) != 0) {
+        return -1;
+    }
+
+    cabecalho->bytes_por_bloco = palavras[3];
+    cabecalho->digitos = (long long)(((uint64_t)palavras[5] << 32) | palavras[4]);
+    cabecalho->blocos = palavras[6];
+    cabecalho->deslocamento_indice = (long long)(((uint64_t)palavras[8] << 32) | palavras[7]);
+    long long bytes_texto = cabecalho->digitos + 2;
+    int ok = cabecalho->bytes_por_bloco > 0 && cabecalho->digitos >= 0 &&
+             cabecalho->blocos == (bytes_texto + (long long)cabecalho->bytes_por_bloco - 1) / (long long)cabecalho->bytes_por_bloco &&
+             cabecalho->deslocamento_indice >= CACHE_DESLOCAMENTO_TEXTO + bytes_texto &&
+             (long long)info.st_size == cabecalho->deslocamento_indice + cabecalho->blocos * CACHE_PALAVRAS_SOMA * 4;
+    return ok ? 0 : -1;
+}
+
+long long cache_digitos_disponiveis(const char *caminho) {
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0) return (errno == ENOENT) ? 0 : -1;
+    CabecalhoCache cabecalho;
+    int ok = (ler_cabecalho(fd, &cabecalho) == 0);
+    close(fd);
+    return ok ? cabecalho.digitos : -1;
+}
+
+int cache_digitos_mapear(const char *caminho, long long digitos, VisaoDigitosPi *visao) {
+    memset(visao, 0, sizeof(*visao));
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0) return -1;
+    CabecalhoCache cabecalho;
+    if (digitos < 0 || ler_cabecalho(fd, &cabecalho) != 0 || cabecalho.digitos < digitos) {
+        close(fd);
+        return -1;
+    }
+
+    // Só os blocos que cobrem as casas pedidas
+    long long bytes_texto = cabecalho.digitos + 2;
+    long long necessarios = digitos + 2;
+    long long blocos = (necessarios + (long long)cabecalho.bytes_por_bloco - 1) / (long long)cabecalho.bytes_por_bloco;
+    long long fim = blocos * (long long)cabecalho.bytes_por_bloco;
+    if (fim > bytes_texto) fim = bytes_texto;
+
+    size_t bytes_indice = (size_t)blocos * CACHE_PALAVRAS_SOMA * sizeof(uint32_t);
+    uint32_t *indice = (uint32_t*)malloc(bytes_indice);
+    size_t bytes_mapa = (size_t)(CACHE_DESLOCAMENTO_TEXTO + fim);
+    void *mapa = MAP_FAILED;
+    if (indice != NULL && arquivo_ler_tudo(fd, indice, bytes_indice, (off_t)cabecalho.deslocamento_indice) == 0) {
+        mapa = mmap(NULL, bytes_mapa, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (mapa == MAP_FAILED) {
+        free(indice);
+        return -1;
+    }
+    madvise(mapa, bytes_mapa, MADV_SEQUENTIAL);
+
+    const char *texto = (const char*)mapa + CACHE_DESLOCAMENTO_TEXTO;
+    int ok = 1;
+    for (long long i = 0; i < blocos && ok; i++) {
+        long long inicio = i * (long long)cabecalho.bytes_por_bloco;
+        long long tamanho = (inicio + (long long)cabecalho.bytes_por_bloco < fim) ? (long long)cabecalho.bytes_por_bloco : fim - inicio;
+        uint32_t soma[CACHE_PALAVRAS_SOMA];
+        soma_fletcher_bytes(texto + inicio, (size_t)tamanho, soma);
+        for (int k = 0; k < CACHE_PALAVRAS_SOMA; k++) {
+            if (soma[k] != PALAVRA_LE(indice[i * CACHE_PALAVRAS_SOMA + k])) ok = 0;
+        }
+    }
+    free(indice);
+    if (!ok) {
+        munmap(mapa, bytes_mapa);
+        return -1;
+    }
+
+    visao->texto = texto;
+    visao->tamanho = (size_t)necessarios;
+    visao->mapa = mapa;
+    visao->bytes_mapa = bytes_mapa;
+    return 0;
+}
+
+void cache_digitos_fechar(VisaoDigitosPi *visao) {
+    if (visao->mapa != NULL) munmap(visao->mapa, visao->bytes_mapa);
+    memset(visao, 0, sizeof(*visao));
+}
+
+int cache_digitos_iniciar_gravacao(const char *caminho, GravacaoCacheDigitos *gravacao) {
+    if (strlen(caminho) >= sizeof(gravacao->caminho)) return -1;
+    strcpy(gravacao->caminho, caminho);
+    snprintf(gravacao->temporario, sizeof(gravacao->temporario), "%s.XXXXXX", caminho);
+    gravacao->fd = mkstemp(gravacao->temporario);
+    if (gravacao->fd < 0) return -1;
+    if (fchmod(gravacao->fd, 0644) != 0 || lseek(gravacao->fd, CACHE_DESLOCAMENTO_TEXTO, SEEK_SET) < 0) {
+        cache_digitos_abandonar_gravacao(gravacao);
+        return -1;
+    }
+    return 0;
+}
+
+void cache_digitos_abandonar_gravacao(GravacaoCacheDigitos *gravacao) {
+    if (gravacao->fd < 0) return;
+    close(gravacao->fd);
+    unlink(gravacao->temporario);
+    gravacao->fd = -1;
+}
+
+// Índice lido do texto já gravado (mapeado), em palavras little-endian
+static uint32_t* montar_indice(int fd, long long bytes_texto, long long blocos) {
+    uint32_t *indice = (uint32_t*)malloc((size_t)blocos * CACHE_PALAVRAS_SOMA * sizeof(uint32_t));
+    if (indice == NULL) return NULL;
+    size_t bytes_mapa = (size_t)(CACHE_DESLOCAMENTO_TEXTO + bytes_texto);
+    void *mapa = mmap(NULL, bytes_mapa, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapa == MAP_FAILED) {
+        free(indice);
+        return NULL;
+    }
+    madvise(mapa, bytes_mapa, MADV_SEQUENTIAL);
+    const char *texto = (const char*)mapa + CACHE_DESLOCAMENTO_TEXTO;
+    for (long long i = 0; i < blocos; i++) {
+        long long inicio = i * (long long)CACHE_BYTES_POR_BLOCO;
+        long long tamanho = (i + 1 < blocos) ? (long long)CACHE_BYTES_POR_BLOCO : bytes_texto - inicio;
+        uint32_t *soma = indice + i * CACHE_PALAVRAS_SOMA;
+        soma_fletcher_bytes(texto + inicio, (size_t)tamanho, soma);
+        for (int k = 0; k < CACHE_PALAVRAS_SOMA; k++) soma[k] = PALAVRA_LE(soma[k]);
+    }
+    munmap(mapa, bytes_mapa);
+    return indice;
+}
+
+int cache_digitos_concluir_gravacao(GravacaoCacheDigitos *gravacao, long long digitos) {
+    long long bytes_texto = digitos + 2;
+    long long blocos = blocos_do_texto(bytes_texto);
+    long long deslocamento_indice = (CACHE_DESLOCAMENTO_TEXTO + bytes_texto + 7) / 8 * 8;
+
+    // O texto tem de ter chegado inteiro
+    struct stat info;
+    int ok = (fstat(gravacao->fd, &info) == 0 && (long long)info.st_size == CACHE_DESLOCAMENTO_TEXTO + bytes_texto);
+    uint32_t *indice = ok ? montar_indice(gravacao->fd, bytes_texto, blocos) : NULL;
+    ok = (indice != NULL) &&
+         arquivo_escrever_tudo(gravacao->fd, indice, (size_t)blocos * CACHE_PALAVRAS_SOMA * sizeof(uint32_t), (off_t)deslocamento_indice) == 0;
+    free(indice);
+
+    uint32_t cabecalho[CACHE_PALAVRAS_CABECALHO + CACHE_PALAVRAS_SOMA] = {
+        CACHE_MAGICA, CACHE_MAGICA_DIGITOS, CACHE_VERSAO, (uint32_t)CACHE_BYTES_POR_BLOCO,
+        (uint32_t)digitos, (uint32_t)((uint64_t)digitos >> 32), (uint32_t)blocos,
+        (uint32_t)deslocamento_indice, (uint32_t)((uint64_t)deslocamento_indice >> 32), 0
+    };
+    soma_fletcher_palavras(cabecalho, CACHE_PALAVRAS_CABECALHO, cabecalho + CACHE_PALAVRAS_CABECALHO);
+    for (int i = 0; i < CACHE_PALAVRAS_CABECALHO + CACHE_PALAVRAS_SOMA; i++) cabecalho[i] = PALAVRA_LE(cabecalho[i]);
+    ok = ok && arquivo_escrever_tudo(gravacao->fd, cabecalho, sizeof(cabecalho), 0) == 0;
+    if (!ok) {
+        cache_digitos_abandonar_gravacao(gravacao);
+        return -1;
+    }
+
+    ok = (arquivo_publicar(gravacao->fd, gravacao->temporario, gravacao->caminho) == 0);
+    gravacao->fd = -1;
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,117 @@
+#define _GNU_SOURCE
+#include "cliente_digitos.h"
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+// --- CLIENTE DE FAIXAS DE DÍGITOS ---
+/*
+ * Conexão bloqueante: o pedido sai inteiro, o cabeçalho da resposta é lido
+ * e os dados vêm em seguida. pedir_digitos_fd repassa os dados em pedaços
+ * de CLIENTE_BYTES_POR_PEDACO, de modo que faixas de gigabytes não precisam
+ * caber na memória do cliente.
+ */
+
+#define CLIENTE_BYTES_POR_PEDACO ((size_t)1 << 16)
+
+static int enviar_tudo(int fd, const unsigned char *dados, size_t bytes) {
+    while (bytes > 0) {
+        ssize_t enviados = send(fd, dados, bytes, MSG_NOSIGNAL);
+        if (enviados < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        dados += enviados;
+        bytes -= (size_t)enviados;
+    }
+    return 0;
+}
+
+static int receber_tudo(int fd, void *destino, size_t bytes) {
+    unsigned char *p = (unsigned char*)destino;
+    while (bytes > 0) {
+        ssize_t lidos = recv(fd, p, bytes, 0);
+        if (lidos < 0 && errno == EINTR) continue;
+        if (lidos <= 0) return -1;
+        p += lidos;
+        bytes -= (size_t)lidos;
+    }
+    return 0;
+}
+
+static uint64_t ler_u64(const unsigned char *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+// Envia o pedido e lê o cabeçalho. Retorna o estado, ou -1.
+static int iniciar_pedido(int conexao, uint64_t inicio, uint64_t fim) {
+    unsigned char pedido[DIGITOS_BYTES_PEDIDO];
+    for (int i = 0; i < 8; i++) {
+        pedido[i] = (unsigned char)(inicio >> (8 * i));
+        pedido[8 + i] = (unsigned char)(fim >> (8 * i));
+    }
+    unsigned char resposta[DIGITOS_BYTES_RESPOSTA];
+    if (enviar_tudo(conexao, pedido, sizeof(pedido)) != 0 ||
+        receber_tudo(conexao, resposta, sizeof(resposta)) != 0) {
+        return -1;
+    }
+    uint32_t estado = (uint32_t)resposta[0] | ((uint32_t)resposta[1] << 8) |
+                      ((uint32_t)resposta[2] << 16) | ((uint32_t)resposta[3] << 24);
+    uint64_t quantidade = ler_u64(resposta + 8);
+    if (estado == DIGITOS_ESTADO_OK) return (quantidade == fim - inicio) ? 0 : -1;
+    if (estado == DIGITOS_ESTADO_FORA) return (quantidade == 0) ? DIGITOS_ESTADO_FORA : -1;
+    return -1;
+}
+
+int conectar_servidor_digitos(const char *caminho_socket) {
+    struct sockaddr_un endereco;
+    if (strlen(caminho_socket) >= sizeof(endereco.sun_path)) return -1;
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    strcpy(endereco.sun_path, caminho_socket);
+    if (connect(fd, (struct sockaddr*)&endereco, sizeof(endereco)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int pedir_digitos(int conexao, uint64_t inicio, uint64_t fim, char *destino) {
+    int estado = iniciar_pedido(conexao, inicio, fim);
+    if (estado != 0) return estado;
+    return receber_tudo(conexao, destino, (size_t)(fim - inicio));
+}
+
+int pedir_digitos_fd(int conexao, uint64_t inicio, uint64_t fim, int saida) {
+    int estado = iniciar_pedido(conexao, inicio, fim);
+    if (estado != 0) return estado;
+
+    char buffer[CLIENTE_BYTES_POR_PEDACO];
+    uint64_t restantes = fim - inicio;
+    while (restantes > 0) {
+        size_t pedaco = (restantes < sizeof(buffer)) ? (size_t)restantes : sizeof(buffer);
+        ssize_t lidos = recv(conexao, buffer, pedaco, 0);
+        if (lidos < 0 && errno == EINTR) continue;
+        if (lidos <= 0) return -1;
+        restantes -= (uint64_t)lidos;
+        // A resposta é consumida até o fim mesmo se 'saida' falhar, para a
+        // conexão continuar utilizável; a falha é informada no fim
+        for (ssize_t escritos = 0; escritos < lidos && estado == 0; ) {
+            ssize_t n = write(saida, buffer + escritos, (size_t)(lidos - escritos));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) estado = -1;
+            else escritos += n;
+        }
+    }
+    return estado;
+}
+
+void desconectar_servidor_digitos(int conexao) {
+    if (conexao >= 0) close(conexao);
+}
@@ -0,0 +1,441 @@
+#include "digitos_compactos.h"
+#include "formato_arquivos.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// --- DÍGITOS COMPACTOS EM DISCO ---
+/*
+ * Formato (inteiros little-endian):
+ *
+ *   [ cabeçalho | zeros até 4096 | palavras de 64 bits | índice ]
+ *
+ *   cabeçalho   "LTPI" "DIGP" versão parte_inteira digitos_por_palavra
+ *               palavras_por_bloco N(lo, hi) blocos deslocamento_indice(lo, hi)
+ *               0, e a soma das 12 palavras de 32 bits
+ *   palavras    ceil(N / 19): a palavra k guarda as casas [19k, 19k + 19)
+ *               como o inteiro d0 d1 ... d18 < 10^19 < 2^64 (a última é
+ *               completada com zeros à direita)
+ *   índice      por bloco de palavras_por_bloco palavras (o último pode ser
+ *               menor): soma1, soma2 em (lo, hi)
+ *
+ * As somas são Fletcher de 64 bits (formato_arquivos.h) sobre palavras de
+ * 32 bits, como no cache de dígitos e nos checkpoints. 19 casas em 8 bytes
+ * são 0,42 byte por casa: perto do limite de log2(10)/8 = 0,415, sem as divisões longas
+ * que blocos de 10^9 exigiriam para separar casas de palavras vizinhas —
+ * cada palavra se decodifica sozinha, então qualquer faixa começa em
+ * inicio / 19 sem ler nada antes.
+ *
+ * Decodificação: v = topo * 10^16 + alto * 10^8 + baixo, com topo < 1000.
+ * Com SSE2, cada metade de 8 casas vira 8 dígitos em faixas de 16 bits com
+ * multiplicações pelo inverso de 10^4, 10^3, 10^2 e 10 (sem divisões), e as
+ * duas metades são empacotadas em 16 bytes ASCII de uma vez.
+ */
+
+#define COMPACTO_VERSAO 1
+#define COMPACTO_MAGICA 0x4950544Cu          // "LTPI"
+#define COMPACTO_MAGICA_DIGITOS 0x50474944u  // "DIGP"
+#define COMPACTO_PALAVRAS_CABECALHO 12
+#define COMPACTO_PALAVRAS_SOMA SOMA_FLETCHER_PALAVRAS
+#define COMPACTO_BYTES_LEITURA ((size_t)1 << 20)
+#define COMPACTO_CASAS_POR_PEDACO (COMPACTO_DIGITOS_POR_PALAVRA * 8192)
+
+#define DEZ_A_8 100000000ull
+#define DEZ_A_16 10000000000000000ull
+
+static uint64_t palavras_para_casas(uint64_t casas) {
+    return (casas + COMPACTO_DIGITOS_POR_PALAVRA - 1) / COMPACTO_DIGITOS_POR_PALAVRA;
+}
+
+static uint64_t blocos_para_palavras(uint64_t palavras) {
+    return (palavras + COMPACTO_PALAVRAS_POR_BLOCO - 1) / COMPACTO_PALAVRAS_POR_BLOCO;
+}
+
+// --- Codificação ---
+
+// 19 caracteres -> palavra; 'invalido' acumula qualquer caractere fora de '0'..'9'
+static inline uint64_t empacotar_palavra(const char *digitos, unsigned *invalido) {
+    uint64_t v = 0;
+    for (int i = 0; i < COMPACTO_DIGITOS_POR_PALAVRA; i++) {
+        unsigned d = (unsigned)(unsigned char)digitos[i] - '0';
+        *invalido |= (d > 9);
+        v = v * 10 + d;
+    }
+    return v;
+}
+
+// Bloco cheio (ou o último): soma no índice e escrita na sequência do arquivo
+static int gravar_bloco(GravacaoCompacta *g) {
+    if (g->palavras_no_bloco == 0) return 0;
+    if (g->blocos == g->capacidade_indice) {
+        size_t capacidade = g->capacidade_indice ? 2 * g->capacidade_indice : 64;
+        uint32_t *indice = (uint32_t*)realloc(g->indice, capacidade * COMPACTO_PALAVRAS_SOMA * sizeof(uint32_t));
+        if (indice == NULL) return -1;
+        g->indice = indice;
+        g->capacidade_indice = capacidade;
+    }
+    uint32_t *soma = g->indice + g->blocos * COMPACTO_PALAVRAS_SOMA;
+    soma_fletcher_palavras_le((const uint32_t*)g->bloco, 2 * g->palavras_no_bloco, soma);
+    for (int k = 0; k < COMPACTO_PALAVRAS_SOMA; k++) soma[k] = PALAVRA_LE(soma[k]);
+
+    off_t posicao = COMPACTO_DESLOCAMENTO_DADOS + (off_t)(g->blocos * COMPACTO_PALAVRAS_POR_BLOCO) * 8;
+    if (arquivo_escrever_tudo(g->fd, g->bloco, g->palavras_no_bloco * 8, posicao) != 0) return -1;
+    g->blocos++;
+    g->palavras_no_bloco = 0;
+    return 0;
+}
+
+static int acrescentar_palavra(GravacaoCompacta *g, uint64_t v) {
+    g->bloco[g->palavras_no_bloco++] = PALAVRA64_LE(v);
+    return (g->palavras_no_bloco == COMPACTO_PALAVRAS_POR_BLOCO) ? gravar_bloco(g) : 0;
+}
+
+int digitos_compactos_iniciar_gravacao(const char *caminho, GravacaoCompacta *gravacao) {
+    memset(gravacao, 0, sizeof(*gravacao));
+    gravacao->fd = -1;
+    gravacao->parte_inteira = 3;
+    if (strlen(caminho) >= sizeof(gravacao->caminho)) return -1;
+    strcpy(gravacao->caminho, caminho);
+    gravacao->bloco = (uint64_t*)malloc(COMPACTO_PALAVRAS_POR_BLOCO * sizeof(uint64_t));
+    if (gravacao->bloco == NULL) return -1;
+    snprintf(gravacao->temporario, sizeof(gravacao->temporario), "%s.XXXXXX", caminho);
+    gravacao->fd = mkstemp(gravacao->temporario);
+    if (gravacao->fd < 0 || fchmod(gravacao->fd, 0644) != 0) {
+        digitos_compactos_abandonar_gravacao(gravacao);
+        return -1;
+    }
+    return 0;
+}
+
+void digitos_compactos_abandonar_gravacao(GravacaoCompacta *gravacao) {
+    if (gravacao->fd >= 0) {
+        close(gravacao->fd);
+        unlink(gravacao->temporario);
+    }
+    gravacao->fd = -1;
+    free(gravacao->bloco);
+    free(gravacao->indice);
+    gravacao->bloco = NULL;
+    gravacao->indice = NULL;
+}
+
+int digitos_compactos_acrescentar(GravacaoCompacta *gravacao, const char *digitos, size_t quantidade) {
+    GravacaoCompacta *g = gravacao;
+    unsigned invalido = 0;
+    g->casas += quantidade;
+
+    // Completa a palavra pendente da chamada anterior
+    if (g->num_pendentes > 0) {
+        size_t parte = (size_t)(COMPACTO_DIGITOS_POR_PALAVRA - g->num_pendentes);
+        if (parte > quantidade) parte = quantidade;
+        memcpy(g->pendentes + g->num_pendentes, digitos, parte);
+        for (size_t i = 0; i < parte; i++) invalido |= ((unsigned)(unsigned char)digitos[i] - '0' > 9);
+        g->num_pendentes += (int)parte;
+        digitos += parte;
+        quantidade -= parte;
+        if (g->num_pendentes < COMPACTO_DIGITOS_POR_PALAVRA) return invalido ? -1 : 0;
+        g->num_pendentes = 0;
+        if (acrescentar_palavra(g, empacotar_palavra(g->pendentes, &invalido)) != 0) return -1;
+    }
+
+    // Palavras inteiras direto do texto de entrada
+    while (quantidade >= COMPACTO_DIGITOS_POR_PALAVRA) {
+        if (acrescentar_palavra(g, empacotar_palavra(digitos, &invalido)) != 0) return -1;
+        digitos += COMPACTO_DIGITOS_POR_PALAVRA;
+        quantidade -= COMPACTO_DIGITOS_POR_PALAVRA;
+    }
+    memcpy(g->pendentes, digitos, quantidade);
+    g->num_pendentes = (int)quantidade;
+    for (size_t i = 0; i < quantidade; i++) invalido |= ((unsigned)(unsigned char)digitos[i] - '0' > 9);
+    return invalido ? -1 : 0;
+}
+
+int digitos_compactos_concluir_gravacao(GravacaoCompacta *gravacao) {
+    GravacaoCompacta *g = gravacao;
+    int ok = 1;
+    if (g->num_pendentes > 0) {
+        unsigned invalido = 0;
+        memset(g->pendentes + g->num_pendentes, '0', (size_t)(COMPACTO_DIGITOS_POR_PALAVRA - g->num_pendentes));
+        ok = (acrescentar_palavra(g, empacotar_palavra(g->pendentes, &invalido)) == 0);
+        g->num_pendentes = 0;
+    }
+    ok = ok && gravar_bloco(g) == 0;
+
+    uint64_t palavras = palavras_para_casas(g->casas);
+    uint64_t deslocamento_indice = COMPACTO_DESLOCAMENTO_DADOS + palavras * 8;
+    ok = ok && g->blocos == blocos_para_palavras(palavras) &&
+         (g->blocos == 0 || arquivo_escrever_tudo(g->fd, g->indice, g->blocos * COMPACTO_PALAVRAS_SOMA * sizeof(uint32_t),
+                                          (off_t)deslocamento_indice) == 0);
+
+    uint32_t cabecalho[COMPACTO_PALAVRAS_CABECALHO + COMPACTO_PALAVRAS_SOMA] = {
+        COMPACTO_MAGICA, COMPACTO_MAGICA_DIGITOS, COMPACTO_VERSAO, g->parte_inteira,
+        COMPACTO_DIGITOS_POR_PALAVRA, (uint32_t)COMPACTO_PALAVRAS_POR_BLOCO,
+        (uint32_t)g->casas, (uint32_t)(g->casas >> 32), (uint32_t)g->blocos,
+        (uint32_t)deslocamento_indice, (uint32_t)(deslocamento_indice >> 32), 0
+    };
+    for (int i = 0; i < COMPACTO_PALAVRAS_CABECALHO; i++) cabecalho[i] = PALAVRA_LE(cabecalho[i]);
+    soma_fletcher_palavras_le(cabecalho, COMPACTO_PALAVRAS_CABECALHO, cabecalho + COMPACTO_PALAVRAS_CABECALHO);
+    for (int i = COMPACTO_PALAVRAS_CABECALHO; i < COMPACTO_PALAVRAS_CABECALHO + COMPACTO_PALAVRAS_SOMA; i++) {
+        cabecalho[i] = PALAVRA_LE(cabecalho[i]);
+    }
+    // Arquivo vazio de casas: o cabeçalho ainda ocupa a página inteira
+    ok = ok && arquivo_escrever_tudo(g->fd, cabecalho, sizeof(cabecalho), 0) == 0 &&
+         ftruncate(g->fd, (off_t)(deslocamento_indice + g->blocos * COMPACTO_PALAVRAS_SOMA * sizeof(uint32_t))) == 0;
+    if (!ok) {
+        digitos_compactos_abandonar_gravacao(g);
+        return -1;
+    }
+
+    ok = (arquivo_publicar(g->fd, g->temporario, g->caminho) == 0);
+    g->fd = -1;
+    digitos_compactos_abandonar_gravacao(g);
+    return ok ? 0 : -1;
+}
+
+long long digitos_compactos_de_texto(int fd_texto, const char *caminho) {
+    GravacaoCompacta gravacao;
+    char *buffer = (char*)malloc(COMPACTO_BYTES_LEITURA);
+    if (buffer == NULL || digitos_compactos_iniciar_gravacao(caminho, &gravacao) != 0) {
+        free(buffer);
+        return -1;
+    }
+
+    // Estados: 0 = parte inteira, 1 = casas, 2 = espaços finais
+    int estado = 0, ok = 1, viu_inteira = 0;
+    uint64_t parte_inteira = 0;
+    for (;;) {
+        ssize_t lidos = read(fd_texto, buffer, COMPACTO_BYTES_LEITURA);
+        if (lidos < 0 && errno == EINTR) continue;
+        if (lidos < 0) ok = 0;
+        if (lidos <= 0) break;
+
+        const char *p = buffer, *fim = buffer + lidos;
+        while (p < fim && ok) {
+            if (estado == 1) {
+                const char *q = p;
+                while (q < fim && (unsigned)(unsigned char)*q - '0' <= 9) q++;
+                if (q > p && digitos_compactos_acrescentar(&gravacao, p, (size_t)(q - p)) != 0) ok = 0;
+                p = q;
+                if (p < fim) estado = 2;
+            } else if (estado == 0) {
+                if (*p == '.' && viu_inteira) {
+                    estado = 1;
+                } else if ((unsigned)(unsigned char)*p - '0' <= 9 && parte_inteira < 100000000) {
+                    parte_inteira = parte_inteira * 10 + (uint64_t)(*p - '0');
+                    viu_inteira = 1;
+                } else {
+                    ok = 0;
+                }
+                p++;
+            } else {
+                ok = (*p == '\n' || *p == '\r' || *p == ' ');
+                p++;
+            }
+        }
+    }
+    free(buffer);
+
+    long long casas = (long long)gravacao.casas;
+    gravacao.parte_inteira = (uint32_t)parte_inteira;
+    if (!ok || estado == 0) {
+        digitos_compactos_abandonar_gravacao(&gravacao);
+        return -1;
+    }
+    return (digitos_compactos_concluir_gravacao(&gravacao) == 0) ? casas : -1;
+}
+
+// --- Decodificação ---
+
+static const char pares_digitos[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static inline void escrever_topo(uint32_t topo, char *saida) {
+    saida[0] = (char)('0' + topo / 100);
+    memcpy(saida + 1, pares_digitos + 2 * (topo % 100), 2);
+}
+
+#if defined(__SSE2__)
+
+// v < 10^8 -> 8 dígitos (0..9) em faixas de 16 bits, o mais significativo primeiro
+static inline __m128i oito_digitos_sse2(uint32_t v) {
+    // abcd = v / 10^4 por multiplicação (2^45 / 10^4 arredondado para cima), efgh = resto
+    const __m128i abcdefgh = _mm_cvtsi32_si128((int)v);
+    const __m128i abcd = _mm_srli_epi64(_mm_mul_epu32(abcdefgh, _mm_set1_epi32((int)0xD1B71759)), 45);
+    const __m128i efgh = _mm_sub_epi32(abcdefgh, _mm_mul_epu32(abcd, _mm_set1_epi32(10000)));
+
+    // [abcd*4 x4, efgh*4 x4]: cada faixa dividida por 10^3, 10^2, 10, 1 dá
+    // [a, ab, abc, abcd, e, ef, efg, efgh] (inversos de 2^23, 2^19, 2^17, 2^15)
+    const __m128i v1 = _mm_slli_epi64(_mm_unpacklo_epi16(abcd, efgh), 2);
+    const __m128i v2 = _mm_unpacklo_epi32(_mm_unpacklo_epi16(v1, v1), _mm_unpacklo_epi16(v1, v1));
+    const __m128i divisores = _mm_setr_epi16(8389, 5243, 13108, (short)32768, 8389, 5243, 13108, (short)32768);
+    const __m128i deslocamentos = _mm_setr_epi16(1 << 7, 1 << 11, 1 << 13, (short)(1 << 15),
+                                                 1 << 7, 1 << 11, 1 << 13, (short)(1 << 15));
+    const __m128i prefixos = _mm_mulhi_epu16(_mm_mulhi_epu16(v2, divisores), deslocamentos);
+
+    // Cada dígito é o prefixo menos 10 vezes o prefixo anterior
+    const __m128i anteriores = _mm_slli_epi64(_mm_mullo_epi16(prefixos, _mm_set1_epi16(10)), 16);
+    return _mm_sub_epi16(prefixos, anteriores);
+}
+
+// n palavras -> 19 * n caracteres
+static void decodificar_palavras(const uint64_t *palavras, size_t n, char *saida) {
+    const __m128i zero_ascii = _mm_set1_epi8('0');
+    for (size_t i = 0; i < n; i++, saida += COMPACTO_DIGITOS_POR_PALAVRA) {
+        uint64_t v = PALAVRA64_LE(palavras[i]);
+        uint64_t resto = v % DEZ_A_16;
+        __m128i alto = oito_digitos_sse2((uint32_t)(resto / DEZ_A_8));
+        __m128i baixo = oito_digitos_sse2((uint32_t)(resto % DEZ_A_8));
+        escrever_topo((uint32_t)(v / DEZ_A_16), saida);
+        _mm_storeu_si128((__m128i*)(saida + 3), _mm_add_epi8(_mm_packus_epi16(alto, baixo), zero_ascii));
+    }
+}
+
+#else
+
+static inline void escrever_oito_digitos(uint32_t v, char *saida) {
+    for (int i = 6; i >= 0; i -= 2) {
+        memcpy(saida + i, pares_digitos + 2 * (v % 100), 2);
+        v /= 100;
+    }
+}
+
+static void decodificar_palavras(const uint64_t *palavras, size_t n, char *saida) {
+    for (size_t i = 0; i < n; i++, saida += COMPACTO_DIGITOS_POR_PALAVRA) {
+        uint64_t v = PALAVRA64_LE(palavras[i]);
+        uint64_t resto = v % DEZ_A_16;
+        escrever_topo((uint32_t)(v / DEZ_A_16), saida);
+        escrever_oito_digitos((uint32_t)(resto / DEZ_A_8), saida + 3);
+        escrever_oito_digitos((uint32_t)(resto % DEZ_A_8), saida + 11);
+    }
+}
+
+#endif
+
+// --- Leitura ---
+
+int digitos_compactos_abrir(const char *caminho, ArquivoCompacto *arquivo) {
+    memset(arquivo, 0, sizeof(*arquivo));
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0) return -1;
+
+    uint32_t palavras[COMPACTO_PALAVRAS_CABECALHO + COMPACTO_PALAVRAS_SOMA], soma[COMPACTO_PALAVRAS_SOMA];
+    struct stat info;
+    if (fstat(fd, &info) != 0 || arquivo_ler_tudo(fd, palavras, sizeof(palavras), 0) != 0) {
+        close(fd);
+        return -1;
+    }
+    soma_fletcher_palavras_le(palavras, COMPACTO_PALAVRAS_CABECALHO, soma);
+    for (int i = 0; i < COMPACTO_PALAVRAS_CABECALHO + COMPACTO_PALAVRAS_SOMA; i++) palavras[i] = PALAVRA_LE(palavras[i]);
+    uint64_t casas = ((uint64_t)palavras[7] << 32) | palavras[6];
+    uint64_t blocos = palavras[8];
+    uint64_t deslocamento_indice = ((uint64_t)palavras[10] << 32) | palavras[9];
+    uint64_t palavras_dados = palavras_para_casas(casas);
+    int ok = palavras[0] == COMPACTO_MAGICA && palavras[1] == COMPACTO_MAGICA_DIGITOS && palavras[2] == COMPACTO_VERSAO &&
+             memcmp(soma, palavras + COMPACTO_PALAVRAS_CABECALHO, sizeof(soma)) == 0 &&
+             palavras[4] == COMPACTO_DIGITOS_POR_PALAVRA && palavras[5] == COMPACTO_PALAVRAS_POR_BLOCO &&
+             blocos == blocos_para_palavras(palavras_dados) &&
+             deslocamento_indice == COMPACTO_DESLOCAMENTO_DADOS + palavras_dados * 8 &&
+             (uint64_t)info.st_size == deslocamento_indice + blocos * COMPACTO_PALAVRAS_SOMA * sizeof(uint32_t);
+    void *mapa = ok ? mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (mapa == MAP_FAILED) return -1;
+
+    arquivo->conferido = (unsigned char*)calloc((size_t)blocos + 1, 1);
+    if (arquivo->conferido == NULL) {
+        munmap(mapa, (size_t)info.st_size);
+        return -1;
+    }
+    arquivo->parte_inteira = palavras[3];
+    arquivo->casas = casas;
+    arquivo->palavras = (const uint64_t*)((const char*)mapa + COMPACTO_DESLOCAMENTO_DADOS);
+    arquivo->indice = (const uint32_t*)((const char*)mapa + deslocamento_indice);
+    arquivo->blocos = (size_t)blocos;
+    arquivo->mapa = mapa;
+    arquivo->bytes_mapa = (size_t)info.st_size;
+    return 0;
+}
+
+void digitos_compactos_fechar(ArquivoCompacto *arquivo) {
+    if (arquivo->mapa != NULL) munmap(arquivo->mapa, arquivo->bytes_mapa);
+    free(arquivo->conferido);
+    memset(arquivo, 0, sizeof(*arquivo));
+}
+
+// Confere (uma vez por abertura) as somas dos blocos das palavras [primeira, ultima]
+static int conferir_blocos(ArquivoCompacto *arquivo, uint64_t primeira, uint64_t ultima) {
+    uint64_t palavras = palavras_para_casas(arquivo->casas);
+    for (uint64_t b = primeira / COMPACTO_PALAVRAS_POR_BLOCO; b <= ultima / COMPACTO_PALAVRAS_POR_BLOCO; b++) {
+        if (arquivo->conferido[b]) continue;
+        uint64_t inicio = b * COMPACTO_PALAVRAS_POR_BLOCO;
+        uint64_t quantidade = (inicio + COMPACTO_PALAVRAS_POR_BLOCO < palavras) ? COMPACTO_PALAVRAS_POR_BLOCO : palavras - inicio;
+        uint32_t soma[COMPACTO_PALAVRAS_SOMA];
+        soma_fletcher_palavras_le((const uint32_t*)(arquivo->palavras + inicio), (size_t)(2 * quantidade), soma);
+        for (int k = 0; k < COMPACTO_PALAVRAS_SOMA; k++) {
+            if (soma[k] != PALAVRA_LE(arquivo->indice[b * COMPACTO_PALAVRAS_SOMA + k])) return -1;
+        }
+        arquivo->conferido[b] = 1;
+    }
+    return 0;
+}
+
+int digitos_compactos_ler(ArquivoCompacto *arquivo, uint64_t inicio, uint64_t fim, char *destino) {
+    if (inicio > fim || fim > arquivo->casas) return -1;
+    if (inicio == fim) return 0;
+    if (conferir_blocos(arquivo, inicio / COMPACTO_DIGITOS_POR_PALAVRA, (fim - 1) / COMPACTO_DIGITOS_POR_PALAVRA) != 0) {
+        return -1;
+    }
+
+    // Bordas parciais via rascunho; as palavras inteiras do meio vão direto ao destino
+    char rascunho[COMPACTO_DIGITOS_POR_PALAVRA];
+    uint64_t palavra = inicio / COMPACTO_DIGITOS_POR_PALAVRA;
+    unsigned deslocamento = (unsigned)(inicio % COMPACTO_DIGITOS_POR_PALAVRA);
+    if (deslocamento > 0) {
+        uint64_t parte = COMPACTO_DIGITOS_POR_PALAVRA - deslocamento;
+        if (parte > fim - inicio) parte = fim - inicio;
+        decodificar_palavras(arquivo->palavras + palavra, 1, rascunho);
+        memcpy(destino, rascunho + deslocamento, (size_t)parte);
+        destino += parte;
+        inicio += parte;
+        palavra++;
+    }
+    uint64_t inteiras = (fim - inicio) / COMPACTO_DIGITOS_POR_PALAVRA;
+    decodificar_palavras(arquivo->palavras + palavra, (size_t)inteiras, destino);
+    destino += inteiras * COMPACTO_DIGITOS_POR_PALAVRA;
+    inicio += inteiras * COMPACTO_DIGITOS_POR_PALAVRA;
+    if (inicio < fim) {
+        decodificar_palavras(arquivo->palavras + palavra + inteiras, 1, rascunho);
+        memcpy(destino, rascunho, (size_t)(fim - inicio));
+    }
+    return 0;
+}
+
+int digitos_compactos_escrever_fd(ArquivoCompacto *arquivo, uint64_t inicio, uint64_t fim, int fd) {
+    if (inicio > fim || fim > arquivo->casas) return -1;
+    char *buffer = (char*)malloc(COMPACTO_CASAS_POR_PEDACO);
+    if (buffer == NULL) return -1;
+    int ok = 1;
+    while (inicio < fim && ok) {
+        uint64_t parte = (fim - inicio < COMPACTO_CASAS_POR_PEDACO) ? fim - inicio : COMPACTO_CASAS_POR_PEDACO;
+        ok = digitos_compactos_ler(arquivo, inicio, inicio + parte, buffer) == 0;
+        for (uint64_t escritos = 0; ok && escritos < parte; ) {
+            ssize_t n = write(fd, buffer + escritos, (size_t)(parte - escritos));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) ok = 0;
+            else escritos += (uint64_t)n;
+        }
+        inicio += parte;
+    }
+    free(buffer);
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,117 @@
+#include "formato_arquivos.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// --- PEÇAS DOS FORMATOS EM DISCO ---
+/*
+ * Todos os formatos do LTPi2 guardam inteiros em little-endian e protegem
+ * cabeçalhos e dados com a soma de Fletcher de 64 bits:
+ *
+ *   soma1 += x;  soma2 += soma1;     (módulo 2^64, x = palavra ou byte)
+ *
+ * gravada como soma1 (lo, hi), soma2 (lo, hi). Ela pega trocas de ordem e
+ * blocos zerados, que uma soma simples deixaria passar, e custa duas adições
+ * por palavra.
+ *
+ * A gravação é sempre num temporário do mesmo diretório: fsync dos dados,
+ * rename sobre o nome final e fsync do diretório. Um leitor (ou a retomada
+ * depois de uma queda) vê o arquivo antigo ou o novo completo, nunca meio.
+ */
+
+void soma_fletcher_acumular(SomaFletcher *soma, const uint32_t *palavras, size_t n) {
+    uint64_t s1 = soma->soma1, s2 = soma->soma2;
+    for (size_t i = 0; i < n; i++) {
+        s1 += palavras[i];
+        s2 += s1;
+    }
+    soma->soma1 = s1;
+    soma->soma2 = s2;
+}
+
+void soma_fletcher_exportar(const SomaFletcher *soma, uint32_t saida[SOMA_FLETCHER_PALAVRAS]) {
+    saida[0] = (uint32_t)soma->soma1;
+    saida[1] = (uint32_t)(soma->soma1 >> 32);
+    saida[2] = (uint32_t)soma->soma2;
+    saida[3] = (uint32_t)(soma->soma2 >> 32);
+}
+
+void soma_fletcher_palavras(const uint32_t *palavras, size_t n, uint32_t soma[SOMA_FLETCHER_PALAVRAS]) {
+    SomaFletcher s = { 0, 0 };
+    soma_fletcher_acumular(&s, palavras, n);
+    soma_fletcher_exportar(&s, soma);
+}
+
+void soma_fletcher_palavras_le(const uint32_t *palavras, size_t n, uint32_t soma[SOMA_FLETCHER_PALAVRAS]) {
+    uint64_t s1 = 0, s2 = 0;
+    for (size_t i = 0; i < n; i++) {
+        s1 += PALAVRA_LE(palavras[i]);
+        s2 += s1;
+    }
+    SomaFletcher s = { s1, s2 };
+    soma_fletcher_exportar(&s, soma);
+}
+
+void soma_fletcher_bytes(const void *dados, size_t n, uint32_t soma[SOMA_FLETCHER_PALAVRAS]) {
+    const unsigned char *bytes = (const unsigned char*)dados;
+    uint64_t s1 = 0, s2 = 0;
+    for (size_t i = 0; i < n; i++) {
+        s1 += bytes[i];
+        s2 += s1;
+    }
+    SomaFletcher s = { s1, s2 };
+    soma_fletcher_exportar(&s, soma);
+}
+
+int arquivo_ler_tudo(int fd, void *destino, size_t tamanho, off_t posicao) {
+    char *p = (char*)destino;
+    while (tamanho > 0) {
+        ssize_t lidos = pread(fd, p, tamanho, posicao);
+        if (lidos < 0 && errno == EINTR) continue;
+        if (lidos <= 0) return -1;
+        p += lidos;
+        posicao += lidos;
+        tamanho -= (size_t)lidos;
+    }
+    return 0;
+}
+
+int arquivo_escrever_tudo(int fd, const void *origem, size_t tamanho, off_t posicao) {
+    const char *p = (const char*)origem;
+    while (tamanho > 0) {
+        ssize_t escritos = pwrite(fd, p, tamanho, posicao);
+        if (escritos < 0 && errno == EINTR) continue;
+        if (escritos <= 0) return -1;
+        p += escritos;
+        posicao += escritos;
+        tamanho -= (size_t)escritos;
+    }
+    return 0;
+}
+
+int arquivo_publicar(int fd, const char *temporario, const char *caminho) {
+    int ok = (fsync(fd) == 0);
+    ok = (close(fd) == 0) && ok;
+    ok = ok && rename(temporario, caminho) == 0;
+    if (!ok) {
+        unlink(temporario);
+        return -1;
+    }
+
+    // O novo nome também tem de sobreviver a uma queda
+    char *diretorio = strdup(caminho);
+    if (diretorio == NULL) return 0;
+    char *barra = strrchr(diretorio, '/');
+    if (barra == diretorio) barra[1] = '\0';
+    else if (barra != NULL) *barra = '\0';
+    int fd_diretorio = open(barra != NULL ? diretorio : ".", O_RDONLY | O_DIRECTORY);
+    free(diretorio);
+    if (fd_diretorio >= 0) {
+        fsync(fd_diretorio);
+        close(fd_diretorio);
+    }
+    return 0;
+}
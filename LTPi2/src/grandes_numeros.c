@@ -1,8 +1,117 @@
 #include "grandes_numeros.h"
+#include "ntt.h"
+#include "armazenamento.h"
+#include "limiares.h"
+#include "nucleos.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <stddef.h>
 #include <math.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+
+void remover_zeros_a_esquerda(GrandeNumero *numero);
+
+// --- LIMIARES DE TROCA DE ALGORITMO ---
+/*
+ * Os pontos em que cada algoritmo passa a superar o anterior dependem dos
+ * caches e da microarquitetura. Em vez de constantes fixas, os núcleos leem
+ * esta estrutura (os nomes XXX_LIMIAR de cada seção são apelidos para os
+ * campos), iniciada com os valores de limiares.h. `make tune` mede a máquina
+ * e regrava esse arquivo; carregar_limiares troca os valores sem recompilar.
+ *
+ * Faixas seguras: os Toom precisam de operandos com pelo menos alguns
+ * blocos por parte, e a conversão pequena escreve num rascunho de tamanho
+ * fixo (LARGURA_NUMERO_PEQUENO <= SAIDA_BLOCO_BYTES).
+ */
+
+#define LIMIAR_INFINITO (1 << 30)
+
+static Limiares limiares = {
+    LIMIAR_KARATSUBA, LIMIAR_TOOM3, LIMIAR_TOOM4, LIMIAR_NTT,
+    LIMIAR_QUADRADO_KARATSUBA, LIMIAR_QUADRADO_TOOM3, LIMIAR_QUADRADO_TOOM4, LIMIAR_QUADRADO_NTT,
+    LIMIAR_DIVISAO_NEWTON, LIMIAR_DIVISAO_EXATA, LIMIAR_CONVERSAO
+};
+
+typedef struct {
+    const char *nome;
+    size_t deslocamento;     // offsetof do campo em Limiares
+    int minimo, maximo;
+} DescricaoLimiar;
+
+static const DescricaoLimiar descricao_limiares[] = {
+    { "karatsuba",          offsetof(Limiares, karatsuba),          4,  LIMIAR_INFINITO },
+    { "toom3",              offsetof(Limiares, toom3),              24, LIMIAR_INFINITO },
+    { "toom4",              offsetof(Limiares, toom4),              32, LIMIAR_INFINITO },
+    { "ntt",                offsetof(Limiares, ntt),                16, LIMIAR_INFINITO },
+    { "quadrado_karatsuba", offsetof(Limiares, quadrado_karatsuba), 4,  LIMIAR_INFINITO },
+    { "quadrado_toom3",     offsetof(Limiares, quadrado_toom3),     24, LIMIAR_INFINITO },
+    { "quadrado_toom4",     offsetof(Limiares, quadrado_toom4),     32, LIMIAR_INFINITO },
+    { "quadrado_ntt",       offsetof(Limiares, quadrado_ntt),       16, LIMIAR_INFINITO },
+    { "divisao_newton",     offsetof(Limiares, divisao_newton),     16, LIMIAR_INFINITO },
+    { "divisao_exata",      offsetof(Limiares, divisao_exata),      4,  LIMIAR_INFINITO },
+    { "conversao",          offsetof(Limiares, conversao),          4,  4096 },
+};
+#define NUM_LIMIARES ((int)(sizeof(descricao_limiares) / sizeof(descricao_limiares[0])))
+
+static int* campo_limiar(Limiares *l, int i) {
+    return (int*)((char*)l + descricao_limiares[i].deslocamento);
+}
+
+void obter_limiares(Limiares *resultado) {
+    *resultado = limiares;
+}
+
+void definir_limiares(const Limiares *novos) {
+    Limiares ajustados = *novos;
+    for (int i = 0; i < NUM_LIMIARES; i++) {
+        const DescricaoLimiar *d = &descricao_limiares[i];
+        int *valor = campo_limiar(&ajustados, i);
+        if (*valor < d->minimo || *valor > d->maximo) {
+            int ajustado = (*valor < d->minimo) ? d->minimo : d->maximo;
+            printf("AVISO: Limiar %s = %d fora da faixa; usando %d\n", d->nome, *valor, ajustado);
+            *valor = ajustado;
+        }
+    }
+    limiares = ajustados;
+}
+
+int carregar_limiares(const char *caminho) {
+    FILE *arquivo = fopen(caminho, "r");
+    if (arquivo == NULL) {
+        printf("ERRO: Não foi possível abrir o arquivo de limiares '%s'\n", caminho);
+        return -1;
+    }
+
+    Limiares novos = limiares;
+    char linha[256];
+    int numero_linha = 0, erros = 0;
+    while (fgets(linha, sizeof(linha), arquivo) != NULL) {
+        numero_linha++;
+        char nome[64];
+        long valor;
+        char *inicio = linha + strspn(linha, " \t");
+        if (*inicio == '#' || *inicio == '\n' || *inicio == '\0') continue;
+
+        int i = NUM_LIMIARES;
+        if (sscanf(inicio, "%63s %ld", nome, &valor) == 2) {
+            for (i = 0; i < NUM_LIMIARES && strcmp(nome, descricao_limiares[i].nome) != 0; i++);
+        }
+        if (i == NUM_LIMIARES || valor < 0 || valor > LIMIAR_INFINITO) {
+            printf("ERRO: Linha %d inválida em '%s'\n", numero_linha, caminho);
+            erros++;
+            continue;
+        }
+        *campo_limiar(&novos, i) = (int)valor;
+    }
+    fclose(arquivo);
+
+    if (erros > 0) return -1;
+    definir_limiares(&novos);
+    return 0;
+}
 
 // --- Gerenciamento de Memória ---
 
@@ -12,7 +121,7 @@ GrandeNumero* criar_grande_numero(int capacidade_inicial) {
 
     if (capacidade_inicial < 1) capacidade_inicial = 1;
 
-    numero->blocos = (uint32_t*)calloc(capacidade_inicial, sizeof(uint32_t));
+    numero->blocos = armazenamento_alocar_zerado((size_t)capacidade_inicial);
     if (numero->blocos == NULL) {
         free(numero);
         return NULL;
@@ -27,9 +136,7 @@ GrandeNumero* criar_grande_numero(int capacidade_inicial) {
 
 void liberar_grande_numero(GrandeNumero *numero) {
     if (numero != NULL) {
-        if (numero->blocos != NULL) {
-            free(numero->blocos);
-        }
+        armazenamento_liberar(numero->blocos);
         free(numero);
     }
 }
@@ -39,7 +146,7 @@ void garantir_capacidade(GrandeNumero *numero, int capacidade_necessaria) {
         int nova_capacidade = numero->capacidade * 2;
         if (nova_capacidade < capacidade_necessaria) nova_capacidade = capacidade_necessaria;
 
-        uint32_t *novos_blocos = (uint32_t*)realloc(numero->blocos, nova_capacidade * sizeof(uint32_t));
+        uint32_t *novos_blocos = armazenamento_realocar(numero->blocos, (size_t)nova_capacidade);
         if (novos_blocos != NULL) {
             numero->blocos = novos_blocos;
             memset(numero->blocos + numero->capacidade, 0, (nova_capacidade - numero->capacidade) * sizeof(uint32_t));
@@ -48,6 +155,22 @@ void garantir_capacidade(GrandeNumero *numero, int capacidade_necessaria) {
     }
 }
 
+void reaproveitar_grande_numero(GrandeNumero *numero, int capacidade) {
+    if (capacidade < 1) capacidade = 1;
+    if (numero->capacidade != capacidade) {
+        // Vetores grandes (mmap do malloc ou arquivo mapeado) mudam de tamanho
+        // por mremap, no lugar; o conteúdo antigo não interessa
+        uint32_t *novos_blocos = armazenamento_realocar(numero->blocos, (size_t)capacidade);
+        if (novos_blocos != NULL) {
+            numero->blocos = novos_blocos;
+            numero->capacidade = capacidade;
+        }
+    }
+    memset(numero->blocos, 0, (size_t)numero->capacidade * sizeof(uint32_t));
+    numero->quantidade_blocos = 1;
+    numero->sinal = 1;
+}
+
 void copiar_grande_numero(GrandeNumero *destino, const GrandeNumero *origem) {
     garantir_capacidade(destino, origem->quantidade_blocos);
     memcpy(destino->blocos, origem->blocos, origem->quantidade_blocos * sizeof(uint32_t));
@@ -74,14 +197,21 @@ void definir_valor_inteiro(GrandeNumero *numero, int valor) {
         return;
     }
 
-    int i = 0;
-    while (valor > 0) {
-        garantir_capacidade(numero, i + 1);
-        numero->blocos[i] = valor % BASE_NUMERICA;
-        valor /= BASE_NUMERICA;
-        i++;
-    }
-    numero->quantidade_blocos = i;
+    // Um int positivo sempre cabe em um bloco de 32 bits
+    numero->blocos[0] = (uint32_t)valor;
+    numero->quantidade_blocos = 1;
+}
+
+void definir_valor_inteiro64(GrandeNumero *numero, int64_t valor) {
+    uint64_t magnitude = (valor < 0) ? 0 - (uint64_t)valor : (uint64_t)valor;
+    numero->sinal = (valor < 0) ? -1 : 1;
+
+    garantir_capacidade(numero, 2);
+    memset(numero->blocos, 0, numero->capacidade * sizeof(uint32_t));
+    numero->blocos[0] = (uint32_t)magnitude;
+    numero->blocos[1] = (uint32_t)(magnitude >> BITS_POR_BLOCO);
+    numero->quantidade_blocos = 2;
+    remover_zeros_a_esquerda(numero);
 }
 
 // --- Funções Auxiliares ---
@@ -116,59 +246,46 @@ void remover_zeros_a_esquerda(GrandeNumero *numero) {
 void imprimir_grande_numero(const GrandeNumero *numero) {
     if (numero->sinal == -1 && !eh_zero(numero)) printf("-");
     
-    if (numero->quantidade_blocos == 0) {
-        printf("0");
+    char *texto = grande_numero_para_string(numero);
+    if (texto == NULL) {
+        printf("0\n");
         return;
     }
-
-    printf("%u", numero->blocos[numero->quantidade_blocos - 1]);
-    for (int i = numero->quantidade_blocos - 2; i >= 0; i--) {
-        printf("%09u", numero->blocos[i]);
-    }
-    printf("\n");
+    // A string já inclui o sinal; pular o '-' para não imprimi-lo duas vezes
+    printf("%s\n", (texto[0] == '-') ? texto + 1 : texto);
+    free(texto);
 }
 
 // --- Operações de Adição e Subtração ---
 
-void somar_magnitudes(const GrandeNumero *a, const GrandeNumero *b, GrandeNumero *resultado) {
-    int max_blocos = (a->quantidade_blocos > b->quantidade_blocos) ? a->quantidade_blocos : b->quantidade_blocos;
-    garantir_capacidade(resultado, max_blocos + 1);
+// Núcleos sobre vetores de blocos (definidos com a multiplicação de Karatsuba)
+static uint32_t somar_blocos(uint32_t *r, const uint32_t *a, int na, const uint32_t *b, int nb);
+static uint32_t subtrair_blocos(uint32_t *r, const uint32_t *a, int na, const uint32_t *b, int nb);
 
-    uint64_t carry = 0;
-    for (int i = 0; i < max_blocos || carry; i++) {
-        uint64_t soma = carry;
-        if (i < a->quantidade_blocos) soma += a->blocos[i];
-        if (i < b->quantidade_blocos) soma += b->blocos[i];
-
-        resultado->blocos[i] = soma % BASE_NUMERICA;
-        carry = soma / BASE_NUMERICA;
-        if (i >= resultado->quantidade_blocos) resultado->quantidade_blocos = i + 1;
-    }
-    resultado->quantidade_blocos = (resultado->quantidade_blocos < max_blocos) ? max_blocos : resultado->quantidade_blocos;
-    if (carry) {
-        resultado->blocos[resultado->quantidade_blocos] = carry;
-        resultado->quantidade_blocos++;
+void somar_magnitudes(const GrandeNumero *a, const GrandeNumero *b, GrandeNumero *resultado) {
+    if (a->quantidade_blocos < b->quantidade_blocos) {
+        const GrandeNumero *t = a;
+        a = b;
+        b = t;
     }
+    int na = a->quantidade_blocos, nb = b->quantidade_blocos;
+    garantir_capacidade(resultado, na + 1);
+
+    // Os ponteiros só são lidos depois de garantir_capacidade (resultado pode ser a ou b)
+    uint32_t carry = somar_blocos(resultado->blocos, a->blocos, na, b->blocos, nb);
+    resultado->blocos[na] = carry;
+    resultado->quantidade_blocos = na + (carry ? 1 : 0);
     remover_zeros_a_esquerda(resultado);
 }
 
+// |a| >= |b|
 void subtrair_magnitudes(const GrandeNumero *a, const GrandeNumero *b, GrandeNumero *resultado) {
-    garantir_capacidade(resultado, a->quantidade_blocos);
-    
-    int64_t borrow = 0;
-    for (int i = 0; i < a->quantidade_blocos; i++) {
-        int64_t diff = a->blocos[i] - borrow;
-        if (i < b->quantidade_blocos) diff -= b->blocos[i];
-
-        if (diff < 0) {
-            diff += BASE_NUMERICA;
-            borrow = 1;
-        } else {
-            borrow = 0;
-        }
-        resultado->blocos[i] = diff;
-    }
-    resultado->quantidade_blocos = a->quantidade_blocos;
+    int na = a->quantidade_blocos;
+    int nb = (b->quantidade_blocos < na) ? b->quantidade_blocos : na;
+    garantir_capacidade(resultado, na);
+
+    subtrair_blocos(resultado->blocos, a->blocos, na, b->blocos, nb);
+    resultado->quantidade_blocos = na;
     remover_zeros_a_esquerda(resultado);
 }
 
@@ -206,17 +323,11 @@ void multiplicar_por_inteiro(const GrandeNumero *a, int b, GrandeNumero *resulta
     int b_abs = (b < 0) ? -b : b;
     garantir_capacidade(resultado, a->quantidade_blocos + 2);
 
-    uint64_t carry = 0;
-    for (int i = 0; i < a->quantidade_blocos; i++) {
-        uint64_t prod = (uint64_t)a->blocos[i] * b_abs + carry;
-        resultado->blocos[i] = prod % BASE_NUMERICA;
-        carry = prod / BASE_NUMERICA;
-    }
-    
+    uint32_t carry = nucleos_ativos->multiplicar_1(resultado->blocos, a->blocos, a->quantidade_blocos, (uint32_t)b_abs);
+
     resultado->quantidade_blocos = a->quantidade_blocos;
-    while (carry > 0) {
-        resultado->blocos[resultado->quantidade_blocos] = carry % BASE_NUMERICA;
-        carry /= BASE_NUMERICA;
+    if (carry > 0) {
+        resultado->blocos[resultado->quantidade_blocos] = (uint32_t)carry;
         resultado->quantidade_blocos++;
     }
     
@@ -231,7 +342,7 @@ void multiplicar_por_inteiro(const GrandeNumero *a, int b, GrandeNumero *resulta
  * Para multiplicar dois números X e Y de n dígitos, podemos dividir cada um ao meio:
  *   X = X1 * B^m + X0
  *   Y = Y1 * B^m + Y0
- * onde m = n/2 e B é a base (no nosso caso, BASE_NUMERICA).
+ * onde m = n/2 e B é a base (no nosso caso, 2^32).
  * 
  * A multiplicação tradicional requer 4 multiplicações:
  *   X * Y = X1*Y1 * B^(2m) + (X1*Y0 + X0*Y1) * B^m + X0*Y0
@@ -239,148 +350,543 @@ void multiplicar_por_inteiro(const GrandeNumero *a, int b, GrandeNumero *resulta
  * Karatsuba reduz para 3 multiplicações usando o truque:
  *   Z0 = X0 * Y0
  *   Z2 = X1 * Y1
- *   Z1 = (X0 + X1) * (Y0 + Y1) - Z0 - Z2
+ *   Z1 = Z0 + Z2 - (X0 - X1) * (Y0 - Y1)
  * 
  * Então: X * Y = Z2 * B^(2m) + Z1 * B^m + Z0
  * 
  * Complexidade: O(N^log2(3)) ≈ O(N^1.585) vs O(N^2) tradicional
  */
 
-// Limiar para usar multiplicação tradicional vs Karatsuba
-#define KARATSUBA_LIMIAR 32
+// Limiar (em blocos do menor operando) para usar multiplicação tradicional vs Karatsuba
+#define KARATSUBA_LIMIAR (limiares.karatsuba)
 
-// Multiplicação tradicional O(N^2) - usada para números pequenos
-static void multiplicar_tradicional(const GrandeNumero *a, const GrandeNumero *b, GrandeNumero *resultado) {
-    if (eh_zero(a) || eh_zero(b)) {
-        definir_valor_inteiro(resultado, 0);
+// Limiar (em blocos do menor operando) a partir do qual a NTT supera Toom-4
+#define NTT_LIMIAR (limiares.ntt)
+
+/*
+ * O núcleo da multiplicação trabalha sobre vetores de blocos (ponteiro +
+ * comprimento), sem criar GrandeNumero intermediários: as metades X0, X1,
+ * Y0, Y1 são apenas ponteiros para dentro dos operandos, Z0 e Z2 são
+ * escritos diretamente no buffer do resultado, e os únicos temporários
+ * (|X0 - X1|, |Y0 - Y1|, seu produto e a soma de Z1) vêm de um rascunho
+ * alocado uma única vez no topo da recursão.
+ *
+ * Usamos a variante subtrativa, Z1 = Z0 + Z2 - (X0 - X1)(Y0 - Y1), para que
+ * os fatores do produto do meio tenham m blocos (e não m + 1 como na soma).
+ */
+
+// Espaço de rascunho suficiente para multiplicar operandos de até n blocos.
+// Cada nível de Karatsuba usa 4m + 1 blocos (m = ⌈n/2⌉) e cada nível de Toom
+// no máximo 14m + 28 (m ≈ n/4); somando os níveis, o total fica abaixo de
+// 6n mais uma folga de 64 blocos por nível de recursão.
+#define RASCUNHO_MULTIPLICACAO(n) (6 * (size_t)(n) + 64 * 40)
+
+// r = a + b, com na >= nb; r pode coincidir com a ou b. Retorna o carry final.
+static uint32_t somar_blocos(uint32_t *r, const uint32_t *a, int na, const uint32_t *b, int nb) {
+    uint32_t carry = nucleos_ativos->somar(r, a, b, nb, 0);
+    int i = nb;
+    for (; carry && i < na; i++) {
+        r[i] = a[i] + 1;
+        carry = (r[i] == 0);
+    }
+    if (r != a && i < na) memcpy(r + i, a + i, (size_t)(na - i) * sizeof(uint32_t));
+    return carry;
+}
+
+// r = a - b, com na >= nb; r pode coincidir com a ou b. Retorna o empréstimo final.
+static uint32_t subtrair_blocos(uint32_t *r, const uint32_t *a, int na, const uint32_t *b, int nb) {
+    uint32_t emprestimo = nucleos_ativos->subtrair(r, a, b, nb, 0);
+    int i = nb;
+    for (; emprestimo && i < na; i++) {
+        emprestimo = (a[i] == 0);
+        r[i] = a[i] - 1;
+    }
+    if (r != a && i < na) memcpy(r + i, a + i, (size_t)(na - i) * sizeof(uint32_t));
+    return emprestimo;
+}
+
+// Comprimento sem os blocos nulos mais significativos (0 para o valor zero)
+static int comprimento_efetivo(const uint32_t *a, int n) {
+    while (n > 0 && a[n - 1] == 0) n--;
+    return n;
+}
+
+// Compara as magnitudes de dois vetores de blocos de comprimentos quaisquer
+static int comparar_blocos(const uint32_t *a, int na, const uint32_t *b, int nb) {
+    na = comprimento_efetivo(a, na);
+    nb = comprimento_efetivo(b, nb);
+    if (na != nb) return (na > nb) ? 1 : -1;
+    for (int i = na - 1; i >= 0; i--) {
+        if (a[i] != b[i]) return (a[i] > b[i]) ? 1 : -1;
+    }
+    return 0;
+}
+
+// r = |a - b|; r tem espaço para max(na, nb) blocos. Retorna o sinal de a - b.
+static int diferenca_absoluta_blocos(uint32_t *r, const uint32_t *a, int na, const uint32_t *b, int nb) {
+    int n = (na > nb) ? na : nb;
+    na = comprimento_efetivo(a, na);
+    nb = comprimento_efetivo(b, nb);
+    int sinal = (comparar_blocos(a, na, b, nb) >= 0) ? 1 : -1;
+    if (sinal > 0) {
+        subtrair_blocos(r, a, na, b, nb);
+    } else {
+        subtrair_blocos(r, b, nb, a, na);
+        na = nb;
+    }
+    for (int i = na; i < n; i++) r[i] = 0;
+    return sinal;
+}
+
+// r[0..nr) += a[0..na), propagando o carry até no máximo o fim de r
+static void acumular_blocos(uint32_t *r, int nr, const uint32_t *a, int na) {
+    uint32_t carry = somar_blocos(r, r, na, a, na);
+    for (int i = na; carry && i < nr; i++) {
+        r[i] += 1;
+        carry = (r[i] == 0);
+    }
+}
+
+// Inverso de d (ímpar) módulo 2^32: cada passo de Newton dobra os bits corretos
+static uint32_t inverso_bloco(uint32_t d) {
+    uint32_t x = d;   // d * d ≡ 1 (mod 8): 3 bits corretos
+    for (int i = 0; i < 4; i++) x *= 2 - d * x;
+    return x;
+}
+
+static void multiplicar_blocos(uint32_t *r, const uint32_t *a, int na, const uint32_t *b, int nb, uint32_t *rascunho);
+
+// --- MULTIPLICAÇÃO DE TOOM-COOK ---
+/*
+ * Generalização de Karatsuba: A é cortado em k1 partes e B em k2 partes de
+ * m blocos, vistos como polinômios em x = B^m:
+ *   A(x) = a_0 + a_1 x + ... + a_(k1-1) x^(k1-1)
+ * O produto C(x) = A(x)·B(x) tem grau d = k1 + k2 - 2, e fica determinado
+ * pelos seus valores em d + 1 pontos. Usamos 0, ∞ (o coeficiente líder) e
+ * os primeiros d - 1 pontos de { 1, -1, 2, -2, 3 }:
+ *   - Toom-3 (3x3, d = 4): 5 produtos de n/3 blocos, O(N^1.465)
+ *   - Toom-4 (4x4, d = 6): 7 produtos de n/4 blocos, O(N^1.404)
+ * e as variantes desbalanceadas 3x2, 4x2 (Toom-3) e 5x3, 6x2 (Toom-4), que
+ * mantêm as partes de A e B do mesmo tamanho quando na ≠ nb.
+ *
+ * Avaliação: Horner com multiplicações por inteiros pequenos; nos pontos
+ * negativos os valores intermediários trocam de sinal, então cada valor é
+ * um par (magnitude, sinal) somado com somar_blocos/diferenca_absoluta_blocos.
+ *
+ * Interpolação: tirando C(0) = c_0 e o líder c_d, sobra
+ *   D(x) = (C(x) - c_0 - c_d·x^d) / x = c_1 + c_2 x + ... + c_(d-1) x^(d-2)
+ * conhecido em d - 1 pontos. Diferenças divididas de Newton dão D na forma
+ * de Newton e a conversão para a base monomial dá c_1 .. c_(d-1). Todas as
+ * divisões são exatas por inteiros pequenos (feitas por inverso módulo 2^32).
+ */
+
+// Limiares (em blocos do menor operando) para Toom-3 e Toom-4
+#define TOOM3_LIMIAR (limiares.toom3)
+#define TOOM4_LIMIAR (limiares.toom4)
+
+#define TOOM_MAX_PONTOS 5
+static const int pontos_toom[TOOM_MAX_PONTOS] = { 1, -1, 2, -2, 3 };
+
+// Valor com sinal sobre um buffer de blocos (n = blocos efetivos)
+typedef struct {
+    uint32_t *blocos;
+    int n;
+    int sinal;
+} ValorToom;
+
+static ValorToom valor_toom(uint32_t *blocos, int n) {
+    ValorToom v = { blocos, comprimento_efetivo(blocos, n), 1 };
+    return v;
+}
+
+// r = a + sinal * b; r pode coincidir com a e comporta max(na, nb) + 1 blocos
+static void toom_somar(ValorToom *r, const ValorToom *a, const ValorToom *b, int sinal) {
+    int sinal_b = b->sinal * sinal;
+    if (b->n == 0) {
+        if (r != a) {
+            memcpy(r->blocos, a->blocos, (size_t)a->n * sizeof(uint32_t));
+            r->n = a->n;
+            r->sinal = a->sinal;
+        }
+        return;
+    }
+    if (a->n == 0) {
+        memcpy(r->blocos, b->blocos, (size_t)b->n * sizeof(uint32_t));
+        r->n = b->n;
+        r->sinal = sinal_b;
         return;
     }
 
-    GrandeNumero *temp = criar_grande_numero(a->quantidade_blocos + b->quantidade_blocos);
-    definir_valor_inteiro(temp, 0);
-    garantir_capacidade(temp, a->quantidade_blocos + b->quantidade_blocos);
+    if (a->sinal == sinal_b) {
+        const ValorToom *maior = (a->n >= b->n) ? a : b;
+        const ValorToom *menor = (a->n >= b->n) ? b : a;
+        uint32_t carry = somar_blocos(r->blocos, maior->blocos, maior->n, menor->blocos, menor->n);
+        r->n = maior->n;
+        if (carry) r->blocos[r->n++] = carry;
+        r->sinal = sinal_b;
+    } else {
+        int n = (a->n > b->n) ? a->n : b->n;
+        r->sinal = a->sinal * diferenca_absoluta_blocos(r->blocos, a->blocos, a->n, b->blocos, b->n);
+        r->n = comprimento_efetivo(r->blocos, n);
+        if (r->n == 0) r->sinal = 1;
+    }
+}
 
-    for (int i = 0; i < a->quantidade_blocos; i++) {
-        uint64_t carry = 0;
-        for (int j = 0; j < b->quantidade_blocos || carry; j++) {
-            uint64_t cur = temp->blocos[i + j] + 
-                           (uint64_t)a->blocos[i] * (j < b->quantidade_blocos ? b->blocos[j] : 0) + 
-                           carry;
-            temp->blocos[i + j] = cur % BASE_NUMERICA;
-            carry = cur / BASE_NUMERICA;
-            if (i + j >= temp->quantidade_blocos) temp->quantidade_blocos = i + j + 1;
+// r = a * k; r pode coincidir com a e comporta na + 1 blocos
+static void toom_multiplicar_pequeno(ValorToom *r, const ValorToom *a, uint32_t k) {
+    uint64_t carry = 0;
+    for (int i = 0; i < a->n; i++) {
+        uint64_t cur = (uint64_t)a->blocos[i] * k + carry;
+        r->blocos[i] = (uint32_t)cur;
+        carry = cur >> BITS_POR_BLOCO;
+    }
+    r->n = a->n;
+    if (carry) r->blocos[r->n++] = (uint32_t)carry;
+    r->sinal = a->sinal;
+}
+
+// v /= k, sabendo que a divisão é exata (k pode ser negativo)
+static void toom_dividir_exato(ValorToom *v, int k) {
+    if (k < 0) {
+        v->sinal = -v->sinal;
+        k = -k;
+    }
+    int zeros = __builtin_ctz((unsigned)k);
+    uint32_t impar = (uint32_t)k >> zeros;
+    if (v->n == 0) return;
+
+    // Fator 2^zeros: shift para a direita
+    if (zeros > 0) {
+        for (int i = 0; i < v->n - 1; i++) {
+            v->blocos[i] = (v->blocos[i] >> zeros) | (v->blocos[i + 1] << (BITS_POR_BLOCO - zeros));
         }
+        v->blocos[v->n - 1] >>= zeros;
     }
-    
-    temp->sinal = (a->sinal == b->sinal) ? 1 : -1;
-    remover_zeros_a_esquerda(temp);
-    copiar_grande_numero(resultado, temp);
-    liberar_grande_numero(temp);
+
+    // Parte ímpar: de baixo para cima, q_i = (v_i - emprestimo) · k^(-1) mod 2^32
+    if (impar > 1) {
+        uint32_t inverso = inverso_bloco(impar);
+        uint32_t emprestimo = 0;
+        for (int i = 0; i < v->n; i++) {
+            uint32_t s = v->blocos[i];
+            uint32_t x = s - emprestimo;
+            uint32_t q = x * inverso;
+            v->blocos[i] = q;
+            emprestimo = (x > s) + (uint32_t)(((uint64_t)q * impar) >> BITS_POR_BLOCO);
+        }
+    }
+    v->n = comprimento_efetivo(v->blocos, v->n);
+    if (v->n == 0) v->sinal = 1;
 }
 
-// Função auxiliar para criar um sub-número a partir de um range de blocos
-static GrandeNumero* criar_subnumero(const GrandeNumero *num, int inicio, int fim) {
-    int tamanho = fim - inicio;
-    if (tamanho <= 0) {
-        GrandeNumero *zero = criar_grande_numero(1);
-        definir_valor_inteiro(zero, 0);
-        return zero;
+// Parte i (de m blocos) de um operando com n blocos; vazia além do fim
+static ValorToom parte_toom(const uint32_t *a, int n, int m, int i) {
+    int inicio = i * m;
+    int len = (n - inicio < m) ? n - inicio : m;
+    if (len < 0) len = 0;
+    return valor_toom((uint32_t*)a + inicio, len);
+}
+
+// v = A(x) por Horner sobre as k partes de m blocos de a
+static void avaliar_toom(ValorToom *v, const uint32_t *a, int n, int m, int k, int x) {
+    ValorToom topo = parte_toom(a, n, m, k - 1);
+    memcpy(v->blocos, topo.blocos, (size_t)topo.n * sizeof(uint32_t));
+    v->n = topo.n;
+    v->sinal = 1;
+
+    uint32_t modulo = (uint32_t)((x < 0) ? -x : x);
+    for (int i = k - 2; i >= 0; i--) {
+        if (modulo != 1) toom_multiplicar_pequeno(v, v, modulo);
+        if (x < 0 && v->n > 0) v->sinal = -v->sinal;
+        ValorToom parte = parte_toom(a, n, m, i);
+        toom_somar(v, v, &parte, 1);
     }
-    
-    GrandeNumero *sub = criar_grande_numero(tamanho);
-    for (int i = 0; i < tamanho && (inicio + i) < num->quantidade_blocos; i++) {
-        sub->blocos[i] = num->blocos[inicio + i];
+}
+
+// r = x * y com sinal; r->blocos comporta x->n + y->n blocos
+static void produto_toom(ValorToom *r, const ValorToom *x, const ValorToom *y, uint32_t *rascunho) {
+    if (x->n == 0 || y->n == 0) {
+        r->n = 0;
+        r->sinal = 1;
+        return;
     }
-    sub->quantidade_blocos = tamanho;
-    sub->sinal = 1;
-    remover_zeros_a_esquerda(sub);
-    return sub;
+    if (x->n >= y->n) {
+        multiplicar_blocos(r->blocos, x->blocos, x->n, y->blocos, y->n, rascunho);
+    } else {
+        multiplicar_blocos(r->blocos, y->blocos, y->n, x->blocos, x->n, rascunho);
+    }
+    r->n = comprimento_efetivo(r->blocos, x->n + y->n);
+    r->sinal = x->sinal * y->sinal;
 }
 
-// Função auxiliar para somar com shift de blocos: resultado = a + (b << shift_blocos)
-static void somar_com_shift(GrandeNumero *resultado, const GrandeNumero *valor, int shift_blocos) {
-    garantir_capacidade(resultado, shift_blocos + valor->quantidade_blocos);
-    
-    uint64_t carry = 0;
-    for (int i = 0; i < valor->quantidade_blocos || carry; i++) {
-        uint64_t soma = carry;
-        if (shift_blocos + i < resultado->quantidade_blocos) {
-            soma += resultado->blocos[shift_blocos + i];
+// Toom-(k1, k2): r[0..na+nb) = a * b. Com a == b (e na == nb) os produtos
+// pontuais viram quadrados e B não é avaliado.
+static void multiplicar_toom_blocos(uint32_t *r, const uint32_t *a, int na, const uint32_t *b, int nb,
+                                    int k1, int k2, uint32_t *rascunho) {
+    int d = k1 + k2 - 2;
+    int pontos = d - 1;
+    int m = (na + k1 - 1) / k1;
+    if ((nb + k2 - 1) / k2 > m) m = (nb + k2 - 1) / k2;
+    int largura = 2 * m + 4;
+
+    // Layout do rascunho: [ valores (pontos × largura) | temp (largura) | A(x), B(x) (m + 2 cada) | recursão ]
+    ValorToom w[TOOM_MAX_PONTOS];
+    uint32_t *livre = rascunho;
+    for (int j = 0; j < pontos; j++) {
+        w[j].blocos = livre;
+        livre += largura;
+    }
+    ValorToom temp = { livre, 0, 1 };
+    ValorToom va = { livre + largura, 0, 1 };
+    ValorToom vb = { livre + largura + (m + 2), 0, 1 };
+    uint32_t *resto = livre + largura + 2 * (m + 2);
+
+    // c_0 = a_0·b_0 em r[0..2m) e c_d = a_(k1-1)·b_(k2-1) em r[d·m..na+nb)
+    memset(r, 0, (size_t)(na + nb) * sizeof(uint32_t));
+    ValorToom a0 = parte_toom(a, na, m, 0), b0 = parte_toom(b, nb, m, 0);
+    ValorToom c0 = { r, 0, 1 };
+    produto_toom(&c0, &a0, &b0, resto);
+    ValorToom a_topo = parte_toom(a, na, m, k1 - 1), b_topo = parte_toom(b, nb, m, k2 - 1);
+    ValorToom cd = { r + (size_t)d * m, 0, 1 };
+    produto_toom(&cd, &a_topo, &b_topo, resto);
+
+    // Produtos pontuais C(x_j) = A(x_j)·B(x_j)
+    int quadrado = (a == b && na == nb);
+    for (int j = 0; j < pontos; j++) {
+        avaliar_toom(&va, a, na, m, k1, pontos_toom[j]);
+        if (quadrado) {
+            produto_toom(&w[j], &va, &va, resto);
+        } else {
+            avaliar_toom(&vb, b, nb, m, k2, pontos_toom[j]);
+            produto_toom(&w[j], &va, &vb, resto);
         }
-        if (i < valor->quantidade_blocos) {
-            soma += valor->blocos[i];
+    }
+
+    // w_j = (C(x_j) - c_0 - c_d·x_j^d) / x_j = D(x_j)
+    for (int j = 0; j < pontos; j++) {
+        int x = pontos_toom[j];
+        toom_somar(&w[j], &w[j], &c0, -1);
+        if (cd.n > 0) {
+            uint32_t potencia = 1;
+            for (int i = 0; i < d; i++) potencia *= (uint32_t)((x < 0) ? -x : x);
+            toom_multiplicar_pequeno(&temp, &cd, potencia);
+            temp.sinal = (x < 0 && (d & 1)) ? -1 : 1;
+            toom_somar(&w[j], &w[j], &temp, -1);
         }
-        
-        if (shift_blocos + i >= resultado->capacidade) {
-            garantir_capacidade(resultado, shift_blocos + i + 1);
+        toom_dividir_exato(&w[j], x);
+    }
+
+    // Diferenças divididas: w_j ← (w_j - w_(j-1)) / (x_j - x_(j-l))
+    for (int l = 1; l < pontos; l++) {
+        for (int j = pontos - 1; j >= l; j--) {
+            toom_somar(&w[j], &w[j], &w[j - 1], -1);
+            toom_dividir_exato(&w[j], pontos_toom[j] - pontos_toom[j - l]);
         }
-        
-        resultado->blocos[shift_blocos + i] = soma % BASE_NUMERICA;
-        carry = soma / BASE_NUMERICA;
-        
-        if (shift_blocos + i >= resultado->quantidade_blocos) {
-            resultado->quantidade_blocos = shift_blocos + i + 1;
+    }
+
+    // Forma de Newton -> coeficientes: w_j ← w_j - x_i·w_(j+1)
+    for (int i = pontos - 2; i >= 0; i--) {
+        int x = pontos_toom[i];
+        for (int j = i; j <= pontos - 2; j++) {
+            if (x == 1 || x == -1) {
+                ValorToom termo = w[j + 1];
+                termo.sinal *= x;
+                toom_somar(&w[j], &w[j], &termo, -1);
+            } else {
+                toom_multiplicar_pequeno(&temp, &w[j + 1], (uint32_t)((x < 0) ? -x : x));
+                if (x < 0) temp.sinal = -temp.sinal;
+                toom_somar(&w[j], &w[j], &temp, -1);
+            }
         }
     }
-    remover_zeros_a_esquerda(resultado);
+
+    // Resultado += c_j·B^(j·m), com c_j = w_(j-1) >= 0
+    for (int j = 0; j < pontos; j++) {
+        int deslocamento = (j + 1) * m;
+        acumular_blocos(r + deslocamento, na + nb - deslocamento, w[j].blocos, w[j].n);
+    }
 }
 
-// Implementação recursiva de Karatsuba
-static void karatsuba_recursivo(const GrandeNumero *x, const GrandeNumero *y, GrandeNumero *resultado) {
-    // Caso base: números pequenos usam multiplicação tradicional
-    if (x->quantidade_blocos <= KARATSUBA_LIMIAR || y->quantidade_blocos <= KARATSUBA_LIMIAR) {
-        multiplicar_tradicional(x, y, resultado);
+// Escolhe o formato de Toom para na >= nb pela razão na/nb; retorna 0 se
+// nenhum formato serve (operandos muito desbalanceados ou pequenos demais)
+static int formato_toom(int na, int nb, int *k1, int *k2) {
+    long a = na, b = nb;
+    if (nb >= TOOM4_LIMIAR) {
+        if (4 * a < 5 * b)       { *k1 = 4; *k2 = 4; }
+        else if (20 * a < 37 * b) { *k1 = 5; *k2 = 3; }
+        else if (2 * a < 5 * b)   { *k1 = 4; *k2 = 2; }
+        else if (2 * a < 7 * b)   { *k1 = 6; *k2 = 2; }
+        else return 0;
+        return 1;
+    }
+    if (nb >= TOOM3_LIMIAR) {
+        if (4 * a < 5 * b)       { *k1 = 3; *k2 = 3; }
+        else if (4 * a < 7 * b)  { *k1 = 3; *k2 = 2; }
+        else if (2 * a < 5 * b)  { *k1 = 4; *k2 = 2; }
+        else return 0;
+        return 1;
+    }
+    return 0;
+}
+
+// --- QUADRADOS ---
+/*
+ * Quando os dois fatores são o mesmo número, cada nível tem seu atalho:
+ *   - tradicional: os produtos cruzados a_i·a_j (i < j) aparecem duas vezes,
+ *     então são calculados uma vez, dobrados por um shift e somados aos
+ *     quadrados da diagonal a_i²: ~n²/2 multiplicações em vez de n²;
+ *   - Karatsuba: X² = Z2·B^(2m) + (Z0 + Z2 - (X0 - X1)²)·B^m + Z0, com
+ *     Z0 = X0² e Z2 = X1²: três quadrados, e o termo do meio nunca é negativo;
+ *   - NTT: uma única transformada direta por primo (ver ntt.h).
+ *
+ * multiplicar_blocos desvia para cá quando a e b são o mesmo vetor, de modo
+ * que multiplicar_grandes_numeros(x, x, r) já usa esse caminho.
+ */
+
+// Limiares próprios: cada nível de quadrado custa menos que o produto
+// correspondente, então as trocas de algoritmo acontecem em outros tamanhos
+#define QUADRADO_KARATSUBA_LIMIAR (limiares.quadrado_karatsuba)
+#define QUADRADO_TOOM3_LIMIAR (limiares.quadrado_toom3)
+#define QUADRADO_TOOM4_LIMIAR (limiares.quadrado_toom4)
+#define QUADRADO_NTT_LIMIAR (limiares.quadrado_ntt)
+
+// r[0..2n) = a², com n >= 1; mesmas regras de r e rascunho que multiplicar_blocos
+static void quadrado_blocos(uint32_t *r, const uint32_t *a, int n, uint32_t *rascunho) {
+    if (n < QUADRADO_KARATSUBA_LIMIAR) {
+        nucleos_ativos->quadrado(r, a, n);
         return;
     }
-    
-    // Determinar o ponto de divisão (metade do maior número)
-    int m = (x->quantidade_blocos > y->quantidade_blocos ? x->quantidade_blocos : y->quantidade_blocos) / 2;
-    
-    // Dividir X = X1 * B^m + X0
-    GrandeNumero *x0 = criar_subnumero(x, 0, m);
-    GrandeNumero *x1 = criar_subnumero(x, m, x->quantidade_blocos);
-    
-    // Dividir Y = Y1 * B^m + Y0
-    GrandeNumero *y0 = criar_subnumero(y, 0, m);
-    GrandeNumero *y1 = criar_subnumero(y, m, y->quantidade_blocos);
-    
-    // Calcular as 3 multiplicações de Karatsuba
-    GrandeNumero *z0 = criar_grande_numero(x0->quantidade_blocos + y0->quantidade_blocos);
-    GrandeNumero *z2 = criar_grande_numero(x1->quantidade_blocos + y1->quantidade_blocos);
-    
-    karatsuba_recursivo(x0, y0, z0);  // Z0 = X0 * Y0
-    karatsuba_recursivo(x1, y1, z2);  // Z2 = X1 * Y1
-    
-    // Calcular (X0 + X1) e (Y0 + Y1)
-    GrandeNumero *x0_mais_x1 = criar_grande_numero(m + 2);
-    GrandeNumero *y0_mais_y1 = criar_grande_numero(m + 2);
-    somar_grandes_numeros(x0, x1, x0_mais_x1);
-    somar_grandes_numeros(y0, y1, y0_mais_y1);
-    
-    // Z1 = (X0 + X1) * (Y0 + Y1) - Z0 - Z2
-    GrandeNumero *z1 = criar_grande_numero(x0_mais_x1->quantidade_blocos + y0_mais_y1->quantidade_blocos);
-    karatsuba_recursivo(x0_mais_x1, y0_mais_y1, z1);
-    subtrair_grandes_numeros(z1, z0, z1);
-    subtrair_grandes_numeros(z1, z2, z1);
-    
-    // Montar resultado: Z2 * B^(2m) + Z1 * B^m + Z0
-    definir_valor_inteiro(resultado, 0);
-    garantir_capacidade(resultado, 2 * m + z2->quantidade_blocos);
-    
-    copiar_grande_numero(resultado, z0);           // resultado = Z0
-    somar_com_shift(resultado, z1, m);             // resultado += Z1 * B^m
-    somar_com_shift(resultado, z2, 2 * m);         // resultado += Z2 * B^(2m)
-    
-    // Limpar memória
-    liberar_grande_numero(x0);
-    liberar_grande_numero(x1);
-    liberar_grande_numero(y0);
-    liberar_grande_numero(y1);
-    liberar_grande_numero(z0);
-    liberar_grande_numero(z1);
-    liberar_grande_numero(z2);
-    liberar_grande_numero(x0_mais_x1);
-    liberar_grande_numero(y0_mais_y1);
+
+    if (n >= QUADRADO_NTT_LIMIAR && 2 * n <= NTT_TAMANHO_MAXIMO && n <= NTT_MENOR_OPERANDO_MAXIMO) {
+        if (elevar_ao_quadrado_ntt_blocos(a, n, r) == 0) return;
+    }
+
+    if (n >= QUADRADO_TOOM4_LIMIAR) {
+        multiplicar_toom_blocos(r, a, n, a, n, 4, 4, rascunho);
+        return;
+    }
+    if (n >= QUADRADO_TOOM3_LIMIAR) {
+        multiplicar_toom_blocos(r, a, n, a, n, 3, 3, rascunho);
+        return;
+    }
+
+    int m = (n + 1) / 2;
+    const uint32_t *x0 = a, *x1 = a + m;
+    int n_x1 = n - m;
+
+    // Z0 = X0² em r[0..2m) e Z2 = X1² em r[2m..2n)
+    quadrado_blocos(r, x0, m, rascunho);
+    quadrado_blocos(r + 2 * m, x1, n_x1, rascunho);
+
+    // Mesmo layout do rascunho da multiplicação: [ D (2m) | |X0-X1| -> T (2m+1) | recursão ]
+    uint32_t *d = rascunho;
+    uint32_t *t = rascunho + 2 * m;
+    uint32_t *dx = t;
+    uint32_t *resto = rascunho + 4 * m + 1;
+
+    diferenca_absoluta_blocos(dx, x0, m, x1, n_x1);
+    int n_dx = comprimento_efetivo(dx, m);
+    if (n_dx > 0) quadrado_blocos(d, dx, n_dx, resto);
+
+    // T = Z0 + Z2 - D = 2·X0·X1
+    t[2 * m] = somar_blocos(t, r, 2 * m, r + 2 * m, 2 * n_x1);
+    if (n_dx > 0) subtrair_blocos(t, t, 2 * m + 1, d, 2 * n_dx);
+
+    int n_t = comprimento_efetivo(t, 2 * m + 1);
+    acumular_blocos(r + m, 2 * n - m, t, n_t);
+}
+
+// Núcleo da multiplicação: r[0..na+nb) = a * b, com na >= nb >= 1.
+// r não pode sobrepor a nem b; rascunho tem RASCUNHO_MULTIPLICACAO(na) blocos.
+static void multiplicar_blocos(uint32_t *r, const uint32_t *a, int na, const uint32_t *b, int nb, uint32_t *rascunho) {
+    if (a == b && na == nb) {
+        quadrado_blocos(r, a, na, rascunho);
+        return;
+    }
+
+    // Caso base: números pequenos usam multiplicação tradicional (núcleo SIMD, ver nucleos.h)
+    if (nb < KARATSUBA_LIMIAR) {
+        nucleos_ativos->multiplicar(r, a, na, b, nb);
+        return;
+    }
+
+    // Números grandes usam a NTT (quando o produto cabe na transformada)
+    if (nb >= NTT_LIMIAR && na + nb <= NTT_TAMANHO_MAXIMO && nb <= NTT_MENOR_OPERANDO_MAXIMO) {
+        if (multiplicar_ntt_blocos(a, na, b, nb, r) == 0) return;
+    }
+
+    // Tamanhos médios usam Toom-3/Toom-4 (com formato conforme na/nb)
+    int k1, k2;
+    if (formato_toom(na, nb, &k1, &k2)) {
+        multiplicar_toom_blocos(r, a, na, b, nb, k1, k2, rascunho);
+        return;
+    }
+
+    int m = (na + 1) / 2;
+
+    // Operandos desbalanceados: fatiar a em pedaços de nb blocos e acumular
+    // cada produto parcial (nb x nb, balanceado) na posição correspondente.
+    if (nb <= m) {
+        uint32_t *parcial = rascunho;
+        uint32_t *resto = rascunho + 2 * nb;
+
+        multiplicar_blocos(r, a, nb, b, nb, resto);
+        memset(r + 2 * nb, 0, (size_t)(na - nb) * sizeof(uint32_t));
+        for (int i = nb; i < na; i += nb) {
+            int len = (na - i < nb) ? na - i : nb;
+            if (len >= nb) {
+                multiplicar_blocos(parcial, a + i, len, b, nb, resto);
+            } else {
+                multiplicar_blocos(parcial, b, nb, a + i, len, resto);
+            }
+            acumular_blocos(r + i, na + nb - i, parcial, len + nb);
+        }
+        return;
+    }
+
+    // Dividir X = X1 * B^m + X0 e Y = Y1 * B^m + Y0 (apenas ponteiros)
+    const uint32_t *x0 = a, *x1 = a + m;
+    const uint32_t *y0 = b, *y1 = b + m;
+    int n_x1 = na - m, n_y1 = nb - m;
+
+    // Z0 = X0 * Y0 em r[0..2m) e Z2 = X1 * Y1 em r[2m..na+nb)
+    multiplicar_blocos(r, x0, m, y0, m, rascunho);
+    multiplicar_blocos(r + 2 * m, x1, n_x1, y1, n_y1, rascunho);
+
+    // Layout do rascunho: [ D (2m) | |X0-X1|, |Y0-Y1| -> depois T (2m+1) | recursão ]
+    uint32_t *d = rascunho;
+    uint32_t *t = rascunho + 2 * m;
+    uint32_t *dx = t, *dy = t + m;
+    uint32_t *resto = rascunho + 4 * m + 1;
+
+    int sinal = diferenca_absoluta_blocos(dx, x0, m, x1, n_x1);
+    sinal *= diferenca_absoluta_blocos(dy, y0, m, y1, n_y1);
+    int n_dx = comprimento_efetivo(dx, m);
+    int n_dy = comprimento_efetivo(dy, m);
+    int n_d = 0;
+    if (n_dx > 0 && n_dy > 0) {
+        if (n_dx >= n_dy) {
+            multiplicar_blocos(d, dx, n_dx, dy, n_dy, resto);
+        } else {
+            multiplicar_blocos(d, dy, n_dy, dx, n_dx, resto);
+        }
+        n_d = n_dx + n_dy;
+    }
+
+    // T = Z0 + Z2 - sinal * D = X0*Y1 + X1*Y0 (sempre não negativo)
+    int n_z2 = na + nb - 2 * m;
+    t[2 * m] = somar_blocos(t, r, 2 * m, r + 2 * m, n_z2);
+    if (n_d > 0) {
+        if (sinal > 0) {
+            subtrair_blocos(t, t, 2 * m + 1, d, n_d);
+        } else {
+            somar_blocos(t, t, 2 * m + 1, d, n_d);
+        }
+    }
+
+    // Resultado += T * B^m (o bloco mais alto de T é nulo quando não cabe)
+    int n_t = comprimento_efetivo(t, 2 * m + 1);
+    acumular_blocos(r + m, na + nb - m, t, n_t);
 }
 
 void multiplicar_grandes_numeros(const GrandeNumero *a, const GrandeNumero *b, GrandeNumero *resultado) {
@@ -388,13 +894,54 @@ void multiplicar_grandes_numeros(const GrandeNumero *a, const GrandeNumero *b, G
         definir_valor_inteiro(resultado, 0);
         return;
     }
-    
-    // Usar Karatsuba
-    karatsuba_recursivo(a, b, resultado);
-    resultado->sinal = (a->sinal == b->sinal) ? 1 : -1;
+
+    // O núcleo espera o operando mais longo primeiro
+    if (a->quantidade_blocos < b->quantidade_blocos) {
+        const GrandeNumero *troca = a;
+        a = b;
+        b = troca;
+    }
+    int na = a->quantidade_blocos;
+    int nb = b->quantidade_blocos;
+    int tamanho = na + nb;
+    int sinal = (a->sinal == b->sinal) ? 1 : -1;
+
+    // Escrever direto no buffer do resultado; se ele for também um operando,
+    // o produto vai para um buffer novo que depois substitui o antigo.
+    int sobreposto = (resultado == a || resultado == b);
+    uint32_t *destino;
+    if (sobreposto) {
+        destino = armazenamento_alocar((size_t)tamanho);
+    } else {
+        garantir_capacidade(resultado, tamanho);
+        destino = resultado->blocos;
+    }
+
+    // Escolha automática do algoritmo pelo tamanho dos operandos:
+    // tradicional (pequenos), Karatsuba, Toom-3/Toom-4 (médios) ou NTT (grandes)
+    uint32_t *rascunho = NULL;
+    if (nb >= KARATSUBA_LIMIAR || nb >= QUADRADO_KARATSUBA_LIMIAR) {
+        rascunho = armazenamento_alocar_rascunho(RASCUNHO_MULTIPLICACAO(na));
+    }
+    multiplicar_blocos(destino, a->blocos, na, b->blocos, nb, rascunho);
+    armazenamento_liberar(rascunho);
+
+    if (sobreposto) {
+        armazenamento_liberar(resultado->blocos);
+        resultado->blocos = destino;
+        resultado->capacidade = tamanho;
+    } else if (resultado->capacidade > tamanho) {
+        memset(resultado->blocos + tamanho, 0, (size_t)(resultado->capacidade - tamanho) * sizeof(uint32_t));
+    }
+    resultado->quantidade_blocos = tamanho;
+    resultado->sinal = sinal;
     remover_zeros_a_esquerda(resultado);
 }
 
+void elevar_ao_quadrado(const GrandeNumero *a, GrandeNumero *resultado) {
+    multiplicar_grandes_numeros(a, a, resultado);
+}
+
 // --- DIVISÃO OTIMIZADA (baseada no Algoritmo D de Knuth) ---
 /*
  * Algoritmo D de Knuth para divisão de números grandes.
@@ -403,6 +950,7 @@ void multiplicar_grandes_numeros(const GrandeNumero *a, const GrandeNumero *b, G
  * 
  * Estratégia:
  * 1. Normalizar o divisor para que seu bloco mais significativo seja >= BASE/2
+ *    (na base 2^32 isso é um simples deslocamento de bits)
  * 2. Para cada posição do quociente, estimar q usando os 2 blocos superiores do dividendo
  *    e o bloco superior do divisor
  * 3. Ajustar q se necessário (raramente precisa de mais de 2 ajustes)
@@ -420,7 +968,7 @@ void dividir_por_inteiro(const GrandeNumero *dividendo, int divisor, GrandeNumer
     
     uint64_t resto = 0;
     for (int i = dividendo->quantidade_blocos - 1; i >= 0; i--) {
-        uint64_t cur = dividendo->blocos[i] + resto * BASE_NUMERICA;
+        uint64_t cur = (resto << BITS_POR_BLOCO) | dividendo->blocos[i];
         quociente->blocos[i] = cur / divisor_abs;
         resto = cur % divisor_abs;
     }
@@ -430,7 +978,169 @@ void dividir_por_inteiro(const GrandeNumero *dividendo, int divisor, GrandeNumer
     remover_zeros_a_esquerda(quociente);
 }
 
-void dividir_grande_numero(const GrandeNumero *dividendo, const GrandeNumero *divisor, GrandeNumero *quociente) {
+// Desloca os blocos de 'origem' para a esquerda em 'bits' (0 <= bits < 32),
+// escrevendo n blocos em 'destino' e retornando o bloco que transborda
+static uint32_t deslocar_blocos_esquerda(uint32_t *destino, const uint32_t *origem, int n, int bits) {
+    if (bits == 0) {
+        memmove(destino, origem, (size_t)n * sizeof(uint32_t));
+        return 0;
+    }
+    uint32_t transbordo = 0;
+    for (int i = 0; i < n; i++) {
+        uint32_t bloco = origem[i];
+        destino[i] = (bloco << bits) | transbordo;
+        transbordo = bloco >> (BITS_POR_BLOCO - bits);
+    }
+    return transbordo;
+}
+
+static int contar_zeros_a_esquerda(uint32_t bloco) {
+    return (bloco == 0) ? BITS_POR_BLOCO : __builtin_clz(bloco);
+}
+
+// --- DIVISÃO POR RECÍPROCO DE NEWTON ---
+/*
+ * Para operandos grandes o Algoritmo D (O(N*M)) domina o tempo total.
+ * Em vez dele, calcula-se uma aproximação do recíproco do divisor pela
+ * iteração de Newton para 1/D, que dobra a precisão a cada passo:
+ *
+ *   X_{k+1} = X_k + X_k * (1 - D * X_k)
+ *
+ * Em inteiros, com p blocos de precisão e β = 2^32:
+ *   X ≈ β^(2p) / D,   E = β^(2p) - D * X0,   X1 = X0 + (X0 * E) / β^(2p)
+ *
+ * A recursão calcula o recíproco da metade superior do divisor (h ≈ p/2
+ * blocos mais 2 de guarda), estende para p blocos e aplica um passo de
+ * Newton. Como o custo de cada nível é o de duas multiplicações do seu
+ * tamanho, o recíproco completo custa uma pequena constante vezes M(p).
+ *
+ * O quociente aproximado A * X / β^(2p) erra por poucas unidades; um passo
+ * final de correção com o resto exato R = A - Q * B deixa o resultado exato.
+ */
+
+// Limiar (em blocos do divisor e do quociente) a partir do qual Newton supera o Algoritmo D
+#define DIVISAO_NEWTON_LIMIAR (limiares.divisao_newton)
+
+// r = a * β^k (k < 0 descarta os |k| blocos inferiores, truncando)
+void deslocar_blocos(const GrandeNumero *a, int k, GrandeNumero *r) {
+    int n = a->quantidade_blocos + k;
+    if (eh_zero(a) || n <= 0) {
+        definir_valor_inteiro(r, 0);
+        return;
+    }
+    int sinal = a->sinal;
+    int quantidade_origem = a->quantidade_blocos;
+    garantir_capacidade(r, n);
+    if (k >= 0) {
+        memmove(r->blocos + k, a->blocos, (size_t)quantidade_origem * sizeof(uint32_t));
+        memset(r->blocos, 0, (size_t)k * sizeof(uint32_t));
+    } else {
+        memmove(r->blocos, a->blocos - k, (size_t)n * sizeof(uint32_t));
+    }
+    r->quantidade_blocos = n;
+    r->sinal = sinal;
+    remover_zeros_a_esquerda(r);
+    if (eh_zero(r)) r->sinal = 1;
+}
+
+// r = β^k
+static void definir_potencia_base(GrandeNumero *r, int k) {
+    definir_valor_inteiro(r, 1);
+    deslocar_blocos(r, k, r);
+}
+
+// X ≈ floor(β^(2p) / D), com D de exatamente p blocos; erro de poucas unidades
+static void reciproco_newton(const GrandeNumero *d, int p, GrandeNumero *x) {
+    GrandeNumero *potencia = criar_grande_numero(2 * p + 1);
+    definir_potencia_base(potencia, 2 * p);
+
+    if (p < DIVISAO_NEWTON_LIMIAR) {
+        // Caso base: divisão exata pelo Algoritmo D
+        dividir_com_resto(potencia, d, x, NULL);
+        liberar_grande_numero(potencia);
+        return;
+    }
+
+    // Recíproco da metade superior (com 2 blocos de guarda)
+    int h = (p + 1) / 2 + 2;
+    GrandeNumero *d_alto = criar_grande_numero(h);
+    deslocar_blocos(d, -(p - h), d_alto);
+    GrandeNumero *x_alto = criar_grande_numero(h + 2);
+    reciproco_newton(d_alto, h, x_alto);
+    liberar_grande_numero(d_alto);
+
+    // X0 = X_alto * β^(p-h)
+    deslocar_blocos(x_alto, p - h, x);
+    liberar_grande_numero(x_alto);
+
+    // E = β^(2p) - D * X0 (pequeno e com sinal)
+    GrandeNumero *erro = criar_grande_numero(2 * p + 2);
+    multiplicar_grandes_numeros(d, x, erro);
+    subtrair_grandes_numeros(potencia, erro, erro);
+
+    // X1 = X0 + X0 * E / β^(2p)
+    GrandeNumero *correcao = criar_grande_numero(1);
+    multiplicar_grandes_numeros(x, erro, correcao);
+    deslocar_blocos(correcao, -2 * p, correcao);
+    somar_grandes_numeros(x, correcao, x);
+
+    liberar_grande_numero(erro);
+    liberar_grande_numero(correcao);
+    liberar_grande_numero(potencia);
+}
+
+// Divisão de magnitudes por recíproco de Newton; sinais como no Algoritmo D
+static void dividir_newton(const GrandeNumero *dividendo, const GrandeNumero *divisor, GrandeNumero *quociente, GrandeNumero *resto) {
+    GrandeNumero a = *dividendo;
+    GrandeNumero b = *divisor;
+    a.sinal = 1;
+    b.sinal = 1;
+
+    // Precisão: blocos do quociente mais 2 de guarda
+    int p = a.quantidade_blocos - b.quantidade_blocos + 3;
+    int shift = p - b.quantidade_blocos;
+
+    // Recíproco dos p blocos superiores do divisor
+    GrandeNumero *b_alto = criar_grande_numero(p);
+    deslocar_blocos(&b, shift, b_alto);
+    GrandeNumero *x = criar_grande_numero(p + 2);
+    reciproco_newton(b_alto, p, x);
+    liberar_grande_numero(b_alto);
+
+    // Q ≈ (A * β^shift) * X / β^(2p)
+    GrandeNumero *q = criar_grande_numero(1);
+    deslocar_blocos(&a, shift, q);
+    multiplicar_grandes_numeros(q, x, q);
+    deslocar_blocos(q, -2 * p, q);
+    liberar_grande_numero(x);
+
+    // Correção: R = A - Q * B, ajustando Q até 0 <= R < B
+    GrandeNumero *r = criar_grande_numero(1);
+    GrandeNumero *um = criar_grande_numero(1);
+    definir_valor_inteiro(um, 1);
+    multiplicar_grandes_numeros(q, &b, r);
+    subtrair_grandes_numeros(&a, r, r);
+    while (r->sinal < 0) {
+        subtrair_grandes_numeros(q, um, q);
+        somar_grandes_numeros(r, &b, r);
+    }
+    while (comparar_magnitude(r, &b) >= 0) {
+        somar_grandes_numeros(q, um, q);
+        subtrair_grandes_numeros(r, &b, r);
+    }
+    liberar_grande_numero(um);
+
+    q->sinal = (dividendo->sinal == divisor->sinal) ? 1 : -1;
+    if (eh_zero(q)) q->sinal = 1;
+    r->sinal = eh_zero(r) ? 1 : dividendo->sinal;
+
+    if (resto != NULL) copiar_grande_numero(resto, r);
+    if (quociente != NULL) copiar_grande_numero(quociente, q);
+    liberar_grande_numero(q);
+    liberar_grande_numero(r);
+}
+
+void dividir_com_resto(const GrandeNumero *dividendo, const GrandeNumero *divisor, GrandeNumero *quociente, GrandeNumero *resto) {
     if (eh_zero(divisor)) {
         printf("ERRO: Divisão por zero!\n");
         return;
@@ -438,20 +1148,42 @@ void dividir_grande_numero(const GrandeNumero *dividendo, const GrandeNumero *di
     
     int cmp = comparar_magnitude(dividendo, divisor);
     if (cmp < 0) {
-        definir_valor_inteiro(quociente, 0);
+        if (resto != NULL) copiar_grande_numero(resto, dividendo);
+        if (quociente != NULL) definir_valor_inteiro(quociente, 0);
         return;
     }
     
-    if (cmp == 0) {
-        definir_valor_inteiro(quociente, 1);
-        quociente->sinal = (dividendo->sinal == divisor->sinal) ? 1 : -1;
+    int sinal_quociente = (dividendo->sinal == divisor->sinal) ? 1 : -1;
+    int sinal_resto = dividendo->sinal;
+    
+    // Se o divisor cabe em um único bloco, usar divisão por bloco (muito mais rápida)
+    if (divisor->quantidade_blocos == 1) {
+        uint32_t d = divisor->blocos[0];
+        uint64_t r = 0;
+        GrandeNumero *q = criar_grande_numero(dividendo->quantidade_blocos);
+        for (int i = dividendo->quantidade_blocos - 1; i >= 0; i--) {
+            uint64_t cur = (r << BITS_POR_BLOCO) | dividendo->blocos[i];
+            q->blocos[i] = (uint32_t)(cur / d);
+            r = cur % d;
+        }
+        q->quantidade_blocos = dividendo->quantidade_blocos;
+        remover_zeros_a_esquerda(q);
+        q->sinal = sinal_quociente;
+        if (eh_zero(q)) q->sinal = 1;
+        
+        if (resto != NULL) {
+            definir_valor_inteiro64(resto, (int64_t)r);
+            resto->sinal = (r != 0) ? sinal_resto : 1;
+        }
+        if (quociente != NULL) copiar_grande_numero(quociente, q);
+        liberar_grande_numero(q);
         return;
     }
     
-    // Se o divisor cabe em um único bloco, usar divisão por inteiro (muito mais rápida)
-    if (divisor->quantidade_blocos == 1) {
-        dividir_por_inteiro(dividendo, divisor->blocos[0], quociente);
-        quociente->sinal = (dividendo->sinal == divisor->sinal) ? 1 : -1;
+    // Operandos grandes: divisão por recíproco de Newton (custo de poucas multiplicações)
+    int blocos_quociente = dividendo->quantidade_blocos - divisor->quantidade_blocos + 1;
+    if (divisor->quantidade_blocos >= DIVISAO_NEWTON_LIMIAR && blocos_quociente >= DIVISAO_NEWTON_LIMIAR) {
+        dividir_newton(dividendo, divisor, quociente, resto);
         return;
     }
     
@@ -460,162 +1192,861 @@ void dividir_grande_numero(const GrandeNumero *dividendo, const GrandeNumero *di
     int n = divisor->quantidade_blocos;
     int m = dividendo->quantidade_blocos - n;
     
-    // Copiar valores para trabalhar (usaremos magnitudes)
-    GrandeNumero *u = criar_grande_numero(dividendo->quantidade_blocos + 1);
-    copiar_grande_numero(u, dividendo);
-    u->sinal = 1;
+    // D1: Normalizar - deslocar ambos para que o bit mais alto de v[n-1] seja 1.
+    // Na base 2^32 o fator d é uma potência de 2, logo basta um shift.
+    int s = contar_zeros_a_esquerda(divisor->blocos[n - 1]);
     
-    GrandeNumero *v = criar_grande_numero(divisor->quantidade_blocos);
-    copiar_grande_numero(v, divisor);
-    v->sinal = 1;
+    uint32_t *u = armazenamento_alocar_rascunho_zerado((size_t)dividendo->quantidade_blocos + 1);
+    uint32_t *v = armazenamento_alocar_rascunho_zerado((size_t)n);
+    u[dividendo->quantidade_blocos] = deslocar_blocos_esquerda(u, dividendo->blocos, dividendo->quantidade_blocos, s);
+    deslocar_blocos_esquerda(v, divisor->blocos, n, s);
     
-    // D1: Normalizar - multiplicar ambos por um fator d tal que v[n-1] >= BASE/2
-    uint32_t d = BASE_NUMERICA / (v->blocos[n - 1] + 1);
-    if (d > 1) {
-        multiplicar_por_inteiro(u, d, u);
-        multiplicar_por_inteiro(v, d, v);
-    }
-    
-    // Garantir que u tem espaço para um bloco extra
-    garantir_capacidade(u, dividendo->quantidade_blocos + 1);
-    if (u->quantidade_blocos <= dividendo->quantidade_blocos) {
-        u->blocos[dividendo->quantidade_blocos] = 0;
-        u->quantidade_blocos = dividendo->quantidade_blocos + 1;
-    }
+    GrandeNumero *q = criar_grande_numero(m + 1);
+    q->quantidade_blocos = m + 1;
     
-    // Preparar quociente
-    garantir_capacidade(quociente, m + 1);
-    definir_valor_inteiro(quociente, 0);
-    quociente->quantidade_blocos = m + 1;
+    uint64_t v_alto = v[n - 1];
+    uint64_t v_segundo = v[n - 2];
     
-    // D2-D7: Loop principal - calcular cada dígito do quociente
+    // D2-D7: Loop principal - calcular cada bloco do quociente
     for (int j = m; j >= 0; j--) {
         // D3: Calcular estimativa de q
-        uint64_t dividendo_alto = ((uint64_t)u->blocos[j + n] * BASE_NUMERICA + u->blocos[j + n - 1]);
-        uint64_t q_hat = dividendo_alto / v->blocos[n - 1];
-        uint64_t r_hat = dividendo_alto % v->blocos[n - 1];
+        uint64_t dividendo_alto = ((uint64_t)u[j + n] << BITS_POR_BLOCO) | u[j + n - 1];
+        uint64_t q_hat = dividendo_alto / v_alto;
+        uint64_t r_hat = dividendo_alto % v_alto;
         
-        // Refinar q_hat
-        while (q_hat >= BASE_NUMERICA || 
-               (q_hat * v->blocos[n - 2] > BASE_NUMERICA * r_hat + u->blocos[j + n - 2])) {
+        // Refinar q_hat (no máximo 2 correções)
+        while (q_hat >= BASE_NUMERICA ||
+               q_hat * v_segundo > ((r_hat << BITS_POR_BLOCO) | u[j + n - 2])) {
             q_hat--;
-            r_hat += v->blocos[n - 1];
+            r_hat += v_alto;
             if (r_hat >= BASE_NUMERICA) break;
         }
         
         // D4: Multiplicar e subtrair: u[j..j+n] -= q_hat * v
-        int64_t carry = 0;
-        for (int i = 0; i <= n; i++) {
-            uint64_t produto = (i < n) ? q_hat * v->blocos[i] : 0;
-            int64_t diff = (int64_t)u->blocos[j + i] - (produto % BASE_NUMERICA) - carry;
-            carry = (produto / BASE_NUMERICA);
-            
-            if (diff < 0) {
-                diff += BASE_NUMERICA;
-                carry++;
-            }
-            u->blocos[j + i] = diff;
+        // O carry do produto entra antes da subtração (produto + carry < 2^64)
+        uint64_t carry = 0;
+        uint64_t borrow = 0;
+        for (int i = 0; i < n; i++) {
+            uint64_t produto = q_hat * v[i] + carry;
+            carry = produto >> BITS_POR_BLOCO;
+            uint64_t diff = (uint64_t)u[j + i] - (uint32_t)produto - borrow;
+            u[j + i] = (uint32_t)diff;
+            borrow = diff >> 63;
         }
+        uint64_t diff = (uint64_t)u[j + n] - carry - borrow;
+        u[j + n] = (uint32_t)diff;
         
         // D5: Testar resto - se negativo, q_hat está 1 a mais
-        if (carry > 0) {
+        if (diff >> 63) {
             // D6: Adicionar de volta: u[j..j+n] += v
             q_hat--;
             uint64_t carry_back = 0;
-            for (int i = 0; i <= n; i++) {
-                uint64_t soma = (uint64_t)u->blocos[j + i] + (i < n ? v->blocos[i] : 0) + carry_back;
-                u->blocos[j + i] = soma % BASE_NUMERICA;
-                carry_back = soma / BASE_NUMERICA;
+            for (int i = 0; i < n; i++) {
+                uint64_t soma = (uint64_t)u[j + i] + v[i] + carry_back;
+                u[j + i] = (uint32_t)soma;
+                carry_back = soma >> BITS_POR_BLOCO;
             }
+            u[j + n] += (uint32_t)carry_back;
         }
         
-        quociente->blocos[j] = q_hat;
+        q->blocos[j] = (uint32_t)q_hat;
     }
     
-    // D8: Desnormalizar (o resto está em u, mas não precisamos dele para esta função)
-    remover_zeros_a_esquerda(quociente);
-    quociente->sinal = (dividendo->sinal == divisor->sinal) ? 1 : -1;
+    remover_zeros_a_esquerda(q);
+    q->sinal = sinal_quociente;
+    if (eh_zero(q)) q->sinal = 1;
     
-    liberar_grande_numero(u);
-    liberar_grande_numero(v);
+    // D8: Desnormalizar o resto (u[0..n-1] >> s)
+    if (resto != NULL) {
+        garantir_capacidade(resto, n);
+        for (int i = 0; i < n; i++) {
+            uint32_t alto = (s > 0 && i + 1 < n) ? (uint32_t)(u[i + 1] << (BITS_POR_BLOCO - s)) : 0;
+            resto->blocos[i] = (s > 0) ? ((u[i] >> s) | alto) : u[i];
+        }
+        resto->quantidade_blocos = n;
+        remover_zeros_a_esquerda(resto);
+        resto->sinal = eh_zero(resto) ? 1 : sinal_resto;
+    }
+    if (quociente != NULL) copiar_grande_numero(quociente, q);
+    
+    liberar_grande_numero(q);
+    armazenamento_liberar(u);
+    armazenamento_liberar(v);
+}
+
+void dividir_grande_numero(const GrandeNumero *dividendo, const GrandeNumero *divisor, GrandeNumero *quociente) {
+    dividir_com_resto(dividendo, divisor, quociente, NULL);
 }
 
-// --- RAIZ QUADRADA (Newton-Raphson otimizado) ---
+// --- RAIZ QUADRADA (Newton para 1/sqrt com precisão dobrando) ---
 /*
- * Método de Newton-Raphson para calcular raiz quadrada.
- * 
- * Fórmula iterativa: x_{n+1} = (x_n + N/x_n) / 2
- * 
- * Convergência: Quadrática (dobra o número de dígitos corretos a cada iteração)
- * 
- * Estimativa inicial: 10^(metade dos dígitos de N)
- * Com boa estimativa inicial, converge em log(precisão) iterações
+ * Em vez de x_{n+1} = (x_n + N/x_n) / 2, que exige uma divisão completa por
+ * iteração, calcula-se y = 1/sqrt(x) pela iteração de Newton sem divisões:
+ *
+ *   y_{k+1} = y_k + y_k * (1 - x * y_k^2) / 2
+ *
+ * com x = N / 2^E em [1/4, 1) (E par) e y em (1, 2]. Em ponto fixo com b bits,
+ * Y ≈ y * 2^b. A semente vem de um double (~50 bits corretos) e cada passo
+ * dobra a precisão, trabalhando só com os bits necessários de N e de Y:
+ * o custo total é o de poucas multiplicações do tamanho final.
+ *
+ * Ao final, sqrt(N) = N * y / 2^(E/2) dá uma aproximação com erro de poucas
+ * unidades, corrigida com o resto exato R = N - S^2 (0 <= R <= 2S).
  */
 
-void raiz_quadrada(const GrandeNumero *numero, GrandeNumero *resultado) {
-    if (numero->sinal < 0) {
+// Bits de semente obtidos diretamente do double
+#define RAIZ_BITS_SEMENTE 40
+
+static long contar_bits(const GrandeNumero *a) {
+    if (eh_zero(a)) return 0;
+    uint32_t topo = a->blocos[a->quantidade_blocos - 1];
+    return (long)(a->quantidade_blocos - 1) * BITS_POR_BLOCO + (BITS_POR_BLOCO - contar_zeros_a_esquerda(topo));
+}
+
+// r = a * 2^k (k < 0 trunca os bits inferiores)
+static void deslocar_bits(const GrandeNumero *a, long k, GrandeNumero *r) {
+    // Para k < 0: desloca (32 - |k| mod 32) bits à esquerda e depois descarta
+    // ceil(|k| / 32) blocos inteiros, o que equivale a 2^k com truncamento
+    long blocos = (k >= 0) ? k / BITS_POR_BLOCO : -((-k + BITS_POR_BLOCO - 1) / BITS_POR_BLOCO);
+    int bits = (int)(k - blocos * BITS_POR_BLOCO);   // 0 <= bits < 32, sempre à esquerda
+
+    copiar_grande_numero(r, a);
+    if (bits > 0 && !eh_zero(r)) {
+        garantir_capacidade(r, r->quantidade_blocos + 1);
+        r->blocos[r->quantidade_blocos] = deslocar_blocos_esquerda(r->blocos, r->blocos, r->quantidade_blocos, bits);
+        r->quantidade_blocos++;
+        remover_zeros_a_esquerda(r);
+    }
+    deslocar_blocos(r, (int)blocos, r);
+}
+
+// Y ≈ 2^b / sqrt(N / 2^E), com precisão relativa de ~2^-b
+static void raiz_inversa_newton(const GrandeNumero *numero, long expoente, long b, GrandeNumero *y) {
+    if (b <= RAIZ_BITS_SEMENTE) {
+        // Semente: os 64 bits superiores de N bastam para um double
+        long bits = contar_bits(numero);
+        GrandeNumero *topo = criar_grande_numero(3);
+        deslocar_bits(numero, 64 - bits, topo);
+        uint64_t mantissa = topo->blocos[0] | ((topo->quantidade_blocos > 1) ? (uint64_t)topo->blocos[1] << 32 : 0);
+        liberar_grande_numero(topo);
+
+        double x = ldexp((double)mantissa, (int)(bits - 64 - expoente));
+        double semente = ldexp(1.0 / sqrt(x), (int)b);
+        definir_valor_inteiro64(y, (int64_t)semente);
+        return;
+    }
+
+    // Precisão da metade (mais guarda), depois um passo de Newton até b bits
+    long h = b / 2 + 8;
+    raiz_inversa_newton(numero, expoente, h, y);
+    deslocar_bits(y, b - h, y);   // Y0
+
+    // x truncado em b + 32 bits: x ≈ X_t / 2^(b+32)
+    long g = 32;
+    GrandeNumero *x_t = criar_grande_numero(1);
+    deslocar_bits(numero, (b + g) - expoente, x_t);
+
+    // E = 2^(3b+g) - X_t * Y0^2  (representa 1 - x*y0^2, pequeno e com sinal)
+    GrandeNumero *erro = criar_grande_numero(1);
+    elevar_ao_quadrado(y, erro);
+    multiplicar_grandes_numeros(x_t, erro, erro);
+    liberar_grande_numero(x_t);
+    GrandeNumero *potencia = criar_grande_numero(1);
+    definir_valor_inteiro(potencia, 1);
+    deslocar_bits(potencia, 3 * b + g, potencia);
+    subtrair_grandes_numeros(potencia, erro, erro);
+    liberar_grande_numero(potencia);
+
+    // Y1 = Y0 + Y0 * E / 2^(3b+g+1)
+    multiplicar_grandes_numeros(y, erro, erro);
+    deslocar_bits(erro, -(3 * b + g + 1), erro);
+    somar_grandes_numeros(y, erro, y);
+    liberar_grande_numero(erro);
+}
+
+void raiz_quadrada_resto(const GrandeNumero *numero, GrandeNumero *raiz, GrandeNumero *resto) {
+    if (numero->sinal < 0 && !eh_zero(numero)) {
         printf("ERRO: Raiz quadrada de número negativo!\n");
         return;
     }
     if (eh_zero(numero)) {
-        definir_valor_inteiro(resultado, 0);
+        if (raiz != NULL) definir_valor_inteiro(raiz, 0);
+        if (resto != NULL) definir_valor_inteiro(resto, 0);
         return;
     }
 
-    // Estimativa inicial: 10^(ceil(digitos/2))
-    // Em termos de blocos: aproximadamente metade dos blocos
-    int shift = (numero->quantidade_blocos + 1) / 2;
-    
-    GrandeNumero *x = criar_grande_numero(shift + 1);
-    definir_valor_inteiro(x, 1);
-    
-    // Criar número com shift blocos: 1 seguido de (shift) blocos de zeros
-    if (shift > 0) {
-        garantir_capacidade(x, shift + 1);
-        for (int i = shift; i > 0; i--) x->blocos[i] = 0;
-        x->blocos[shift] = 1;
-        x->quantidade_blocos = shift + 1;
+    // N = x * 2^E com E par e x em [1/4, 1)
+    long bits = contar_bits(numero);
+    long expoente = bits + (bits & 1);
+    long b = expoente / 2 + 32;
+
+    GrandeNumero *y = criar_grande_numero(1);
+    raiz_inversa_newton(numero, expoente, b, y);
+
+    // S ≈ N * Y / 2^(b + E/2)
+    GrandeNumero *s = criar_grande_numero(1);
+    multiplicar_grandes_numeros(numero, y, s);
+    deslocar_bits(s, -(b + expoente / 2), s);
+    liberar_grande_numero(y);
+
+    // Correção com o resto exato: 0 <= R = N - S^2 <= 2S
+    GrandeNumero *r = criar_grande_numero(1);
+    GrandeNumero *dobro = criar_grande_numero(1);
+    GrandeNumero *um = criar_grande_numero(1);
+    definir_valor_inteiro(um, 1);
+    elevar_ao_quadrado(s, r);
+    subtrair_grandes_numeros(numero, r, r);
+    while (r->sinal < 0) {
+        // S-- e R += 2S + 1 (com o novo S)
+        subtrair_grandes_numeros(s, um, s);
+        somar_grandes_numeros(s, s, dobro);
+        somar_grandes_numeros(r, dobro, r);
+        somar_grandes_numeros(r, um, r);
+    }
+    somar_grandes_numeros(s, s, dobro);
+    while (comparar_magnitude(r, dobro) > 0) {
+        // R -= 2S + 1 e S++
+        subtrair_grandes_numeros(r, dobro, r);
+        subtrair_grandes_numeros(r, um, r);
+        somar_grandes_numeros(s, um, s);
+        somar_grandes_numeros(s, s, dobro);
     }
 
-    GrandeNumero *x_anterior = criar_grande_numero(numero->capacidade);
-    GrandeNumero *div = criar_grande_numero(numero->capacidade);
-    
-    // Newton-Raphson: x = (x + n/x) / 2
-    // Continuaremos até convergência (x não muda mais)
-    int iteracoes_max = 150;  // Suficiente para 100k dígitos
-    for (int i = 0; i < iteracoes_max; i++) {
-        copiar_grande_numero(x_anterior, x);
-        
-        // div = numero / x
-        dividir_grande_numero(numero, x, div);
-        
-        // x = (x + div) / 2
-        somar_grandes_numeros(x, div, x);
-        dividir_por_inteiro(x, 2, x);
-        
-        // Verificar convergência: se x == x_anterior, terminamos
-        if (comparar_magnitude(x, x_anterior) == 0) {
-            break;
+    if (raiz != NULL) copiar_grande_numero(raiz, s);
+    if (resto != NULL) copiar_grande_numero(resto, r);
+    liberar_grande_numero(s);
+    liberar_grande_numero(r);
+    liberar_grande_numero(dobro);
+    liberar_grande_numero(um);
+}
+
+void raiz_quadrada(const GrandeNumero *numero, GrandeNumero *resultado) {
+    raiz_quadrada_resto(numero, resultado, NULL);
+}
+
+// --- DIVISÃO EXATA (Hensel) ---
+/*
+ * Quando se sabe que D divide N, o quociente pode ser calculado de baixo
+ * para cima (Jebelean): com n = blocos do quociente,
+ *   Q ≡ N · D^(-1)  (mod β^n)
+ * sem as estimativas e correções do Algoritmo D. O inverso 2-ádico existe
+ * para D ímpar; as potências de 2 de D (e de N) são removidas antes por shift.
+ *
+ * Quocientes pequenos (ou divisores curtos) usam a eliminação bloco a bloco,
+ * O(n·m). Acima de DIVISAO_EXATA_LIMIAR blocos o inverso D^(-1) mod β^m vem
+ * da iteração de Newton-Hensel X ← X(2 - D·X), que dobra os blocos corretos
+ * a cada passo, e o quociente sai em fatias de m = min(n, blocos de D)
+ * blocos, cada uma com um produto pelo inverso e outro pelo divisor.
+ */
+
+#define DIVISAO_EXATA_LIMIAR (limiares.divisao_exata)
+
+// q[0..n) = a / d mod β^n (d ímpar), zerando um bloco de a por vez
+static void dividir_exato_basico(const uint32_t *a, int na, const uint32_t *d, int nd, int n, uint32_t *q) {
+    uint32_t *r = armazenamento_alocar_rascunho_zerado((size_t)n);
+    memcpy(r, a, (size_t)((na < n) ? na : n) * sizeof(uint32_t));
+    uint32_t d_inv = inverso_bloco(d[0]);
+
+    for (int i = 0; i < n; i++) {
+        uint32_t qi = r[i] * d_inv;
+        q[i] = qi;
+
+        // r -= qi * d * β^i (apenas os blocos abaixo de n importam)
+        int len = (nd < n - i) ? nd : n - i;
+        uint64_t carry = 0, borrow = 0;
+        for (int j = 0; j < len; j++) {
+            uint64_t prod = (uint64_t)qi * d[j] + carry;
+            carry = prod >> BITS_POR_BLOCO;
+            uint64_t diff = (uint64_t)r[i + j] - (uint32_t)prod - borrow;
+            r[i + j] = (uint32_t)diff;
+            borrow = diff >> 63;
         }
-        
-        // Verificar oscilação entre dois valores (comum em raiz inteira)
-        // Se abs(x - x_anterior) <= 1, estamos perto o suficiente
-        GrandeNumero *diferenca = criar_grande_numero(x->quantidade_blocos);
-        if (comparar_magnitude(x, x_anterior) > 0) {
-            subtrair_magnitudes(x, x_anterior, diferenca);
+        uint64_t pendente = carry + borrow;
+        for (int k = i + len; k < n && pendente; k++) {
+            uint64_t diff = (uint64_t)r[k] - pendente;
+            r[k] = (uint32_t)diff;
+            pendente = diff >> 63;
+        }
+    }
+    armazenamento_liberar(r);
+}
+
+// a = a mod β^k
+static void manter_blocos_baixos(GrandeNumero *a, int k) {
+    if (a->quantidade_blocos > k) {
+        memset(a->blocos + k, 0, (size_t)(a->quantidade_blocos - k) * sizeof(uint32_t));
+        a->quantidade_blocos = k;
+        remover_zeros_a_esquerda(a);
+    }
+}
+
+// Visão (sem cópia) de a mod β^k
+static GrandeNumero visao_blocos_baixos(const GrandeNumero *a, int k) {
+    GrandeNumero visao = *a;
+    if (visao.quantidade_blocos > k) {
+        visao.quantidade_blocos = k;
+        remover_zeros_a_esquerda(&visao);
+    }
+    return visao;
+}
+
+// X = D^(-1) mod β^n, com D ímpar
+static void inverso_hensel(const GrandeNumero *d, int n, GrandeNumero *x) {
+    if (n <= DIVISAO_EXATA_LIMIAR) {
+        const uint32_t um = 1;
+        garantir_capacidade(x, n);
+        dividir_exato_basico(&um, 1, d->blocos, d->quantidade_blocos, n, x->blocos);
+        x->quantidade_blocos = n;
+        x->sinal = 1;
+        remover_zeros_a_esquerda(x);
+        return;
+    }
+
+    int h = (n + 1) / 2;
+    inverso_hensel(d, h, x);
+
+    // E = D·X mod β^n ≡ 1 (mod β^h), logo E - 1 = F·β^h
+    GrandeNumero d_baixo = visao_blocos_baixos(d, n);
+    GrandeNumero *e = criar_grande_numero(1);
+    multiplicar_grandes_numeros(&d_baixo, x, e);
+    manter_blocos_baixos(e, n);
+    e->blocos[0] = 0;
+    deslocar_blocos(e, -h, e);
+
+    // X ← X - X·F·β^h (mod β^n)
+    GrandeNumero *correcao = criar_grande_numero(1);
+    multiplicar_grandes_numeros(x, e, correcao);
+    manter_blocos_baixos(correcao, n - h);
+    deslocar_blocos(correcao, h, correcao);
+    if (comparar_magnitude(x, correcao) < 0) {
+        GrandeNumero *modulo = criar_grande_numero(n + 1);
+        definir_potencia_base(modulo, n);
+        somar_magnitudes(modulo, x, x);
+        liberar_grande_numero(modulo);
+    }
+    subtrair_magnitudes(x, correcao, x);
+    manter_blocos_baixos(x, n);
+
+    liberar_grande_numero(e);
+    liberar_grande_numero(correcao);
+}
+
+void dividir_exato(const GrandeNumero *dividendo, const GrandeNumero *divisor, GrandeNumero *quociente) {
+    if (eh_zero(divisor)) {
+        printf("ERRO: Divisão por zero!\n");
+        return;
+    }
+    if (comparar_magnitude(dividendo, divisor) < 0) {
+        definir_valor_inteiro(quociente, 0);
+        return;
+    }
+    int sinal = (dividendo->sinal == divisor->sinal) ? 1 : -1;
+
+    // Remover do divisor (e do dividendo, que os contém) os fatores 2
+    int zeros_blocos = 0;
+    while (divisor->blocos[zeros_blocos] == 0) zeros_blocos++;
+    long zeros = (long)zeros_blocos * BITS_POR_BLOCO + __builtin_ctz(divisor->blocos[zeros_blocos]);
+
+    GrandeNumero *n = criar_grande_numero(1);
+    GrandeNumero *d = criar_grande_numero(1);
+    deslocar_bits(dividendo, -zeros, n);
+    deslocar_bits(divisor, -zeros, d);
+    n->sinal = 1;
+    d->sinal = 1;
+
+    int blocos = n->quantidade_blocos - d->quantidade_blocos + 1;
+    GrandeNumero *q = criar_grande_numero(blocos);
+    if (blocos <= DIVISAO_EXATA_LIMIAR || d->quantidade_blocos <= DIVISAO_EXATA_LIMIAR) {
+        dividir_exato_basico(n->blocos, n->quantidade_blocos, d->blocos, d->quantidade_blocos, blocos, q->blocos);
+        q->quantidade_blocos = blocos;
+        remover_zeros_a_esquerda(q);
+    } else {
+        // Quocientes mais longos que o divisor saem em fatias de m blocos,
+        // reaproveitando o mesmo inverso: Q_i = R mod β^m · D^(-1), R ← (R - Q_i·D) / β^m
+        int m = (blocos < d->quantidade_blocos) ? blocos : d->quantidade_blocos;
+        GrandeNumero *inverso = criar_grande_numero(m);
+        inverso_hensel(d, m, inverso);
+
+        GrandeNumero *fatia = criar_grande_numero(m);
+        GrandeNumero *produto = criar_grande_numero(1);
+        memset(q->blocos, 0, (size_t)blocos * sizeof(uint32_t));
+        for (int inicio = 0; inicio < blocos; inicio += m) {
+            int k = (blocos - inicio < m) ? blocos - inicio : m;
+            GrandeNumero n_baixo = visao_blocos_baixos(n, k);
+            GrandeNumero inverso_baixo = visao_blocos_baixos(inverso, k);
+            multiplicar_grandes_numeros(&n_baixo, &inverso_baixo, fatia);
+            manter_blocos_baixos(fatia, k);
+            memcpy(q->blocos + inicio, fatia->blocos, (size_t)fatia->quantidade_blocos * sizeof(uint32_t));
+
+            if (inicio + k < blocos) {
+                // O resto continua múltiplo de D, então a subtração nunca fica negativa
+                multiplicar_grandes_numeros(fatia, d, produto);
+                subtrair_magnitudes(n, produto, n);
+                deslocar_blocos(n, -k, n);
+            }
+        }
+        q->quantidade_blocos = blocos;
+        remover_zeros_a_esquerda(q);
+
+        liberar_grande_numero(inverso);
+        liberar_grande_numero(fatia);
+        liberar_grande_numero(produto);
+    }
+
+    copiar_grande_numero(quociente, q);
+    quociente->sinal = eh_zero(q) ? 1 : sinal;
+    liberar_grande_numero(q);
+    liberar_grande_numero(n);
+    liberar_grande_numero(d);
+}
+
+// --- POTÊNCIAS INTEIRAS ---
+
+// resultado = base^expoente por quadrados sucessivos (O(M(N)) com o multiplicador rápido)
+void potencia_inteira(int base, int expoente, GrandeNumero *resultado) {
+    GrandeNumero *acumulado = criar_grande_numero(1);
+    GrandeNumero *quadrado = criar_grande_numero(1);
+    definir_valor_inteiro(acumulado, 1);
+    definir_valor_inteiro(quadrado, base);
+
+    while (expoente > 0) {
+        if (expoente & 1) multiplicar_grandes_numeros(acumulado, quadrado, acumulado);
+        expoente >>= 1;
+        if (expoente > 0) elevar_ao_quadrado(quadrado, quadrado);
+    }
+
+    copiar_grande_numero(resultado, acumulado);
+    liberar_grande_numero(acumulado);
+    liberar_grande_numero(quadrado);
+}
+
+// --- CONVERSÃO DE BASE (binário <-> decimal) ---
+/*
+ * Conversão dividir-para-conquistar (Schönhage).
+ *
+ * Para converter N < 10^(2k) em 2k dígitos decimais:
+ *   N = Q * 10^k + R, com 0 <= R < 10^k
+ *   dígitos(N) = dígitos(Q) em k posições || dígitos(R) em k posições
+ *
+ * As potências 10^(9*2^i) são calculadas uma única vez por conversão
+ * (cada uma é o quadrado da anterior) e reaproveitadas em todos os nós do
+ * mesmo nível. Com multiplicação e divisão rápidas o custo total é
+ * O(M(N) log N). Abaixo de CONVERSAO_LIMIAR blocos usa-se o método
+ * tradicional (divisões sucessivas por 10^9).
+ */
+
+#define CONVERSAO_LIMIAR (limiares.conversao)
+#define MAX_NIVEIS_CONVERSAO 40
+
+typedef struct {
+    GrandeNumero *potencias[MAX_NIVEIS_CONVERSAO];  // potencias[i] = 10^(9 * 2^i)
+    int quantidade;
+} TabelaPotenciasDez;
+
+static void estender_tabela_potencias(TabelaPotenciasDez *tabela) {
+    GrandeNumero *nova = criar_grande_numero(1);
+    if (tabela->quantidade == 0) {
+        definir_valor_inteiro(nova, BASE_PEDACO_DECIMAL);
+    } else {
+        const GrandeNumero *anterior = tabela->potencias[tabela->quantidade - 1];
+        elevar_ao_quadrado(anterior, nova);
+    }
+    tabela->potencias[tabela->quantidade++] = nova;
+}
+
+static void liberar_tabela_potencias(TabelaPotenciasDez *tabela) {
+    for (int i = 0; i < tabela->quantidade; i++) liberar_grande_numero(tabela->potencias[i]);
+    tabela->quantidade = 0;
+}
+
+// Pares "00".."99": cada pedaço de 9 dígitos sai com 4 consultas e um dígito avulso
+static const char pares_digitos[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Escreve v < 10^9 em exatamente 9 dígitos
+static void escrever_pedaco_decimal(uint32_t v, char *saida) {
+    for (int i = DIGITOS_POR_PEDACO_DECIMAL - 2; i >= 1; i -= 2) {
+        memcpy(saida + i, pares_digitos + 2 * (v % 100), 2);
+        v /= 100;
+    }
+    saida[0] = (char)('0' + v);
+}
+
+// Escreve exatamente 'quantidade' dígitos de N (com zeros à esquerda) por divisões por 10^9
+static void escrever_decimal_tradicional(const GrandeNumero *numero, char *saida, long quantidade) {
+    GrandeNumero *temp = criar_grande_numero(numero->quantidade_blocos);
+    copiar_grande_numero(temp, numero);
+    temp->sinal = 1;
+
+    long pos = quantidade;
+    while (pos > 0 && !eh_zero(temp)) {
+        // Resto por 10^9 calculado junto com o quociente
+        uint64_t r = 0;
+        for (int i = temp->quantidade_blocos - 1; i >= 0; i--) {
+            uint64_t cur = (r << BITS_POR_BLOCO) | temp->blocos[i];
+            temp->blocos[i] = (uint32_t)(cur / BASE_PEDACO_DECIMAL);
+            r = cur % BASE_PEDACO_DECIMAL;
+        }
+        remover_zeros_a_esquerda(temp);
+
+        if (pos >= DIGITOS_POR_PEDACO_DECIMAL) {
+            pos -= DIGITOS_POR_PEDACO_DECIMAL;
+            escrever_pedaco_decimal((uint32_t)r, saida + pos);
         } else {
-            subtrair_magnitudes(x_anterior, x, diferenca);
+            char pedaco[DIGITOS_POR_PEDACO_DECIMAL];
+            escrever_pedaco_decimal((uint32_t)r, pedaco);
+            memcpy(saida, pedaco + DIGITOS_POR_PEDACO_DECIMAL - pos, (size_t)pos);
+            pos = 0;
         }
-        
-        int pequena_diff = (diferenca->quantidade_blocos == 1 && diferenca->blocos[0] <= 1);
-        liberar_grande_numero(diferenca);
-        
-        if (pequena_diff) break;
     }
-    
-    copiar_grande_numero(resultado, x);
-    
-    liberar_grande_numero(x);
-    liberar_grande_numero(x_anterior);
-    liberar_grande_numero(div);
+    while (pos > 0) saida[--pos] = '0';
+
+    liberar_grande_numero(temp);
+}
+
+// Escreve N < 10^(9 * 2^(nivel+1)) em exatamente 9 * 2^(nivel+1) dígitos
+static void escrever_decimal_recursivo(const GrandeNumero *numero, int nivel, const TabelaPotenciasDez *tabela, char *saida) {
+    long quantidade = (long)DIGITOS_POR_PEDACO_DECIMAL << (nivel + 1);
+
+    if (nivel < 0 || numero->quantidade_blocos <= CONVERSAO_LIMIAR) {
+        escrever_decimal_tradicional(numero, saida, quantidade);
+        return;
+    }
+
+    GrandeNumero *alto = criar_grande_numero(1);
+    GrandeNumero *baixo = criar_grande_numero(1);
+    dividir_com_resto(numero, tabela->potencias[nivel], alto, baixo);
+
+    escrever_decimal_recursivo(alto, nivel - 1, tabela, saida);
+    liberar_grande_numero(alto);
+    escrever_decimal_recursivo(baixo, nivel - 1, tabela, saida + quantidade / 2);
+    liberar_grande_numero(baixo);
+}
+
+// Monta a tabela até o menor nível L com N < 10^(9 * 2^L) e devolve L
+static int montar_tabela_conversao(const GrandeNumero *numero, TabelaPotenciasDez *tabela) {
+    estender_tabela_potencias(tabela);
+    while (comparar_magnitude(numero, tabela->potencias[tabela->quantidade - 1]) >= 0) {
+        estender_tabela_potencias(tabela);
+    }
+    return tabela->quantidade - 1;
+}
+
+char* grande_numero_para_string(const GrandeNumero *numero) {
+    TabelaPotenciasDez tabela = { .quantidade = 0 };
+    int nivel_topo = montar_tabela_conversao(numero, &tabela);
+    long quantidade = (long)DIGITOS_POR_PEDACO_DECIMAL << nivel_topo;
+
+    char *digitos = (char*)malloc((size_t)quantidade + 2);
+    if (digitos == NULL) {
+        liberar_tabela_potencias(&tabela);
+        return NULL;
+    }
+
+    GrandeNumero magnitude = *numero;
+    magnitude.sinal = 1;
+    escrever_decimal_recursivo(&magnitude, nivel_topo - 1, &tabela, digitos + 1);
+    liberar_tabela_potencias(&tabela);
+
+    // Remover zeros à esquerda (mantendo ao menos um dígito) e colocar o sinal
+    long inicio = 1;
+    while (inicio < quantidade && digitos[inicio] == '0') inicio++;
+    long tamanho = quantidade + 1 - inicio;
+    int negativo = (numero->sinal < 0 && !eh_zero(numero));
+    if (negativo) digitos[0] = '-';
+    memmove(digitos + negativo, digitos + inicio, (size_t)tamanho);
+    digitos[negativo + tamanho] = '\0';
+    return digitos;
+}
+
+// --- SAÍDA DECIMAL EM FLUXO ---
+/*
+ * Para resultados enormes a string completa nunca é montada: a árvore de
+ * conversão é percorrida da parte alta para a baixa e cada subárvore que
+ * cabe em SAIDA_BLOCO_BYTES dígitos é convertida num rascunho e copiada para
+ * o buffer de saída (já com o ponto decimal no lugar). Buffers cheios vão
+ * para uma thread escritora enquanto o próximo trecho é convertido
+ * (buffer duplo), e todas as escritas têm o tamanho do bloco exceto a última.
+ *
+ * Ao atingir o limite de dígitos pedido, as subárvores restantes nem chegam
+ * a ser convertidas.
+ */
+
+#define SAIDA_BLOCO_BYTES (1 << 20)
+
+// Um número com até CONVERSAO_LIMIAR blocos de 32 bits tem no máximo
+// ~9.64 dígitos por bloco; esta largura sempre o comporta
+#define LARGURA_NUMERO_PEQUENO (CONVERSAO_LIMIAR * 10)
+
+typedef struct {
+    int fd;
+    char *buffers[2];
+    int atual;
+    size_t preenchido;
+    char *rascunho;                // Conversão de uma subárvore (SAIDA_BLOCO_BYTES)
+
+    long long digitos_inteiros;    // Dígitos antes do ponto (0 = sem ponto)
+    long long max_digitos;         // Limite de dígitos (< 0 = sem limite)
+    long long emitidos;
+    int iniciado;                  // Já passou dos zeros à esquerda
+    int concluido;                 // Limite atingido ou erro de escrita
+
+    pthread_t escritor;
+    pthread_mutex_t trava;
+    pthread_cond_t sinal;
+    char *pendente;
+    size_t tamanho_pendente;
+    int encerrar;
+    int erro;
+} FluxoDecimal;
+
+static int escrever_tudo(int fd, const char *dados, size_t tamanho) {
+    while (tamanho > 0) {
+        ssize_t escrito = write(fd, dados, tamanho);
+        if (escrito < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        dados += escrito;
+        tamanho -= (size_t)escrito;
+    }
+    return 0;
+}
+
+static void* laco_escritor(void *argumento) {
+    FluxoDecimal *fluxo = (FluxoDecimal*)argumento;
+
+    pthread_mutex_lock(&fluxo->trava);
+    for (;;) {
+        while (fluxo->pendente == NULL && !fluxo->encerrar) {
+            pthread_cond_wait(&fluxo->sinal, &fluxo->trava);
+        }
+        if (fluxo->pendente == NULL) break;
+
+        char *dados = fluxo->pendente;
+        size_t tamanho = fluxo->tamanho_pendente;
+        pthread_mutex_unlock(&fluxo->trava);
+        int falhou = escrever_tudo(fluxo->fd, dados, tamanho);
+        pthread_mutex_lock(&fluxo->trava);
+
+        if (falhou) fluxo->erro = 1;
+        fluxo->pendente = NULL;
+        pthread_cond_broadcast(&fluxo->sinal);
+    }
+    pthread_mutex_unlock(&fluxo->trava);
+    return NULL;
+}
+
+// Entrega o buffer atual à thread escritora e passa a preencher o outro
+static void enviar_buffer(FluxoDecimal *fluxo) {
+    if (fluxo->preenchido == 0) return;
+
+    pthread_mutex_lock(&fluxo->trava);
+    while (fluxo->pendente != NULL) pthread_cond_wait(&fluxo->sinal, &fluxo->trava);
+    if (fluxo->erro) fluxo->concluido = 1;
+    fluxo->pendente = fluxo->buffers[fluxo->atual];
+    fluxo->tamanho_pendente = fluxo->preenchido;
+    pthread_cond_broadcast(&fluxo->sinal);
+    pthread_mutex_unlock(&fluxo->trava);
+
+    fluxo->atual ^= 1;
+    fluxo->preenchido = 0;
+}
+
+static void colocar_bytes(FluxoDecimal *fluxo, const char *dados, size_t tamanho) {
+    while (tamanho > 0) {
+        size_t livre = SAIDA_BLOCO_BYTES - fluxo->preenchido;
+        size_t parte = (tamanho < livre) ? tamanho : livre;
+        memcpy(fluxo->buffers[fluxo->atual] + fluxo->preenchido, dados, parte);
+        fluxo->preenchido += parte;
+        dados += parte;
+        tamanho -= parte;
+        if (fluxo->preenchido == SAIDA_BLOCO_BYTES) enviar_buffer(fluxo);
+    }
+}
+
+// Acrescenta dígitos à saída: descarta zeros à esquerda, insere o ponto
+// decimal e respeita o limite de dígitos
+static void emitir_digitos(FluxoDecimal *fluxo, const char *digitos, long long quantidade) {
+    if (!fluxo->iniciado) {
+        while (quantidade > 0 && *digitos == '0') {
+            digitos++;
+            quantidade--;
+        }
+        if (quantidade == 0) return;
+        fluxo->iniciado = 1;
+    }
+
+    while (quantidade > 0 && !fluxo->concluido) {
+        if (fluxo->digitos_inteiros > 0 && fluxo->emitidos == fluxo->digitos_inteiros) {
+            colocar_bytes(fluxo, ".", 1);
+        }
+        long long parte = quantidade;
+        if (fluxo->max_digitos >= 0 && parte > fluxo->max_digitos - fluxo->emitidos) {
+            parte = fluxo->max_digitos - fluxo->emitidos;
+        }
+        if (fluxo->emitidos < fluxo->digitos_inteiros && parte > fluxo->digitos_inteiros - fluxo->emitidos) {
+            parte = fluxo->digitos_inteiros - fluxo->emitidos;
+        }
+        colocar_bytes(fluxo, digitos, (size_t)parte);
+        fluxo->emitidos += parte;
+        digitos += parte;
+        quantidade -= parte;
+        if (fluxo->max_digitos >= 0 && fluxo->emitidos >= fluxo->max_digitos) fluxo->concluido = 1;
+    }
+}
+
+static void emitir_zeros(FluxoDecimal *fluxo, long long quantidade) {
+    if (!fluxo->iniciado) return;
+    char zeros[4096];
+    memset(zeros, '0', sizeof(zeros));
+    while (quantidade > 0 && !fluxo->concluido) {
+        long long parte = (quantidade < (long long)sizeof(zeros)) ? quantidade : (long long)sizeof(zeros);
+        emitir_digitos(fluxo, zeros, parte);
+        quantidade -= parte;
+    }
+}
+
+// Emite N < 10^(9 * 2^(nivel+1)) em exatamente 9 * 2^(nivel+1) dígitos
+static void escrever_decimal_fluxo(const GrandeNumero *numero, int nivel, const TabelaPotenciasDez *tabela, FluxoDecimal *fluxo) {
+    if (fluxo->concluido) return;
+    long long quantidade = (long long)DIGITOS_POR_PEDACO_DECIMAL << (nivel + 1);
+
+    if (quantidade <= SAIDA_BLOCO_BYTES) {
+        escrever_decimal_recursivo(numero, nivel, tabela, fluxo->rascunho);
+        emitir_digitos(fluxo, fluxo->rascunho, quantidade);
+        return;
+    }
+    if (numero->quantidade_blocos <= CONVERSAO_LIMIAR) {
+        // Valor pequeno num campo largo: só zeros à esquerda e poucos dígitos
+        emitir_zeros(fluxo, quantidade - LARGURA_NUMERO_PEQUENO);
+        escrever_decimal_tradicional(numero, fluxo->rascunho, LARGURA_NUMERO_PEQUENO);
+        emitir_digitos(fluxo, fluxo->rascunho, LARGURA_NUMERO_PEQUENO);
+        return;
+    }
+
+    GrandeNumero *alto = criar_grande_numero(1);
+    GrandeNumero *baixo = criar_grande_numero(1);
+    dividir_com_resto(numero, tabela->potencias[nivel], alto, baixo);
+
+    escrever_decimal_fluxo(alto, nivel - 1, tabela, fluxo);
+    liberar_grande_numero(alto);
+    escrever_decimal_fluxo(baixo, nivel - 1, tabela, fluxo);
+    liberar_grande_numero(baixo);
+}
+
+long long escrever_grande_numero_fd(const GrandeNumero *numero, int fd, long long digitos_inteiros, long long max_digitos) {
+    FluxoDecimal fluxo;
+    memset(&fluxo, 0, sizeof(fluxo));
+    fluxo.fd = fd;
+    fluxo.digitos_inteiros = digitos_inteiros;
+    fluxo.max_digitos = max_digitos;
+
+    // Buffers alinhados à página: escritas grandes e sem cópias extras no kernel
+    void *memoria[3] = { NULL, NULL, NULL };
+    for (int i = 0; i < 3; i++) {
+        if (posix_memalign(&memoria[i], 4096, SAIDA_BLOCO_BYTES) != 0) {
+            for (int j = 0; j < i; j++) free(memoria[j]);
+            printf("ERRO: Falha ao alocar buffers de saída!\n");
+            return -1;
+        }
+    }
+    fluxo.buffers[0] = (char*)memoria[0];
+    fluxo.buffers[1] = (char*)memoria[1];
+    fluxo.rascunho = (char*)memoria[2];
+
+    pthread_mutex_init(&fluxo.trava, NULL);
+    pthread_cond_init(&fluxo.sinal, NULL);
+    if (pthread_create(&fluxo.escritor, NULL, laco_escritor, &fluxo) != 0) {
+        printf("ERRO: Falha ao criar a thread de escrita!\n");
+        pthread_mutex_destroy(&fluxo.trava);
+        pthread_cond_destroy(&fluxo.sinal);
+        for (int i = 0; i < 3; i++) free(memoria[i]);
+        return -1;
+    }
+
+    if (numero->sinal < 0 && !eh_zero(numero)) colocar_bytes(&fluxo, "-", 1);
+
+    TabelaPotenciasDez tabela = { .quantidade = 0 };
+    int nivel_topo = montar_tabela_conversao(numero, &tabela);
+    GrandeNumero magnitude = *numero;
+    magnitude.sinal = 1;
+    escrever_decimal_fluxo(&magnitude, nivel_topo - 1, &tabela, &fluxo);
+    liberar_tabela_potencias(&tabela);
+    if (!fluxo.iniciado) {
+        fluxo.iniciado = 1;
+        emitir_digitos(&fluxo, "0", 1);
+    }
+
+    // Último buffer (parcial) e espera da thread escritora
+    enviar_buffer(&fluxo);
+    pthread_mutex_lock(&fluxo.trava);
+    while (fluxo.pendente != NULL) pthread_cond_wait(&fluxo.sinal, &fluxo.trava);
+    fluxo.encerrar = 1;
+    pthread_cond_broadcast(&fluxo.sinal);
+    pthread_mutex_unlock(&fluxo.trava);
+    pthread_join(fluxo.escritor, NULL);
+
+    pthread_mutex_destroy(&fluxo.trava);
+    pthread_cond_destroy(&fluxo.sinal);
+    for (int i = 0; i < 3; i++) free(memoria[i]);
+
+    return fluxo.erro ? -1 : fluxo.emitidos;
+}
+
+// Lê 'quantidade' dígitos decimais de 'texto' (dividir-para-conquistar, inverso da conversão acima)
+static void ler_decimal_recursivo(GrandeNumero *numero, const char *texto, long quantidade, TabelaPotenciasDez *tabela) {
+    if (quantidade <= (long)DIGITOS_POR_PEDACO_DECIMAL * CONVERSAO_LIMIAR) {
+        definir_valor_inteiro(numero, 0);
+        long pos = 0;
+        while (pos < quantidade) {
+            int tamanho_pedaco = (int)((quantidade - pos) % DIGITOS_POR_PEDACO_DECIMAL);
+            if (tamanho_pedaco == 0 || pos > 0) tamanho_pedaco = DIGITOS_POR_PEDACO_DECIMAL;
+            int pedaco = 0, escala = 1;
+            for (int d = 0; d < tamanho_pedaco; d++) {
+                pedaco = pedaco * 10 + (texto[pos + d] - '0');
+                escala *= 10;
+            }
+            GrandeNumero *valor_pedaco = criar_grande_numero(1);
+            definir_valor_inteiro(valor_pedaco, pedaco);
+            multiplicar_por_inteiro(numero, escala, numero);
+            somar_magnitudes(numero, valor_pedaco, numero);
+            liberar_grande_numero(valor_pedaco);
+            pos += tamanho_pedaco;
+        }
+        return;
+    }
+
+    // Maior nível i com 9 * 2^i < quantidade: divide em alto * 10^(9*2^i) + baixo
+    int nivel = 0;
+    while (((long)DIGITOS_POR_PEDACO_DECIMAL << (nivel + 1)) < quantidade) nivel++;
+    while (tabela->quantidade <= nivel) estender_tabela_potencias(tabela);
+    long quantidade_baixa = (long)DIGITOS_POR_PEDACO_DECIMAL << nivel;
+
+    GrandeNumero *baixo = criar_grande_numero(1);
+    ler_decimal_recursivo(numero, texto, quantidade - quantidade_baixa, tabela);
+    ler_decimal_recursivo(baixo, texto + quantidade - quantidade_baixa, quantidade_baixa, tabela);
+    multiplicar_grandes_numeros(numero, tabela->potencias[nivel], numero);
+    somar_magnitudes(numero, baixo, numero);
+    liberar_grande_numero(baixo);
+}
+
+void definir_valor_string(GrandeNumero *numero, const char *valor_str) {
+    int sinal = 1;
+    if (*valor_str == '-' || *valor_str == '+') {
+        if (*valor_str == '-') sinal = -1;
+        valor_str++;
+    }
+
+    long quantidade = 0;
+    while (valor_str[quantidade] >= '0' && valor_str[quantidade] <= '9') quantidade++;
+
+    TabelaPotenciasDez tabela = { .quantidade = 0 };
+    ler_decimal_recursivo(numero, valor_str, quantidade, &tabela);
+    liberar_tabela_potencias(&tabela);
+
+    remover_zeros_a_esquerda(numero);
+    numero->sinal = eh_zero(numero) ? 1 : sinal;
 }
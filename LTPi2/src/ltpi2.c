@@ -1,28 +1,905 @@
 #include "ltpi2.h"
 #include "grandes_numeros.h"
+#include "tarefas.h"
+#include "numero_real.h"
+#include "cache_digitos.h"
+#include "formato_arquivos.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <unistd.h>
 
 // Constantes de Chudnovsky
 #define C 640320
 #define C3_OVER_24 10939058860032000L
 
+// Blocos de guarda do fechamento em ponto fixo: o erro acumulado das poucas
+// operações truncadas fica muito abaixo do último dígito pedido
+#define PI_BLOCOS_GUARDA 2
+
+// Fatoração esparsa de um inteiro: primos em ordem crescente e expoentes
+typedef struct {
+    int *primos;
+    int *expoentes;
+    int quantidade;
+    int capacidade;
+} Fatoracao;
+
 typedef struct {
     GrandeNumero *P;
     GrandeNumero *Q;
     GrandeNumero *T;
+    Fatoracao fatores_p;   // Só no modo com fatores (ver definir_modo_fatores)
+    Fatoracao fatores_q;
 } TermosBS;
 
+// Configuração do modo paralelo (ver definir_numero_threads)
+static int numero_threads = 1;
+static int grao_paralelo = 0;   // 0 = automático
+static int grao_em_uso = 0;     // Grão efetivo do cálculo em andamento
+
+void definir_numero_threads(int num_threads) {
+    numero_threads = (num_threads < 1) ? 1 : num_threads;
+}
+
+void definir_grao_paralelo(int termos) {
+    grao_paralelo = (termos < 0) ? 0 : termos;
+}
+
+// --- BINARY SPLITTING COM FATORES ---
+/*
+ * P e Q compartilham muitos fatores primos pequenos: P(k) = -(6k-5)(2k-1)(6k-1)
+ * e Q(k) = k^3 * C^3/24, com C^3/24 = 2^15 * 3^2 * 5^3 * 23^3 * 29^3. Sem
+ * tratamento, essa magnitude redundante sobe a árvore inteira.
+ *
+ * No modo com fatores cada nó guarda também a fatoração de P e Q (as folhas
+ * são fatoradas por um crivo de menor fator primo). No merge,
+ *   g = mdc(P_esq, Q_dir)
+ * é lido direto das fatorações e removido de ambos antes dos produtos:
+ *   P = (P_esq/g) P_dir,  Q = Q_esq (Q_dir/g),  T = T_esq (Q_dir/g) + (P_esq/g) T_dir
+ * o que divide P, Q e T por g e preserva as razões P/Q e T/Q usadas no final.
+ */
+
+static int modo_fatores = 0;
+static int *menor_fator = NULL;   // menor_fator[n] = menor primo que divide n
+static int limite_crivo = 0;
+
+void definir_modo_fatores(int ativo) {
+    modo_fatores = (ativo != 0);
+}
+
+static void construir_crivo(int limite) {
+    menor_fator = (int*)calloc((size_t)limite + 1, sizeof(int));
+    limite_crivo = limite;
+    for (int i = 2; i <= limite; i++) {
+        if (menor_fator[i] != 0) continue;
+        for (long long j = i; j <= limite; j += i) {
+            if (menor_fator[j] == 0) menor_fator[j] = i;
+        }
+    }
+}
+
+static void liberar_crivo(void) {
+    free(menor_fator);
+    menor_fator = NULL;
+    limite_crivo = 0;
+}
+
+static void reservar_fatoracao(Fatoracao *f, int capacidade) {
+    if (f->capacidade >= capacidade) return;
+    f->primos = (int*)realloc(f->primos, (size_t)capacidade * sizeof(int));
+    f->expoentes = (int*)realloc(f->expoentes, (size_t)capacidade * sizeof(int));
+    f->capacidade = capacidade;
+}
+
+static void liberar_fatoracao(Fatoracao *f) {
+    free(f->primos);
+    free(f->expoentes);
+    f->primos = NULL;
+    f->expoentes = NULL;
+    f->quantidade = 0;
+    f->capacidade = 0;
+}
+
+// f *= primo^expoente (as listas das folhas são curtas: inserção ordenada)
+static void adicionar_fator(Fatoracao *f, int primo, int expoente) {
+    int i = f->quantidade;
+    while (i > 0 && f->primos[i - 1] > primo) i--;
+    if (i > 0 && f->primos[i - 1] == primo) {
+        f->expoentes[i - 1] += expoente;
+        return;
+    }
+    reservar_fatoracao(f, f->quantidade + 8);
+    for (int j = f->quantidade; j > i; j--) {
+        f->primos[j] = f->primos[j - 1];
+        f->expoentes[j] = f->expoentes[j - 1];
+    }
+    f->primos[i] = primo;
+    f->expoentes[i] = expoente;
+    f->quantidade++;
+}
+
+// f *= n^vezes, fatorando n pelo crivo
+static void adicionar_numero(Fatoracao *f, int n, int vezes) {
+    while (n > 1) {
+        int primo = menor_fator[n];
+        int expoente = 0;
+        while (n % primo == 0) {
+            n /= primo;
+            expoente++;
+        }
+        adicionar_fator(f, primo, expoente * vezes);
+    }
+}
+
+// r = a * b (intercalação das listas ordenadas)
+static void combinar_fatoracoes(const Fatoracao *a, const Fatoracao *b, Fatoracao *r) {
+    reservar_fatoracao(r, a->quantidade + b->quantidade);
+    int i = 0, j = 0, k = 0;
+    while (i < a->quantidade || j < b->quantidade) {
+        if (j == b->quantidade || (i < a->quantidade && a->primos[i] < b->primos[j])) {
+            r->primos[k] = a->primos[i];
+            r->expoentes[k++] = a->expoentes[i++];
+        } else if (i == a->quantidade || b->primos[j] < a->primos[i]) {
+            r->primos[k] = b->primos[j];
+            r->expoentes[k++] = b->expoentes[j++];
+        } else {
+            r->primos[k] = a->primos[i];
+            r->expoentes[k++] = a->expoentes[i++] + b->expoentes[j++];
+        }
+    }
+    r->quantidade = k;
+}
+
+// mdc = mdc(a, b); a /= mdc; b /= mdc (primos com expoente zero saem da lista)
+static void remover_mdc_fatoracoes(Fatoracao *a, Fatoracao *b, Fatoracao *mdc) {
+    int tamanho_minimo = (a->quantidade < b->quantidade) ? a->quantidade : b->quantidade;
+    reservar_fatoracao(mdc, tamanho_minimo + 1);
+    mdc->quantidade = 0;
+
+    int i = 0, j = 0, ka = 0, kb = 0;
+    while (i < a->quantidade && j < b->quantidade) {
+        if (a->primos[i] < b->primos[j]) {
+            a->primos[ka] = a->primos[i];
+            a->expoentes[ka++] = a->expoentes[i++];
+        } else if (b->primos[j] < a->primos[i]) {
+            b->primos[kb] = b->primos[j];
+            b->expoentes[kb++] = b->expoentes[j++];
+        } else {
+            int comum = (a->expoentes[i] < b->expoentes[j]) ? a->expoentes[i] : b->expoentes[j];
+            mdc->primos[mdc->quantidade] = a->primos[i];
+            mdc->expoentes[mdc->quantidade++] = comum;
+            if (a->expoentes[i] > comum) {
+                a->primos[ka] = a->primos[i];
+                a->expoentes[ka++] = a->expoentes[i] - comum;
+            }
+            if (b->expoentes[j] > comum) {
+                b->primos[kb] = b->primos[j];
+                b->expoentes[kb++] = b->expoentes[j] - comum;
+            }
+            i++;
+            j++;
+        }
+    }
+    while (i < a->quantidade) {
+        a->primos[ka] = a->primos[i];
+        a->expoentes[ka++] = a->expoentes[i++];
+    }
+    while (j < b->quantidade) {
+        b->primos[kb] = b->primos[j];
+        b->expoentes[kb++] = b->expoentes[j++];
+    }
+    a->quantidade = ka;
+    b->quantidade = kb;
+}
+
+// r = produto dos fatores [inicio, fim) da lista, por árvore de produtos
+static void produto_fatores(const Fatoracao *f, int inicio, int fim, GrandeNumero *r) {
+    if (fim - inicio > 16) {
+        int meio = (inicio + fim) / 2;
+        GrandeNumero *direita = criar_grande_numero(1);
+        produto_fatores(f, inicio, meio, r);
+        produto_fatores(f, meio, fim, direita);
+        multiplicar_grandes_numeros(r, direita, r);
+        liberar_grande_numero(direita);
+        return;
+    }
+
+    // Poucos fatores: acumular potências num int e multiplicar por blocos
+    definir_valor_inteiro(r, 1);
+    int64_t acumulado = 1;
+    for (int i = inicio; i < fim; i++) {
+        for (int e = 0; e < f->expoentes[i]; e++) {
+            if (acumulado * f->primos[i] > INT32_MAX) {
+                multiplicar_por_inteiro(r, (int)acumulado, r);
+                acumulado = 1;
+            }
+            acumulado *= f->primos[i];
+        }
+    }
+    multiplicar_por_inteiro(r, (int)acumulado, r);
+}
+
+// Remove g = mdc(P_esq, Q_dir) dos dois operandos antes do merge
+static void remover_fatores_comuns(TermosBS *left, TermosBS *right) {
+    Fatoracao mdc = { 0 };
+    remover_mdc_fatoracoes(&left->fatores_p, &right->fatores_q, &mdc);
+    if (mdc.quantidade > 0) {
+        GrandeNumero *g = criar_grande_numero(1);
+        produto_fatores(&mdc, 0, mdc.quantidade, g);
+        dividir_exato(left->P, g, left->P);
+        dividir_exato(right->Q, g, right->Q);
+        liberar_grande_numero(g);
+    }
+    liberar_fatoracao(&mdc);
+}
+
+// Fatorações da folha k: P(k) = (6k-5)(2k-1)(6k-1) e Q(k) = k^3 * C^3/24
+static void fatorar_folha(int k, TermosBS *res) {
+    if (k == 0) return;
+    adicionar_numero(&res->fatores_p, 6 * k - 5, 1);
+    adicionar_numero(&res->fatores_p, 2 * k - 1, 1);
+    adicionar_numero(&res->fatores_p, 6 * k - 1, 1);
+
+    adicionar_numero(&res->fatores_q, k, 3);
+    adicionar_fator(&res->fatores_q, 2, 15);
+    adicionar_fator(&res->fatores_q, 3, 2);
+    adicionar_fator(&res->fatores_q, 5, 3);
+    adicionar_fator(&res->fatores_q, 23, 3);
+    adicionar_fator(&res->fatores_q, 29, 3);
+}
+
 void liberar_termos(TermosBS *t) {
     liberar_grande_numero(t->P);
     liberar_grande_numero(t->Q);
     liberar_grande_numero(t->T);
+    liberar_fatoracao(&t->fatores_p);
+    liberar_fatoracao(&t->fatores_q);
+}
+
+// Produto executado como tarefa do pool (usado nos merges em paralelo)
+typedef struct {
+    const GrandeNumero *a;
+    const GrandeNumero *b;
+    GrandeNumero *resultado;
+} ProdutoBS;
+
+static void executar_produto(void *argumento) {
+    ProdutoBS *produto = (ProdutoBS*)argumento;
+    multiplicar_grandes_numeros(produto->a, produto->b, produto->resultado);
+}
+
+// --- MERGE COM POUCA MEMÓRIA ---
+/*
+ * P só serve para os merges acima do nó: o P da raiz nunca é usado pelo
+ * fechamento, e um nó [a, N) da borda direita só entra como filho direito,
+ * cujo P só alimenta o P do pai. Nesses nós (fim_da_serie) o produto de P é
+ * pulado, e o P_dir que chega ao merge é descartado logo de início.
+ *
+ * No modo serial os produtos seguem a ordem que libera cada operando logo
+ * depois do seu último uso, e as saídas ocupam os objetos dos filhos já
+ * mortos (reaproveitar_grande_numero ajusta o buffer no lugar):
+ *   t2 = P_esq T_dir     novo                  (P morto: libera P_esq e P_dir)
+ *   T  = T_esq Q_dir     no objeto de T_dir
+ *   T += t2              no lugar              libera t2
+ *   Q  = Q_esq Q_dir     no objeto de T_esq    libera Q_dir
+ *   P  = P_esq P_dir     no objeto de Q_esq    libera P_esq e P_dir
+ * Com filhos de tamanho p (P) e q (Q, T), os números vivos no merge caem de
+ * ~5p + 11q (filhos, quatro produtos, t1 + t2 em T) para ~3p + 6q, e para
+ * ~2p + 6q na borda direita. No modo paralelo os produtos rodam juntos com
+ * saídas novas, e os filhos são liberados assim que todos terminam.
+ */
+
+// Último termo da série em andamento (0 = desconhecido: P sempre calculado)
+static int fim_da_serie = 0;
+
+static int p_necessario(int b) {
+    return b != fim_da_serie;
+}
+
+// destino = a * b, com o buffer de destino ajustado para 'capacidade' blocos
+static void multiplicar_em(const GrandeNumero *a, const GrandeNumero *b, GrandeNumero *destino, int capacidade) {
+    reaproveitar_grande_numero(destino, capacidade);
+    multiplicar_grandes_numeros(a, b, destino);
+}
+
+static int blocos_produto(const GrandeNumero *a, const GrandeNumero *b) {
+    return a->quantidade_blocos + b->quantidade_blocos;
+}
+
+static void liberar_e_anular(GrandeNumero **numero) {
+    liberar_grande_numero(*numero);
+    *numero = NULL;
+}
+
+static void combinar_serial(TermosBS *left, TermosBS *right, TermosBS *res, int calcular_p) {
+    if (!calcular_p) liberar_e_anular(&right->P);
+    GrandeNumero *t2 = criar_grande_numero(1);
+    multiplicar_em(left->P, right->T, t2, blocos_produto(left->P, right->T));
+    res->T = right->T;
+    right->T = NULL;
+    if (!calcular_p) liberar_e_anular(&left->P);
+
+    // T = T_esq Q_dir + t2, com espaço para o carry da soma
+    int blocos_t1 = blocos_produto(left->T, right->Q);
+    int blocos_t = ((blocos_t1 > t2->quantidade_blocos) ? blocos_t1 : t2->quantidade_blocos) + 1;
+    multiplicar_em(left->T, right->Q, res->T, blocos_t);
+    somar_grandes_numeros(res->T, t2, res->T);
+    liberar_grande_numero(t2);
+
+    res->Q = left->T;
+    left->T = NULL;
+    multiplicar_em(left->Q, right->Q, res->Q, blocos_produto(left->Q, right->Q));
+    liberar_e_anular(&right->Q);
+
+    if (calcular_p) {
+        res->P = left->Q;
+        left->Q = NULL;
+        multiplicar_em(left->P, right->P, res->P, blocos_produto(left->P, right->P));
+    } else {
+        res->P = NULL;
+    }
+}
+
+// Os produtos independentes viram tarefas; a própria thread calcula o último
+static void combinar_paralelo(TermosBS *left, TermosBS *right, TermosBS *res, int calcular_p) {
+    if (!calcular_p) liberar_e_anular(&right->P);
+    int blocos_t1 = blocos_produto(left->T, right->Q);
+    int blocos_t2 = blocos_produto(left->P, right->T);
+    res->T = criar_grande_numero(((blocos_t1 > blocos_t2) ? blocos_t1 : blocos_t2) + 1);
+    res->Q = criar_grande_numero(1);
+    res->P = calcular_p ? criar_grande_numero(1) : NULL;
+    GrandeNumero *t2 = criar_grande_numero(1);
+
+    ProdutoBS produtos[4] = {
+        { left->T, right->Q, res->T },   // T = T_left * Q_right + P_left * T_right
+        { left->P, right->T, t2 },
+        { left->Q, right->Q, res->Q },   // Q = Q_left * Q_right
+        { left->P, right->P, res->P },   // P = P_left * P_right
+    };
+    int quantidade = calcular_p ? 4 : 3;
+
+    Tarefa tarefas[3];
+    for (int i = 0; i < quantidade - 1; i++) tarefa_criar(&tarefas[i], executar_produto, &produtos[i]);
+    executar_produto(&produtos[quantidade - 1]);
+    for (int i = 0; i < quantidade - 1; i++) tarefa_aguardar(&tarefas[i]);
+
+    liberar_termos(left);
+    liberar_termos(right);
+    somar_grandes_numeros(res->T, t2, res->T);
+    liberar_grande_numero(t2);
+}
+
+// Merge: combina os termos de [a, m) e [m, b) nos termos de [a, b). Os
+// filhos são consumidos (seus números passam às saídas ou são liberados).
+static void combinar_termos(TermosBS *left, TermosBS *right, TermosBS *res, int calcular_p, int paralelo) {
+    if (modo_fatores) {
+        remover_fatores_comuns(left, right);
+        if (calcular_p) combinar_fatoracoes(&left->fatores_p, &right->fatores_p, &res->fatores_p);
+        combinar_fatoracoes(&left->fatores_q, &right->fatores_q, &res->fatores_q);
+    }
+    if (paralelo) {
+        combinar_paralelo(left, right, res, calcular_p);
+    } else {
+        combinar_serial(left, right, res, calcular_p);
+        liberar_termos(left);
+        liberar_termos(right);
+    }
+}
+
+// Relógio de parede monotônico, em segundos
+static double relogio_monotonico(void) {
+    struct timespec agora;
+    clock_gettime(CLOCK_MONOTONIC, &agora);
+    return (double)agora.tv_sec + (double)agora.tv_nsec * 1e-9;
+}
+
+// --- CHECKPOINT E RETOMADA DA SÉRIE ---
+/*
+ * Com um diretório de checkpoint configurado, subárvores concluídas da série
+ * são gravadas em arquivos bs_<a>_<b>.ltpc. Os termos de [a, b) só dependem
+ * de a e b (e do modo com fatores), então a retomada é a própria descida da
+ * árvore: um nó cujo arquivo existe é lido em vez de recalculado, e toda a
+ * subárvore abaixo dele é pulada.
+ *
+ * Formato (palavras de 32 bits, little-endian):
+ *   "LTPI" "CKPT" versão modo_fatores a b
+ *   P, Q, T             sinal (0/1), quantidade, blocos[quantidade]
+ *                       (P com quantidade 0: ausente, nó da borda direita)
+ *   fatores de P e Q    quantidade, primos[quantidade], expoentes[quantidade]
+ *   soma1, soma2        Fletcher de 64 bits das palavras anteriores (lo, hi)
+ * O arquivo estado.ltpc guarda o número de termos e a fase (série ou
+ * fechamento) do cálculo em andamento, no mesmo formato.
+ *
+ * Consistência em falhas: cada arquivo é escrito como .tmp, sincronizado
+ * com fsync e só então renomeado, de modo que um nome final sempre aponta
+ * para um arquivo completo; um arquivo corrompido é rejeitado pela soma e
+ * a subárvore é recalculada. Ao gravar um nó, os arquivos das subárvores
+ * contidas nele são removidos: o disco guarda só uma fronteira da árvore,
+ * da ordem do tamanho da raiz.
+ *
+ * Custo: a gravação para só a thread dona da subárvore, e a próxima só é
+ * permitida depois de um intervalo proporcional à duração da anterior, o
+ * que limita a parada a CHECKPOINT_FRACAO_MAXIMA do tempo de parede. A raiz
+ * é sempre gravada, marcando o início do fechamento.
+ */
+
+#define CHECKPOINT_VERSAO 1
+#define CHECKPOINT_MAGICA 0x4950544Cu            // "LTPI"
+#define CHECKPOINT_MAGICA_SUBARVORE 0x54504B43u  // "CKPT"
+#define CHECKPOINT_MAGICA_ESTADO 0x44545345u     // "ESTD"
+#define CHECKPOINT_TERMOS_MINIMOS 256            // Subárvores menores são baratas de recalcular
+#define CHECKPOINT_FRACAO_MAXIMA 0.03
+#define CHECKPOINT_PALAVRAS_BUFFER (1 << 18)     // 1 MiB por arquivo aberto
+#define CHECKPOINT_MAXIMO_BLOCOS (1u << 30)
+
+#define FASE_SERIE 0
+#define FASE_FECHAMENTO 1
+
+typedef struct {
+    int a;
+    int b;
+} SubarvoreSalva;
+
+static struct {
+    int ativo;
+    char diretorio[4096];
+    double intervalo;          // Espaço mínimo entre gravações, em segundos
+    double proxima;            // Relógio a partir do qual a próxima gravação é permitida
+    int gravando;              // Uma gravação opcional por vez
+    int termos;                // Raiz do cálculo em andamento
+    double tempo_gravando;
+    SubarvoreSalva *salvas;    // Arquivos válidos no diretório (fronteira atual)
+    int quantidade;
+    int capacidade;
+    pthread_mutex_t trava;
+} checkpoint = { .trava = PTHREAD_MUTEX_INITIALIZER };
+
+// Fluxo de palavras com conversão para little-endian e soma de Fletcher
+typedef struct {
+    int fd;
+    uint32_t *buffer;
+    size_t usadas;        // Escrita: palavras no buffer. Leitura: já consumidas
+    size_t disponiveis;   // Leitura: palavras válidas no buffer
+    SomaFletcher soma;
+    int erro;
+} FluxoPalavras;
+
+static int iniciar_fluxo(FluxoPalavras *f, int fd) {
+    memset(f, 0, sizeof(*f));
+    f->fd = fd;
+    f->buffer = (uint32_t*)malloc(CHECKPOINT_PALAVRAS_BUFFER * sizeof(uint32_t));
+    return (f->buffer != NULL) ? 0 : -1;
+}
+
+static void descarregar_fluxo(FluxoPalavras *f) {
+    const char *p = (const char*)f->buffer;
+    size_t bytes = f->usadas * sizeof(uint32_t);
+    while (bytes > 0 && !f->erro) {
+        ssize_t escritos = write(f->fd, p, bytes);
+        if (escritos < 0 && errno == EINTR) continue;
+        if (escritos <= 0) f->erro = 1;
+        else {
+            p += escritos;
+            bytes -= (size_t)escritos;
+        }
+    }
+    f->usadas = 0;
+}
+
+static void escrever_palavras(FluxoPalavras *f, const uint32_t *palavras, size_t n) {
+    while (n > 0) {
+        size_t lote = CHECKPOINT_PALAVRAS_BUFFER - f->usadas;
+        if (lote > n) lote = n;
+        uint32_t *destino = f->buffer + f->usadas;
+        soma_fletcher_acumular(&f->soma, palavras, lote);
+        for (size_t i = 0; i < lote; i++) destino[i] = PALAVRA_LE(palavras[i]);
+        f->usadas += lote;
+        palavras += lote;
+        n -= lote;
+        if (f->usadas == CHECKPOINT_PALAVRAS_BUFFER) descarregar_fluxo(f);
+    }
+}
+
+// Retorna 0, ou -1 se o arquivo acabou (ou falhou) antes de n palavras
+static int ler_palavras(FluxoPalavras *f, uint32_t *palavras, size_t n) {
+    while (n > 0) {
+        if (f->usadas == f->disponiveis) {
+            size_t bytes = 0, pedidos = CHECKPOINT_PALAVRAS_BUFFER * sizeof(uint32_t);
+            while (bytes < pedidos) {
+                ssize_t lidos = read(f->fd, (char*)f->buffer + bytes, pedidos - bytes);
+                if (lidos < 0 && errno == EINTR) continue;
+                if (lidos <= 0) break;
+                bytes += (size_t)lidos;
+            }
+            if (bytes == 0 || bytes % sizeof(uint32_t) != 0) return -1;
+            f->usadas = 0;
+            f->disponiveis = bytes / sizeof(uint32_t);
+        }
+        size_t lote = f->disponiveis - f->usadas;
+        if (lote > n) lote = n;
+        const uint32_t *origem = f->buffer + f->usadas;
+        for (size_t i = 0; i < lote; i++) palavras[i] = PALAVRA_LE(origem[i]);
+        soma_fletcher_acumular(&f->soma, palavras, lote);
+        f->usadas += lote;
+        palavras += lote;
+        n -= lote;
+    }
+    return 0;
+}
+
+// NULL é gravado como ausente (quantidade 0)
+static void escrever_numero(FluxoPalavras *f, const GrandeNumero *numero) {
+    uint32_t cabecalho[2] = { 0, 0 };
+    if (numero != NULL) {
+        cabecalho[0] = numero->sinal < 0;
+        cabecalho[1] = (uint32_t)numero->quantidade_blocos;
+    }
+    escrever_palavras(f, cabecalho, 2);
+    if (numero != NULL) escrever_palavras(f, numero->blocos, (size_t)numero->quantidade_blocos);
+}
+
+// Retorna 0 e o número (NULL se ausente e 'opcional'), ou -1
+static int ler_numero(FluxoPalavras *f, GrandeNumero **numero, int opcional) {
+    uint32_t cabecalho[2];
+    *numero = NULL;
+    if (ler_palavras(f, cabecalho, 2) != 0) return -1;
+    if (cabecalho[0] > 1 || cabecalho[1] > CHECKPOINT_MAXIMO_BLOCOS) return -1;
+    if (cabecalho[1] == 0) return (opcional && cabecalho[0] == 0) ? 0 : -1;
+    GrandeNumero *lido = criar_grande_numero((int)cabecalho[1]);
+    if (lido == NULL) return -1;
+    if (ler_palavras(f, lido->blocos, cabecalho[1]) != 0) {
+        liberar_grande_numero(lido);
+        return -1;
+    }
+    lido->quantidade_blocos = (int)cabecalho[1];
+    lido->sinal = cabecalho[0] ? -1 : 1;
+    *numero = lido;
+    return 0;
+}
+
+static void escrever_fatoracao(FluxoPalavras *f, const Fatoracao *fatoracao) {
+    uint32_t quantidade = (uint32_t)fatoracao->quantidade;
+    escrever_palavras(f, &quantidade, 1);
+    escrever_palavras(f, (const uint32_t*)fatoracao->primos, quantidade);
+    escrever_palavras(f, (const uint32_t*)fatoracao->expoentes, quantidade);
+}
+
+static int ler_fatoracao(FluxoPalavras *f, Fatoracao *fatoracao) {
+    uint32_t quantidade;
+    if (ler_palavras(f, &quantidade, 1) != 0 || quantidade > CHECKPOINT_MAXIMO_BLOCOS) return -1;
+    reservar_fatoracao(fatoracao, (int)quantidade + 1);
+    if (ler_palavras(f, (uint32_t*)fatoracao->primos, quantidade) != 0) return -1;
+    if (ler_palavras(f, (uint32_t*)fatoracao->expoentes, quantidade) != 0) return -1;
+    fatoracao->quantidade = (int)quantidade;
+    return 0;
+}
+
+// Anexa a soma e confere o que foi lido; retornam 0 em sucesso
+static void escrever_soma(FluxoPalavras *f) {
+    uint32_t soma[SOMA_FLETCHER_PALAVRAS];
+    soma_fletcher_exportar(&f->soma, soma);
+    escrever_palavras(f, soma, SOMA_FLETCHER_PALAVRAS);
+}
+
+static int conferir_soma(FluxoPalavras *f) {
+    uint32_t esperada[SOMA_FLETCHER_PALAVRAS], soma[SOMA_FLETCHER_PALAVRAS], extra;
+    soma_fletcher_exportar(&f->soma, esperada);
+    if (ler_palavras(f, soma, SOMA_FLETCHER_PALAVRAS) != 0) return -1;
+    if (ler_palavras(f, &extra, 1) == 0) return -1;   // Lixo depois da soma
+    return (memcmp(soma, esperada, sizeof(soma)) == 0) ? 0 : -1;
+}
+
+static void caminho_subarvore(char *caminho, size_t tamanho, const char *diretorio, int a, int b) {
+    if (a < 0) snprintf(caminho, tamanho, "%s/estado.ltpc", diretorio);
+    else snprintf(caminho, tamanho, "%s/bs_%d_%d.ltpc", diretorio, a, b);
+}
+
+static void caminho_checkpoint(char *caminho, size_t tamanho, int a, int b) {
+    caminho_subarvore(caminho, tamanho, checkpoint.diretorio, a, b);
+}
+
+static int abrir_gravacao(FluxoPalavras *f, const char *temporario) {
+    int fd = open(temporario, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return -1;
+    if (iniciar_fluxo(f, fd) != 0) {
+        close(fd);
+        unlink(temporario);
+        return -1;
+    }
+    return 0;
+}
+
+// Soma, fsync, rename e fsync do diretório: o nome final só aparece completo
+static int concluir_gravacao(FluxoPalavras *f, const char *temporario, const char *caminho) {
+    escrever_soma(f);
+    descarregar_fluxo(f);
+    free(f->buffer);
+    if (f->erro) {
+        close(f->fd);
+        unlink(temporario);
+        return -1;
+    }
+    return arquivo_publicar(f->fd, temporario, caminho);
+}
+
+static int gravar_subarvore(const char *diretorio, int a, int b, const TermosBS *termos) {
+    char caminho[4096 + 64], temporario[4096 + 68];
+    caminho_subarvore(caminho, sizeof(caminho), diretorio, a, b);
+    snprintf(temporario, sizeof(temporario), "%s.tmp", caminho);
+
+    FluxoPalavras f;
+    if (abrir_gravacao(&f, temporario) != 0) return -1;
+    uint32_t cabecalho[6] = { CHECKPOINT_MAGICA, CHECKPOINT_MAGICA_SUBARVORE, CHECKPOINT_VERSAO,
+                              (uint32_t)modo_fatores, (uint32_t)a, (uint32_t)b };
+    escrever_palavras(&f, cabecalho, 6);
+    escrever_numero(&f, termos->P);
+    escrever_numero(&f, termos->Q);
+    escrever_numero(&f, termos->T);
+    escrever_fatoracao(&f, &termos->fatores_p);
+    escrever_fatoracao(&f, &termos->fatores_q);
+    return concluir_gravacao(&f, temporario, caminho);
+}
+
+// Sem P no arquivo, só serve onde P não é necessário
+static int ler_subarvore(int a, int b, TermosBS *termos) {
+    char caminho[4096 + 64];
+    caminho_checkpoint(caminho, sizeof(caminho), a, b);
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0) return -1;
+    FluxoPalavras f;
+    if (iniciar_fluxo(&f, fd) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    uint32_t cabecalho[6];
+    int ok = (ler_palavras(&f, cabecalho, 6) == 0 &&
+              cabecalho[0] == CHECKPOINT_MAGICA && cabecalho[1] == CHECKPOINT_MAGICA_SUBARVORE &&
+              cabecalho[2] == CHECKPOINT_VERSAO && cabecalho[3] == (uint32_t)modo_fatores &&
+              cabecalho[4] == (uint32_t)a && cabecalho[5] == (uint32_t)b);
+    termos->P = termos->Q = termos->T = NULL;
+    ok = (ok && ler_numero(&f, &termos->P, !p_necessario(b)) == 0 &&
+          ler_numero(&f, &termos->Q, 0) == 0 &&
+          ler_numero(&f, &termos->T, 0) == 0 &&
+          ler_fatoracao(&f, &termos->fatores_p) == 0 &&
+          ler_fatoracao(&f, &termos->fatores_q) == 0 &&
+          conferir_soma(&f) == 0);
+    free(f.buffer);
+    close(fd);
+    if (!ok) {
+        liberar_termos(termos);
+        return -1;
+    }
+    return 0;
+}
+
+static int gravar_estado(int fase) {
+    char caminho[4096 + 64], temporario[4096 + 68];
+    caminho_checkpoint(caminho, sizeof(caminho), -1, -1);
+    snprintf(temporario, sizeof(temporario), "%s.tmp", caminho);
+
+    FluxoPalavras f;
+    if (abrir_gravacao(&f, temporario) != 0) return -1;
+    uint32_t estado[6] = { CHECKPOINT_MAGICA, CHECKPOINT_MAGICA_ESTADO, CHECKPOINT_VERSAO,
+                           (uint32_t)modo_fatores, (uint32_t)checkpoint.termos, (uint32_t)fase };
+    escrever_palavras(&f, estado, 6);
+    return concluir_gravacao(&f, temporario, caminho);
+}
+
+// Lê o estado gravado; retorna 0 e preenche termos/fase, ou -1 sem estado válido
+static int ler_estado(int *termos, int *fase) {
+    char caminho[4096 + 64];
+    caminho_checkpoint(caminho, sizeof(caminho), -1, -1);
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0) return -1;
+    FluxoPalavras f;
+    uint32_t estado[6];
+    int ok = (iniciar_fluxo(&f, fd) == 0 && ler_palavras(&f, estado, 6) == 0 && conferir_soma(&f) == 0 &&
+              estado[0] == CHECKPOINT_MAGICA && estado[1] == CHECKPOINT_MAGICA_ESTADO &&
+              estado[2] == CHECKPOINT_VERSAO);
+    free(f.buffer);
+    close(fd);
+    if (!ok) return -1;
+    *termos = (int)estado[4];
+    *fase = (int)estado[5];
+    return 0;
+}
+
+// Índice dos arquivos válidos (chamadas com a trava, exceto na configuração)
+static void registrar_subarvore(int a, int b) {
+    if (checkpoint.quantidade == checkpoint.capacidade) {
+        checkpoint.capacidade = checkpoint.capacidade ? 2 * checkpoint.capacidade : 64;
+        checkpoint.salvas = (SubarvoreSalva*)realloc(checkpoint.salvas, (size_t)checkpoint.capacidade * sizeof(SubarvoreSalva));
+    }
+    checkpoint.salvas[checkpoint.quantidade].a = a;
+    checkpoint.salvas[checkpoint.quantidade].b = b;
+    checkpoint.quantidade++;
+}
+
+// Remove do índice (e do disco) as subárvores contidas em [a, b), inclusive ela
+static void descartar_subarvores(int a, int b) {
+    char caminho[4096 + 64];
+    int mantidas = 0;
+    for (int i = 0; i < checkpoint.quantidade; i++) {
+        SubarvoreSalva s = checkpoint.salvas[i];
+        if (s.a >= a && s.b <= b) {
+            caminho_checkpoint(caminho, sizeof(caminho), s.a, s.b);
+            unlink(caminho);
+        } else {
+            checkpoint.salvas[mantidas++] = s;
+        }
+    }
+    checkpoint.quantidade = mantidas;
+}
+
+// Só o arquivo de [a, b), mantendo os das subárvores contidas nele
+static void esquecer_subarvore(int a, int b) {
+    char caminho[4096 + 64];
+    for (int i = 0; i < checkpoint.quantidade; i++) {
+        if (checkpoint.salvas[i].a == a && checkpoint.salvas[i].b == b) {
+            caminho_checkpoint(caminho, sizeof(caminho), a, b);
+            unlink(caminho);
+            checkpoint.salvas[i] = checkpoint.salvas[--checkpoint.quantidade];
+            return;
+        }
+    }
+}
+
+static int subarvore_salva(int a, int b) {
+    for (int i = 0; i < checkpoint.quantidade; i++) {
+        if (checkpoint.salvas[i].a == a && checkpoint.salvas[i].b == b) return 1;
+    }
+    return 0;
+}
+
+static int candidata_a_checkpoint(int a, int b) {
+    return checkpoint.ativo && (b - a >= CHECKPOINT_TERMOS_MINIMOS || (a == 0 && b == checkpoint.termos));
+}
+
+// Retomada: lê [a, b) se houver arquivo válido. Retorna 0 se os termos vieram do disco.
+static int retomar_subarvore(int a, int b, TermosBS *res) {
+    pthread_mutex_lock(&checkpoint.trava);
+    int salva = subarvore_salva(a, b);
+    pthread_mutex_unlock(&checkpoint.trava);
+    if (!salva) return -1;
+
+    if (ler_subarvore(a, b, res) == 0) return 0;
+    printf("AVISO: Checkpoint da subárvore [%d, %d) inválido; recalculando\n", a, b);
+    pthread_mutex_lock(&checkpoint.trava);
+    esquecer_subarvore(a, b);
+    pthread_mutex_unlock(&checkpoint.trava);
+    return -1;
+}
+
+// Grava [a, b) se o orçamento de tempo permitir (a raiz sempre é gravada)
+static void talvez_gravar_subarvore(int a, int b, const TermosBS *res) {
+    int raiz = (a == 0 && b == checkpoint.termos);
+    double inicio = relogio_monotonico();
+    pthread_mutex_lock(&checkpoint.trava);
+    int gravar = raiz || (!checkpoint.gravando && inicio >= checkpoint.proxima);
+    if (gravar) checkpoint.gravando++;
+    pthread_mutex_unlock(&checkpoint.trava);
+    if (!gravar) return;
+
+    int falhou = gravar_subarvore(checkpoint.diretorio, a, b, res);
+    if (falhou) printf("AVISO: Falha ao gravar checkpoint da subárvore [%d, %d) em '%s'\n", a, b, checkpoint.diretorio);
+    double fim = relogio_monotonico();
+
+    pthread_mutex_lock(&checkpoint.trava);
+    checkpoint.gravando--;
+    checkpoint.tempo_gravando += fim - inicio;
+    double espera = (fim - inicio) * (1.0 - CHECKPOINT_FRACAO_MAXIMA) / CHECKPOINT_FRACAO_MAXIMA;
+    checkpoint.proxima = fim + ((espera > checkpoint.intervalo) ? espera : checkpoint.intervalo);
+    if (!falhou) {
+        // Os arquivos das subárvores de [a, b) deixam de ser necessários
+        descartar_subarvores(a, b);
+        registrar_subarvore(a, b);
+    }
+    pthread_mutex_unlock(&checkpoint.trava);
+    if (raiz && !falhou) gravar_estado(FASE_FECHAMENTO);
+}
+
+int configurar_checkpoint(const char *diretorio, double intervalo_segundos, int retomar) {
+    if (diretorio == NULL || strlen(diretorio) >= sizeof(checkpoint.diretorio)) return -1;
+    DIR *dir = opendir(diretorio);
+    if (dir == NULL || access(diretorio, W_OK | X_OK) != 0) {
+        printf("ERRO: Diretório de checkpoint '%s' não permite criar arquivos\n", diretorio);
+        if (dir != NULL) closedir(dir);
+        return -1;
+    }
+    desativar_checkpoint();
+    strcpy(checkpoint.diretorio, diretorio);
+    checkpoint.intervalo = (intervalo_segundos > 0) ? intervalo_segundos : 0;
+
+    // Sem retomada, os arquivos antigos são removidos; com ela, indexados
+    // (a validação completa fica para a leitura). Temporários nunca valem.
+    char caminho[4096 + 300];
+    struct dirent *entrada;
+    while ((entrada = readdir(dir)) != NULL) {
+        int a, b, consumidos = 0;
+        const char *nome = entrada->d_name;
+        int eh_subarvore = (sscanf(nome, "bs_%d_%d.ltpc%n", &a, &b, &consumidos) == 2 && nome[consumidos] == '\0');
+        size_t tamanho = strlen(nome);
+        int eh_temporario = (strncmp(nome, "bs_", 3) == 0 || strncmp(nome, "estado.", 7) == 0) &&
+                            tamanho > 9 && strcmp(nome + tamanho - 9, ".ltpc.tmp") == 0;
+        if (eh_subarvore && retomar && a >= 0 && b > a) {
+            registrar_subarvore(a, b);
+        } else if (eh_subarvore || eh_temporario || (!retomar && strcmp(nome, "estado.ltpc") == 0)) {
+            snprintf(caminho, sizeof(caminho), "%s/%s", diretorio, nome);
+            unlink(caminho);
+        }
+    }
+    closedir(dir);
+    checkpoint.ativo = 1;
+    return checkpoint.quantidade;
+}
+
+void desativar_checkpoint(void) {
+    checkpoint.ativo = 0;
+    free(checkpoint.salvas);
+    checkpoint.salvas = NULL;
+    checkpoint.quantidade = 0;
+    checkpoint.capacidade = 0;
+}
+
+// Início da série: confere o estado anterior e registra a fase atual
+static void iniciar_checkpoint(int termos) {
+    if (!checkpoint.ativo) return;
+    int termos_anteriores, fase;
+    if (checkpoint.quantidade > 0 && ler_estado(&termos_anteriores, &fase) == 0 && termos_anteriores != termos) {
+        // As subárvores continuam válidas (só dependem de [a, b)), mas a árvore
+        // de outro tamanho reaproveita poucas delas (e as da borda direita
+        // antiga, gravadas sem P, são recalculadas)
+        printf("AVISO: Checkpoint em '%s' é de um cálculo com %d termos (atual: %d)\n",
+               checkpoint.diretorio, termos_anteriores, termos);
+    }
+    checkpoint.termos = termos;
+    checkpoint.tempo_gravando = 0;
+    checkpoint.gravando = 0;
+    checkpoint.proxima = relogio_monotonico() + checkpoint.intervalo;
+    if (!subarvore_salva(0, termos) && gravar_estado(FASE_SERIE) != 0) {
+        printf("AVISO: Falha ao gravar o estado do checkpoint em '%s'\n", checkpoint.diretorio);
+    }
+}
+
+// Cálculo concluído: os arquivos não servem mais
+static void encerrar_checkpoint(void) {
+    if (!checkpoint.ativo) return;
+    char caminho[4096 + 64];
+    descartar_subarvores(0, INT_MAX);
+    caminho_checkpoint(caminho, sizeof(caminho), -1, -1);
+    unlink(caminho);
+}
+
+void binary_splitting(int a, int b, TermosBS *res);
+
+// Subárvore [a, b) executada como tarefa do pool
+typedef struct {
+    int a;
+    int b;
+    TermosBS *res;
+} IntervaloBS;
+
+static void executar_binary_splitting(void *argumento) {
+    IntervaloBS *intervalo = (IntervaloBS*)argumento;
+    binary_splitting(intervalo->a, intervalo->b, intervalo->res);
 }
 
 // Binary Splitting
 void binary_splitting(int a, int b, TermosBS *res) {
+    Fatoracao vazia = { 0 };
+    res->fatores_p = vazia;
+    res->fatores_q = vazia;
+    if (candidata_a_checkpoint(a, b) && retomar_subarvore(a, b, res) == 0) return;
+
     if (b - a == 1) {
         // Caso base: k = a
         // P(a, a+1) = -(6a - 5)(2a - 1)(6a - 1)
@@ -32,6 +909,7 @@ void binary_splitting(int a, int b, TermosBS *res) {
         res->P = criar_grande_numero(1);
         res->Q = criar_grande_numero(1);
         res->T = criar_grande_numero(1);
+        if (modo_fatores) fatorar_folha(a, res);
 
         if (a == 0) {
             definir_valor_inteiro(res->P, 1);
@@ -42,9 +920,8 @@ void binary_splitting(int a, int b, TermosBS *res) {
         } else {
             // P = -(6a-5)(2a-1)(6a-1)
             int64_t val_p = -((int64_t)(6*a - 5) * (2*a - 1) * (6*a - 1));
-            // Como val_p é negativo, vamos usar definir_valor_inteiro com abs e setar sinal
-            definir_valor_inteiro(res->P, (val_p < 0 ? -val_p : val_p));
-            res->P->sinal = (val_p < 0 ? -1 : 1);
+            // val_p passa de 2^31 já para a ~ 300, então usa o setter de 64 bits
+            definir_valor_inteiro64(res->P, val_p);
 
             // Q = C3_OVER_24 * a^3
             // Cuidado com overflow de int64 se a for grande (7000^3 * 10^16 excede 2^63)
@@ -90,159 +967,782 @@ void binary_splitting(int a, int b, TermosBS *res) {
     int m = (a + b) / 2;
     TermosBS left, right;
     
-    binary_splitting(a, m, &left);
-    binary_splitting(m, b, &right);
+    // Modo paralelo: a subárvore esquerda vira uma tarefa que outra thread pode
+    // roubar enquanto esta thread calcula a direita. Abaixo do grão, serial.
+    int paralelo = pool_tarefas_ativo() && (b - a) > grao_em_uso;
+    if (paralelo) {
+        Tarefa tarefa_esquerda;
+        IntervaloBS intervalo = { a, m, &left };
+        tarefa_criar(&tarefa_esquerda, executar_binary_splitting, &intervalo);
+        binary_splitting(m, b, &right);
+        tarefa_aguardar(&tarefa_esquerda);
+    } else {
+        binary_splitting(a, m, &left);
+        binary_splitting(m, b, &right);
+    }
 
-    // Merge
-    // P = P_left * P_right
-    res->P = criar_grande_numero(1);
-    multiplicar_grandes_numeros(left.P, right.P, res->P);
+    combinar_termos(&left, &right, res, p_necessario(b), paralelo);
+    if (candidata_a_checkpoint(a, b)) talvez_gravar_subarvore(a, b, res);
+}
 
-    // Q = Q_left * Q_right
-    res->Q = criar_grande_numero(1);
-    multiplicar_grandes_numeros(left.Q, right.Q, res->Q);
+// Tempos por fase do último cálculo (ver obter_tempos_pi)
+static TemposPi tempos_ultimo_pi;
 
-    // T = T_left * Q_right + P_left * T_right
-    GrandeNumero *t1 = criar_grande_numero(1);
-    multiplicar_grandes_numeros(left.T, right.Q, t1);
-    
-    GrandeNumero *t2 = criar_grande_numero(1);
-    multiplicar_grandes_numeros(left.P, right.T, t2);
-    
-    res->T = criar_grande_numero(1);
-    somar_grandes_numeros(t1, t2, res->T);
+void obter_tempos_pi(TemposPi *tempos) {
+    *tempos = tempos_ultimo_pi;
+}
 
-    liberar_grande_numero(t1);
-    liberar_grande_numero(t2);
-    liberar_termos(&left);
-    liberar_termos(&right);
+// Picos de memória por fase do último cálculo (ver obter_memoria_pi)
+static MemoriaPi memoria_ultimo_pi;
+
+void obter_memoria_pi(MemoriaPi *memoria) {
+    *memoria = memoria_ultimo_pi;
 }
 
-char* calcular_pi(int digitos) {
+static void iniciar_medicao_memoria(void) {
+    memset(&memoria_ultimo_pi, 0, sizeof(memoria_ultimo_pi));
+    armazenamento_reiniciar_picos();
+}
+
+// Fim de uma fase: retorna o pico dela e começa a medir a próxima
+static size_t encerrar_fase_memoria(void) {
+    size_t pico = armazenamento_pico_memoria();
+    size_t disco = armazenamento_pico_disco();
+    if (pico > memoria_ultimo_pi.total) memoria_ultimo_pi.total = pico;
+    if (disco > memoria_ultimo_pi.disco) memoria_ultimo_pi.disco = disco;
+    armazenamento_reiniciar_picos();
+    return pico;
+}
+
+// Modo paralelo: o pool fica ativo durante todo o cálculo e a conversão
+// (a árvore usa tarefas por subárvore e a NTT calcula os três primos em paralelo)
+static void iniciar_paralelismo(int termos) {
+    if (numero_threads > 1) {
+        grao_em_uso = grao_paralelo;
+        if (grao_em_uso == 0) {
+            // Automático: ~16 subárvores por thread para balancear a carga
+            grao_em_uso = termos / (numero_threads * 16);
+            if (grao_em_uso < 16) grao_em_uso = 16;
+        }
+        iniciar_pool_tarefas(numero_threads);
+    }
+}
+
+// Pi * 10^digitos, truncado para inteiro (314159...)
+static GrandeNumero* escalar_decimal(NumeroReal *pi, int digitos, int precisao) {
+    GrandeNumero *escala = criar_grande_numero(1);
+    NumeroReal *fator = criar_numero_real();
+    potencia_inteira(10, digitos, escala);
+    real_de_grande_numero(fator, escala, precisao);
+    real_multiplicar(pi, fator, pi, precisao);
+    real_parte_inteira(pi, escala);
+    liberar_numero_real(fator);
+    return escala;
+}
+
+// Calcula Pi * 10^digitos truncado, como inteiro grande (314159...)
+static GrandeNumero* calcular_pi_escalado(int digitos) {
     // Chudnovsky: Pi = (Q * 426880 * sqrt(10005)) / T
-    // Precisamos de precisão extra para evitar erro de arredondamento
-    int termos = digitos / 14 + 1;
-    
+    int termos = PI_TERMOS_PARA_DIGITOS(digitos);
+
+    double inicio = relogio_monotonico();
+    iniciar_medicao_memoria();
     TermosBS final;
+    if (modo_fatores) construir_crivo(6 * termos);
+    iniciar_checkpoint(termos);
+    fim_da_serie = termos;
     binary_splitting(0, termos, &final);
+    fim_da_serie = 0;
+    if (modo_fatores) liberar_crivo();
+    double fim_serie = relogio_monotonico();
+    tempos_ultimo_pi.serie = fim_serie - inicio;
+    tempos_ultimo_pi.checkpoint = checkpoint.tempo_gravando;
+    tempos_ultimo_pi.cache = 0;
+    memoria_ultimo_pi.serie = encerrar_fase_memoria();
+
+    // Q e T saem da árvore com bem mais bits do que os dígitos pedidos; o
+    // fechamento roda em ponto fixo com a precisão de trabalho, lendo só os
+    // blocos mais significativos de cada um
+    int precisao = precisao_para_digitos(digitos) + PI_BLOCOS_GUARDA;
+
+    // sqrt(10005)
+    NumeroReal *raiz = criar_numero_real();
+    real_de_inteiro(raiz, 10005);
+    real_raiz_quadrada(raiz, raiz, precisao);
 
     // Numerador = Q * 426880 * sqrt(10005)
-    // Mas precisamos escalar para ter os dígitos inteiros.
-    // Pi * 10^k = ...
-    // Vamos calcular (Q * 426880 * sqrt(10005 * 10^(2k))) / T
-    
-    // 1. Calcular sqrt(10005 * 10^(2*digitos))
-    GrandeNumero *raiz = criar_grande_numero(1);
-    GrandeNumero *base_raiz = criar_grande_numero(1);
-    definir_valor_inteiro(base_raiz, 10005);
-    
-    // Escalar base_raiz por 10^(2*digitos)
-    // Isso é muito lento multiplicando por 10 repetidamente.
-    // Melhor: criar número com blocos certos.
-    // 10^9 por bloco.
-    // 2*digitos / 9 blocos.
-    // int blocos_extra = (2 * digitos) / 9 + 1;
-    // Maneira rápida: criar array de blocos e setar.
-    // Mas minha API é limitada.
-    // Vou usar multiplicação por potências de 10 é lento?
-    // Não, vou hackear a estrutura ou fazer loop eficiente.
-    // Loop de multiplicação por 10^9 (BASE_NUMERICA) é apenas shift de blocos.
-    // Vou adicionar uma função 'shift_blocos' no grandes_numeros.c se pudesse, mas não posso editar agora facilmente sem reescrever.
-    // Vou usar o fato de que multiplicar por BASE_NUMERICA é adicionar um bloco zero.
-    // Mas não tenho essa função exposta.
-    // Vou usar 'multiplicar_por_inteiro' com BASE_NUMERICA repetidamente?
-    // Não, isso é O(N^2) no total.
-    // Melhor: criar um GrandeNumero que representa 10^(2*digitos) e multiplicar.
-    // Criar 10^(2*digitos) é fácil: 1 seguido de zeros.
-    // Mas como setar isso eficientemente?
-    // Vou fazer um loop de 'multiplicar_por_inteiro(..., BASE_NUMERICA, ...)'?
-    // Sim, é o que tenho.
-    
-    // Espera, 100k digitos. 200k zeros. ~22k blocos.
-    // Multiplicar por BASE_NUMERICA 22k vezes é muito lento se for O(N).
-    // Total O(N^2).
-    // Preciso de um jeito mais rápido de shiftar.
-    // Vou assumir que posso acessar a struct (está no header).
-    // Sim, a struct está no header! Posso manipular diretamente.
-    
-    // Escalar base_raiz por 10^(2*digitos)
-    // Fazemos isso multiplicando por BASE_NUMERICA (10^9) repetidamente
-    // e depois multiplicando pelo resto da potência de 10
-    
-    int num_blocos_shift = (2 * digitos) / 9;
-    int zeros_restantes = (2 * digitos) % 9;
-    
-    // Multiplicar por 10^(zeros_restantes) primeiro (número pequeno)
-    if (zeros_restantes > 0) {
-        int pot10 = 1;
-        for(int k = 0; k < zeros_restantes; k++) pot10 *= 10;
-        multiplicar_por_inteiro(base_raiz, pot10, base_raiz);
+    NumeroReal *numerador = criar_numero_real();
+    real_de_grande_numero(numerador, final.Q, precisao);
+    real_multiplicar_por_inteiro(numerador, 426880, numerador);
+    real_multiplicar(numerador, raiz, numerador, precisao);
+
+    // Pi = Numerador / T
+    NumeroReal *pi = criar_numero_real();
+    real_de_grande_numero(pi, final.T, precisao);
+    real_dividir(numerador, pi, pi, precisao);
+    liberar_termos(&final);
+
+    GrandeNumero *escala = escalar_decimal(pi, digitos, precisao);
+    liberar_numero_real(raiz);
+    liberar_numero_real(numerador);
+    liberar_numero_real(pi);
+    encerrar_checkpoint();
+    tempos_ultimo_pi.fechamento = relogio_monotonico() - fim_serie;
+    memoria_ultimo_pi.fechamento = encerrar_fase_memoria();
+    return escala;
+}
+
+// "3." seguido dos dígitos, convertidos e escritos em fluxo. Retorna 0, ou
+// -1 se a escrita falhou ou parou antes do fim.
+static int calcular_pi_em_fd(int digitos, int fd) {
+    double inicio = relogio_monotonico();
+    iniciar_paralelismo(PI_TERMOS_PARA_DIGITOS(digitos));
+    GrandeNumero *pi = calcular_pi_escalado(digitos);
+
+    double inicio_conversao = relogio_monotonico();
+    long long escritos = escrever_grande_numero_fd(pi, fd, 1, (long long)digitos + 1);
+    tempos_ultimo_pi.conversao = relogio_monotonico() - inicio_conversao;
+    memoria_ultimo_pi.conversao = encerrar_fase_memoria();
+
+    liberar_grande_numero(pi);
+    finalizar_pool_tarefas();
+    tempos_ultimo_pi.total = relogio_monotonico() - inicio;
+    return (escritos == (long long)digitos + 1) ? 0 : -1;
+}
+
+// --- SÉRIE EM VÁRIOS PROCESSOS ---
+/*
+ * A série pode ser dividida entre processos independentes (na mesma máquina
+ * ou em várias, com um diretório compartilhado). Cada fatia é um nó da
+ * própria árvore do binary_splitting — a raiz é dividida ao meio (m = (a+b)/2)
+ * até haver uma folha por fatia, com metade das fatias de cada lado — e o
+ * trabalhador grava seus P, Q e T no formato dos checkpoints de subárvore
+ * (bs_<a>_<b>.ltpc: palavras little-endian, fatorações no modo com fatores,
+ * soma de verificação), escrito em .tmp e renomeado.
+ *
+ * Como os arquivos das fatias são checkpoints válidos da árvore de N
+ * termos, a combinação é a retomada: a descida a partir da raiz lê cada
+ * fatia em vez de calculá-la, os merges acima delas rodam normalmente (com
+ * as threads do processo combinador) e o fechamento e a conversão seguem
+ * como num cálculo comum. A fatia da borda direita é gravada sem P, como
+ * no checkpoint. Com um número de fatias potência de 2 elas têm o mesmo
+ * tamanho; com outros, até o dobro umas das outras.
+ */
+
+int faixa_fatia_pi(int digitos, int fatias, int indice, int *inicio, int *fim) {
+    int a = 0, b = PI_TERMOS_PARA_DIGITOS(digitos);
+    if (fatias < 1 || indice < 0 || indice >= fatias) return -1;
+    while (fatias > 1) {
+        int m = (a + b) / 2, esquerda = fatias / 2;
+        if (indice < esquerda) {
+            b = m;
+            fatias = esquerda;
+        } else {
+            a = m;
+            indice -= esquerda;
+            fatias -= esquerda;
+        }
     }
-    
-    // Agora multiplicar por BASE_NUMERICA num_blocos_shift vezes
-    // Isso é equivalente a shiftar blocos, mas usa a API pública
-    for (int i = 0; i < num_blocos_shift; i++) {
-        multiplicar_por_inteiro(base_raiz, BASE_NUMERICA, base_raiz);
+    // Nós menores que isso não são lidos na retomada (candidata_a_checkpoint)
+    if (b - a < CHECKPOINT_TERMOS_MINIMOS && !(a == 0 && b == PI_TERMOS_PARA_DIGITOS(digitos))) return -1;
+    *inicio = a;
+    *fim = b;
+    return 0;
+}
+
+int calcular_fatia_pi(int digitos, int fatias, int indice, const char *diretorio) {
+    int termos = PI_TERMOS_PARA_DIGITOS(digitos);
+    int a, b;
+    if (diretorio == NULL || strlen(diretorio) >= sizeof(checkpoint.diretorio)) return -1;
+    if (faixa_fatia_pi(digitos, fatias, indice, &a, &b) != 0) {
+        printf("ERRO: Fatia %d de %d inválida para %d termos (mínimo de %d termos por fatia)\n",
+               indice, fatias, termos, CHECKPOINT_TERMOS_MINIMOS);
+        return -1;
     }
-    
-    raiz_quadrada(base_raiz, raiz);
-    
-    // Numerador = Q * 426880 * raiz
-    GrandeNumero *numerador = criar_grande_numero(1);
-    multiplicar_por_inteiro(final.Q, 426880, numerador);
-    multiplicar_grandes_numeros(numerador, raiz, numerador);
-    
-    // Divisão final: Pi = Numerador / T
-    GrandeNumero *pi = criar_grande_numero(1);
-    dividir_grande_numero(numerador, final.T, pi);
-    
+
+    // O trabalhador não grava checkpoints próprios: a fatia inteira é o arquivo
+    int checkpoint_ativo = checkpoint.ativo;
+    checkpoint.ativo = 0;
+    memset(&tempos_ultimo_pi, 0, sizeof(tempos_ultimo_pi));
+    double inicio = relogio_monotonico();
+    iniciar_paralelismo(b - a);
+    iniciar_medicao_memoria();
+    TermosBS res;
+    if (modo_fatores) construir_crivo(6 * b);
+    fim_da_serie = termos;
+    binary_splitting(a, b, &res);
+    fim_da_serie = 0;
+    if (modo_fatores) liberar_crivo();
+    finalizar_pool_tarefas();
+    tempos_ultimo_pi.serie = relogio_monotonico() - inicio;
+    memoria_ultimo_pi.serie = encerrar_fase_memoria();
+    checkpoint.ativo = checkpoint_ativo;
+
+    double inicio_gravacao = relogio_monotonico();
+    int falhou = gravar_subarvore(diretorio, a, b, &res);
+    liberar_termos(&res);
+    tempos_ultimo_pi.checkpoint = relogio_monotonico() - inicio_gravacao;
+    tempos_ultimo_pi.total = relogio_monotonico() - inicio;
+    if (falhou) {
+        printf("ERRO: Falha ao gravar a fatia [%d, %d) em '%s'\n", a, b, diretorio);
+        return -1;
+    }
+    return 0;
+}
+
+int conferir_fatias_pi(int digitos, int fatias, const char *diretorio) {
+    int faltando = 0;
+    char caminho[4096 + 64];
+    for (int i = 0; i < fatias; i++) {
+        int a, b;
+        if (faixa_fatia_pi(digitos, fatias, i, &a, &b) != 0) return -1;
+
+        // Só o cabeçalho: a soma é conferida na leitura, durante a combinação
+        caminho_subarvore(caminho, sizeof(caminho), diretorio, a, b);
+        int fd = open(caminho, O_RDONLY);
+        FluxoPalavras f;
+        uint32_t cabecalho[6];
+        int ok = (fd >= 0 && iniciar_fluxo(&f, fd) == 0);
+        if (ok) {
+            ok = (ler_palavras(&f, cabecalho, 6) == 0 &&
+                  cabecalho[0] == CHECKPOINT_MAGICA && cabecalho[1] == CHECKPOINT_MAGICA_SUBARVORE &&
+                  cabecalho[2] == CHECKPOINT_VERSAO && cabecalho[3] == (uint32_t)modo_fatores &&
+                  cabecalho[4] == (uint32_t)a && cabecalho[5] == (uint32_t)b);
+            free(f.buffer);
+        }
+        if (fd >= 0) close(fd);
+        if (!ok) {
+            printf("AVISO: Fatia %d de %d (termos [%d, %d)) ausente ou incompatível em '%s'\n",
+                   i, fatias, a, b, diretorio);
+            faltando++;
+        }
+    }
+    return faltando;
+}
+
+int combinar_fatias_pi(int digitos, int fatias, const char *diretorio, int fd) {
+    int faltando = conferir_fatias_pi(digitos, fatias, diretorio);
+    if (faltando != 0) {
+        if (faltando > 0) printf("ERRO: %d de %d fatias faltando em '%s'\n", faltando, fatias, diretorio);
+        else printf("ERRO: %d fatias não servem para %d termos\n", fatias, PI_TERMOS_PARA_DIGITOS(digitos));
+        return -1;
+    }
+    if (configurar_checkpoint(diretorio, 0, 1) < 0) return -1;
+    int resultado = calcular_pi_em_fd(digitos, fd);
+    desativar_checkpoint();
+    return resultado;
+}
+
+// --- CACHE DE DÍGITOS ---
+/*
+ * Com um cache configurado (configurar_cache_digitos), calcular_pi e
+ * calcular_pi_fd primeiro tentam mapear as casas pedidas do arquivo de
+ * cache: se ele já tem N >= n casas, o pedido custa a leitura de n bytes
+ * (conferidos pelas somas dos blocos) e nenhuma conta. Senão Pi é calculado
+ * com n casas direto num arquivo novo, em fluxo, que substitui o cache
+ * (estendendo-o de N para n) e então serve o pedido. Os dígitos de um
+ * cálculo com n casas são o prefixo dos de qualquer cálculo maior, pois
+ * ambos são truncamentos de Pi.
+ */
+
+static struct {
+    int ativo;
+    char caminho[4096];
+} cache;
+
+int configurar_cache_digitos(const char *caminho) {
+    if (caminho == NULL || strlen(caminho) >= sizeof(cache.caminho)) return -1;
+    long long disponiveis = cache_digitos_disponiveis(caminho);
+    if (disponiveis < 0) {
+        printf("AVISO: Cache de dígitos '%s' inválido; será substituído no próximo cálculo\n", caminho);
+        disponiveis = 0;
+    }
+    strcpy(cache.caminho, caminho);
+    cache.ativo = 1;
+    return (disponiveis > INT_MAX) ? INT_MAX : (int)disponiveis;
+}
+
+void desativar_cache_digitos(void) {
+    cache.ativo = 0;
+}
+
+// Mapeia 'digitos' casas do cache, calculando e trocando o arquivo se ele
+// tem menos. Retorna 0, ou -1 se o cache não pôde ser lido nem gravado.
+static int mapear_do_cache(int digitos, VisaoDigitosPi *visao) {
+    double inicio = relogio_monotonico();
+    if (cache_digitos_mapear(cache.caminho, digitos, visao) == 0) {
+        memset(&tempos_ultimo_pi, 0, sizeof(tempos_ultimo_pi));
+        memset(&memoria_ultimo_pi, 0, sizeof(memoria_ultimo_pi));
+        tempos_ultimo_pi.cache = relogio_monotonico() - inicio;
+        return 0;
+    }
+    // Um cache corrompido é recalculado com todas as casas que tinha
+    long long disponiveis = cache_digitos_disponiveis(cache.caminho);
+    int alvo = digitos;
+    if (disponiveis >= digitos) {
+        printf("AVISO: Cache de dígitos '%s' corrompido; recalculando\n", cache.caminho);
+        if (disponiveis <= INT_MAX) alvo = (int)disponiveis;
+    }
+
+    GravacaoCacheDigitos gravacao;
+    if (cache_digitos_iniciar_gravacao(cache.caminho, &gravacao) != 0) {
+        printf("AVISO: Não foi possível gravar o cache de dígitos '%s'; calculando sem ele\n", cache.caminho);
+        return -1;
+    }
+    if (calcular_pi_em_fd(alvo, gravacao.fd) != 0) {
+        cache_digitos_abandonar_gravacao(&gravacao);
+        printf("AVISO: Falha ao escrever o cache de dígitos '%s'; calculando sem ele\n", cache.caminho);
+        return -1;
+    }
+    double inicio_cache = relogio_monotonico();
+    if (cache_digitos_concluir_gravacao(&gravacao, alvo) != 0 ||
+        cache_digitos_mapear(cache.caminho, digitos, visao) != 0) {
+        printf("AVISO: Falha ao concluir o cache de dígitos '%s'; calculando sem ele\n", cache.caminho);
+        return -1;
+    }
+    tempos_ultimo_pi.cache = relogio_monotonico() - inicio_cache;
+    return 0;
+}
+
+static int escrever_texto(int fd, const char *texto, size_t tamanho) {
+    while (tamanho > 0) {
+        ssize_t escritos = write(fd, texto, tamanho);
+        if (escritos < 0 && errno == EINTR) continue;
+        if (escritos <= 0) return -1;
+        texto += escritos;
+        tamanho -= (size_t)escritos;
+    }
+    return 0;
+}
+
+char* calcular_pi(int digitos) {
+    double inicio = relogio_monotonico();
+    VisaoDigitosPi visao;
+    if (cache.ativo && mapear_do_cache(digitos, &visao) == 0) {
+        char *texto = (char*)malloc(visao.tamanho + 1);
+        if (texto != NULL) {
+            memcpy(texto, visao.texto, visao.tamanho);
+            texto[visao.tamanho] = '\0';
+        } else {
+            printf("ERRO: Falha ao alocar memória para o resultado!\n");
+        }
+        cache_digitos_fechar(&visao);
+        tempos_ultimo_pi.total = relogio_monotonico() - inicio;
+        return texto;
+    }
+
+    iniciar_paralelismo(PI_TERMOS_PARA_DIGITOS(digitos));
+    GrandeNumero *pi = calcular_pi_escalado(digitos);
+
     // Converter para string
-    // Cada bloco tem no máximo 9 dígitos
-    // Precisamos alocar espaço suficiente para todos os blocos + ponto decimal + null terminator
-    int tamanho_buffer = pi->quantidade_blocos * 9 + 10;  // 10 extra para segurança e ponto decimal
-    char *buffer = (char*)malloc(tamanho_buffer);
-    if (buffer == NULL) {
+    // O resultado 'pi' é um inteiro gigante que representa 314159...
+    // A conversão binário -> decimal é feita por dividir-para-conquistar
+    double inicio_conversao = relogio_monotonico();
+    char *digitos_pi = grande_numero_para_string(pi);
+    tempos_ultimo_pi.conversao = relogio_monotonico() - inicio_conversao;
+    memoria_ultimo_pi.conversao = encerrar_fase_memoria();
+    liberar_grande_numero(pi);
+    finalizar_pool_tarefas();
+    tempos_ultimo_pi.total = relogio_monotonico() - inicio;
+    if (digitos_pi == NULL) {
         printf("ERRO: Falha ao alocar memória para o resultado!\n");
         return NULL;
     }
-    char *ptr = buffer;
     
-    // O primeiro bloco (mais significativo) pode ter menos de 9 dígitos
-    // Mas Pi é 3.14...
-    // O resultado 'pi' é um inteiro gigante que representa 314159...
-    // O primeiro dígito deve ser 3.
-    
-    if (pi->quantidade_blocos == 0) {
-        sprintf(buffer, "0");
+    // Inserir o ponto decimal após o primeiro dígito '3' e truncar para o número de dígitos pedido
+    int len = strlen(digitos_pi);
+    int len_saida = (len > digitos + 1) ? digitos + 1 : len;  // '3' + dígitos decimais
+    char *buffer = (char*)malloc(len_saida + 2);
+    if (buffer == NULL) {
+        printf("ERRO: Falha ao alocar memória para o resultado!\n");
+        free(digitos_pi);
+        return NULL;
+    }
+    buffer[0] = digitos_pi[0];
+    if (len_saida > 1) {
+        buffer[1] = '.';
+        memcpy(buffer + 2, digitos_pi + 1, len_saida - 1);
+        buffer[len_saida + 1] = '\0';
     } else {
-        ptr += sprintf(ptr, "%u", pi->blocos[pi->quantidade_blocos - 1]);
-        for (int i = pi->quantidade_blocos - 2; i >= 0; i--) {
-            ptr += sprintf(ptr, "%09u", pi->blocos[i]);
+        buffer[1] = '\0';
+    }
+    free(digitos_pi);
+    return buffer;
+}
+
+int calcular_pi_fd(int digitos, int fd) {
+    double inicio = relogio_monotonico();
+    VisaoDigitosPi visao;
+    if (cache.ativo && mapear_do_cache(digitos, &visao) == 0) {
+        int falhou = escrever_texto(fd, visao.texto, visao.tamanho);
+        cache_digitos_fechar(&visao);
+        tempos_ultimo_pi.total = relogio_monotonico() - inicio;
+        return falhou;
+    }
+    return calcular_pi_em_fd(digitos, fd);
+}
+
+// --- VERIFICAÇÃO PELA SÉRIE DE RAMANUJAN ---
+/*
+ * Segunda fórmula, independente da de Chudnovsky, para conferir o resultado:
+ *
+ *   1/π = (2√2 / 9801) Σ (4k)! (1103 + 26390k) / ((k!)^4 396^(4k))
+ *
+ * A razão entre termos consecutivos é 8(2k-1)(4k-1)(4k-3) / (k^3 · 396^4),
+ * então o mesmo binary splitting se aplica com
+ *   P(k) = 8(2k-1)(4k-1)(4k-3),  Q(k) = k^3 · 396^4,  T(k) = P(k)(1103 + 26390k)
+ * e π = 9801 Q / (√8 T). Cada termo rende ~7,98 dígitos (contra ~14,18 do
+ * Chudnovsky), e todos os termos são positivos: nenhum fator, constante ou
+ * sinal é compartilhado com a série principal. A árvore e o fechamento usam
+ * os mesmos merges, núcleos de multiplicação, divisão e raiz quadrada.
+ *
+ * Um erro de aritmética que dependa do tamanho dos operandos aparece nas
+ * duas árvores em posições diferentes e não produz o mesmo π; a comparação
+ * dos últimos dígitos (os mais sensíveis) pega tanto erros da série quanto
+ * do fechamento e da conversão.
+ */
+
+#define RAMANUJAN_DIGITOS_POR_TERMO 7.98
+
+static void folha_ramanujan(int k, TermosBS *res) {
+    res->P = criar_grande_numero(1);
+    res->Q = criar_grande_numero(1);
+    res->T = criar_grande_numero(1);
+    if (k == 0) {
+        definir_valor_inteiro(res->P, 1);
+        definir_valor_inteiro(res->Q, 1);
+        definir_valor_inteiro(res->T, 1103);
+        return;
+    }
+
+    // P = 8(2k-1)(4k-1)(4k-3)
+    definir_valor_inteiro(res->P, 8 * (2 * k - 1));
+    multiplicar_por_inteiro(res->P, 4 * k - 1, res->P);
+    multiplicar_por_inteiro(res->P, 4 * k - 3, res->P);
+
+    // Q = k^3 · 396^4
+    definir_valor_inteiro(res->Q, k);
+    multiplicar_por_inteiro(res->Q, k, res->Q);
+    multiplicar_por_inteiro(res->Q, k, res->Q);
+    for (int i = 0; i < 4; i++) multiplicar_por_inteiro(res->Q, 396, res->Q);
+
+    // T = P (1103 + 26390k)
+    GrandeNumero *linear = criar_grande_numero(1);
+    definir_valor_inteiro64(linear, 1103 + 26390LL * k);
+    multiplicar_grandes_numeros(res->P, linear, res->T);
+    liberar_grande_numero(linear);
+}
+
+static void binary_splitting_ramanujan(int a, int b, TermosBS *res);
+
+static void executar_binary_splitting_ramanujan(void *argumento) {
+    IntervaloBS *intervalo = (IntervaloBS*)argumento;
+    binary_splitting_ramanujan(intervalo->a, intervalo->b, intervalo->res);
+}
+
+static void binary_splitting_ramanujan(int a, int b, TermosBS *res) {
+    Fatoracao vazia = { 0 };
+    res->fatores_p = vazia;
+    res->fatores_q = vazia;
+    if (b - a == 1) {
+        folha_ramanujan(a, res);
+        return;
+    }
+
+    int m = (a + b) / 2;
+    TermosBS left, right;
+    int paralelo = pool_tarefas_ativo() && (b - a) > grao_em_uso;
+    if (paralelo) {
+        Tarefa tarefa_esquerda;
+        IntervaloBS intervalo = { a, m, &left };
+        tarefa_criar(&tarefa_esquerda, executar_binary_splitting_ramanujan, &intervalo);
+        binary_splitting_ramanujan(m, b, &right);
+        tarefa_aguardar(&tarefa_esquerda);
+    } else {
+        binary_splitting_ramanujan(a, m, &left);
+        binary_splitting_ramanujan(m, b, &right);
+    }
+    combinar_termos(&left, &right, res, p_necessario(b), paralelo);
+}
+
+// Pi * 10^digitos truncado, pela série de Ramanujan
+static GrandeNumero* calcular_pi_ramanujan_escalado(int digitos) {
+    int termos = (int)(digitos / RAMANUJAN_DIGITOS_POR_TERMO) + 2;
+
+    // Os merges não têm fatorações para cancelar nesta série
+    int modo_fatores_salvo = modo_fatores;
+    modo_fatores = 0;
+    double inicio = relogio_monotonico();
+    iniciar_medicao_memoria();
+    TermosBS final;
+    fim_da_serie = termos;
+    binary_splitting_ramanujan(0, termos, &final);
+    fim_da_serie = 0;
+    modo_fatores = modo_fatores_salvo;
+    double fim_serie = relogio_monotonico();
+    tempos_ultimo_pi.serie = fim_serie - inicio;
+    tempos_ultimo_pi.checkpoint = 0;
+    tempos_ultimo_pi.cache = 0;
+    memoria_ultimo_pi.serie = encerrar_fase_memoria();
+
+    int precisao = precisao_para_digitos(digitos) + PI_BLOCOS_GUARDA;
+
+    // Pi = 9801 Q / (sqrt(8) T)
+    NumeroReal *raiz = criar_numero_real();
+    real_de_inteiro(raiz, 8);
+    real_raiz_quadrada(raiz, raiz, precisao);
+
+    NumeroReal *denominador = criar_numero_real();
+    real_de_grande_numero(denominador, final.T, precisao);
+    real_multiplicar(denominador, raiz, denominador, precisao);
+
+    NumeroReal *pi = criar_numero_real();
+    real_de_grande_numero(pi, final.Q, precisao);
+    real_multiplicar_por_inteiro(pi, 9801, pi);
+    real_dividir(pi, denominador, pi, precisao);
+    liberar_termos(&final);
+    liberar_numero_real(raiz);
+    liberar_numero_real(denominador);
+
+    GrandeNumero *escala = escalar_decimal(pi, digitos, precisao);
+    liberar_numero_real(pi);
+    tempos_ultimo_pi.fechamento = relogio_monotonico() - fim_serie;
+    memoria_ultimo_pi.fechamento = encerrar_fase_memoria();
+    return escala;
+}
+
+long long verificar_pi(int digitos, const char *ultimos) {
+    int quantidade = (int)strlen(ultimos);
+    if (quantidade < 1 || quantidade > digitos + 1) {
+        printf("ERRO: Verificação de %d dígitos finais para Pi com %d casas\n", quantidade, digitos);
+        return -2;
+    }
+
+    double inicio = relogio_monotonico();
+    iniciar_paralelismo((int)(digitos / RAMANUJAN_DIGITOS_POR_TERMO) + 2);
+    GrandeNumero *pi = calcular_pi_ramanujan_escalado(digitos);
+
+    // Só os últimos dígitos vão para decimal: o resto da divisão por 10^quantidade
+    double inicio_conversao = relogio_monotonico();
+    GrandeNumero *potencia = criar_grande_numero(1);
+    GrandeNumero *quociente = criar_grande_numero(1);
+    GrandeNumero *resto = criar_grande_numero(1);
+    potencia_inteira(10, quantidade, potencia);
+    dividir_com_resto(pi, potencia, quociente, resto);
+    char *calculados = grande_numero_para_string(resto);
+    tempos_ultimo_pi.conversao = relogio_monotonico() - inicio_conversao;
+    memoria_ultimo_pi.conversao = encerrar_fase_memoria();
+    liberar_grande_numero(pi);
+    liberar_grande_numero(potencia);
+    liberar_grande_numero(quociente);
+    liberar_grande_numero(resto);
+    finalizar_pool_tarefas();
+    tempos_ultimo_pi.total = relogio_monotonico() - inicio;
+    if (calculados == NULL) {
+        printf("ERRO: Falha ao alocar memória para o resultado!\n");
+        return -2;
+    }
+
+    // O resto perde os zeros à esquerda: compara contra eles implicitamente
+    int zeros = quantidade - (int)strlen(calculados);
+    long long diferenca = -1;
+    for (int i = 0; i < quantidade && diferenca < 0; i++) {
+        char esperado = (i < zeros) ? '0' : calculados[i - zeros];
+        if (ultimos[i] != esperado) diferenca = (long long)digitos - quantidade + 1 + i;
+    }
+    free(calculados);
+    return diferenca;
+}
+
+// --- EXTRAÇÃO DE DÍGITOS HEXADECIMAIS (BELLARD) ---
+/*
+ * Fórmula de Bellard (variante ~43% mais rápida da BBP):
+ *
+ *   π = 2^-6 Σ (-1)^k / 2^(10k) · ( -2^5/(4k+1) - 1/(4k+3) + 2^8/(10k+1)
+ *                                   - 2^6/(10k+3) - 2^2/(10k+5) - 2^2/(10k+7) + 1/(10k+9) )
+ *
+ * Os dígitos a partir da posição n são os de frac(16^n π). Multiplicando
+ * cada termo por 2^(4n), os termos com expoente e >= 0 só contribuem com
+ * frac(2^e / m) = (2^e mod m) / m, e 2^e mod m sai de uma exponenciação
+ * modular de 64 bits (m é sempre ímpar: Montgomery com R = 2^64, onde o
+ * passo "vezes 2" é só uma soma). Os poucos termos com e < 0 formam a
+ * cauda, que cai 2^10 por termo. Tempo O(n log n), memória constante.
+ *
+ * Cada parcela vira ponto fixo de 128 bits (floor(2^128 r / m)), somado
+ * módulo 2^128: os erros de arredondamento (< 1 ulp por parcela) somam
+ * menos que 2^36 ulps até n ~ 2^32, de modo que os 16 primeiros dígitos
+ * hexadecimais (64 bits) da soma ficam exatos, salvo uma sequência
+ * patológica de F's ou 0's logo depois deles. As somas parciais são
+ * exatas módulo 2^128, então dividir k entre threads não muda o resultado.
+ */
+
+#define BBP_DIGITOS_POR_AVALIACAO 16
+#define BBP_TAREFAS_POR_THREAD 8
+#define BBP_FAIXAS 4                     // Exponenciações intercaladas
+#define BBP_POSICAO_MAXIMA (1LL << 58)   // Mantém os módulos m < 2^62
+
+typedef unsigned __int128 Fixo128;
+
+// -m^(-1) mod 2^64 por Newton (m ímpar: cada passo dobra os bits corretos)
+static inline uint64_t inverso_negativo_64(uint64_t m) {
+    uint64_t x = m;   // Correto em 3 bits: m·m ≡ 1 (mod 8)
+    for (int i = 0; i < 5; i++) x *= 2 - m * x;
+    return (uint64_t)0 - x;
+}
+
+static inline uint64_t reduzir_montgomery(Fixo128 t, uint64_t m, uint64_t m_linha) {
+    uint64_t u = (uint64_t)t * m_linha;
+    uint64_t r = (uint64_t)((t + (Fixo128)u * m) >> 64);
+    return (r >= m) ? r - m : r;
+}
+
+// 2^e[i] mod m[i] (m ímpar > 1) para BBP_FAIXAS módulos de uma vez, da
+// esquerda para a direita em forma de Montgomery. As cadeias são
+// independentes e se sobrepõem no pipeline; o passo "vezes 2" é sem desvios.
+static void potencias_de_2_mod(const uint64_t *e, const uint64_t *m, uint64_t *r) {
+    uint64_t m_linha[BBP_FAIXAS], x[BBP_FAIXAS], bits = 1;
+    for (int i = 0; i < BBP_FAIXAS; i++) {
+        m_linha[i] = inverso_negativo_64(m[i]);
+        x[i] = ((uint64_t)0 - m[i]) % m[i];   // R mod m = forma de Montgomery de 1
+        bits |= e[i];
+    }
+    for (int bit = 63 - __builtin_clzll(bits); bit >= 0; bit--) {
+        for (int i = 0; i < BBP_FAIXAS; i++) {
+            uint64_t quadrado = reduzir_montgomery((Fixo128)x[i] * x[i], m[i], m_linha[i]);
+            uint64_t dobro = quadrado << 1;
+            dobro -= m[i] & -(uint64_t)(dobro >= m[i]);
+            uint64_t usar_dobro = -((e[i] >> bit) & 1);
+            x[i] = (dobro & usar_dobro) | (quadrado & ~usar_dobro);
         }
     }
-    
-    // Inserir o ponto decimal após o primeiro dígito '3'
-    // O buffer tem "314159..."
-    // Queremos "3.14159..."
-    // Vamos mover tudo um para a direita
-    int len = strlen(buffer);
-    if (len > 1) {
-        for(int i = len; i >= 1; i--) {
-            buffer[i+1] = buffer[i];
+    for (int i = 0; i < BBP_FAIXAS; i++) r[i] = reduzir_montgomery(x[i], m[i], m_linha[i]);
+}
+
+// r/m em ponto fixo de 128 bits (r < m)
+static Fixo128 fracao_de_resto(uint64_t r, uint64_t m) {
+    Fixo128 dividendo = (Fixo128)r << 64;
+    uint64_t alto = (uint64_t)(dividendo / m);
+    uint64_t resto = (uint64_t)(dividendo - (Fixo128)alto * m);
+    uint64_t baixo = (uint64_t)(((Fixo128)resto << 64) / m);
+    return ((Fixo128)alto << 64) | baixo;
+}
+
+// frac(2^e / m) em ponto fixo de 128 bits, um termo isolado (bordas e cauda)
+static Fixo128 fracao_termo(long long e, uint64_t m) {
+    if (e >= 0) {
+        if (m == 1) return 0;
+        uint64_t expoentes[BBP_FAIXAS], modulos[BBP_FAIXAS], restos[BBP_FAIXAS];
+        for (int i = 0; i < BBP_FAIXAS; i++) {
+            expoentes[i] = (uint64_t)e;
+            modulos[i] = m;
         }
-        buffer[1] = '.';
+        potencias_de_2_mod(expoentes, modulos, restos);
+        return fracao_de_resto(restos[0], m);
     }
-    
-    // Truncar para o número de dígitos pedido
-    if ((int)strlen(buffer) > digitos + 2) { // +2 conta '3.'
-        buffer[digitos + 2] = '\0';
+    if (e <= -128) return 0;
+    return ((Fixo128)1 << (128 + e)) / m;
+}
+
+// Bloco de k da soma de Bellard, executado como tarefa do pool
+typedef struct {
+    long long posicao;
+    long long k_inicio;
+    long long k_fim;
+    Fixo128 soma;
+} ParcelaBellard;
+
+static void executar_parcela_bellard(void *argumento) {
+    static const int deslocamentos[7] = { 5, 0, 8, 6, 2, 2, 0 };
+    static const int negativos[7] = { 1, 1, 0, 1, 1, 1, 0 };
+    static const int multiplicadores[7] = { 4, 4, 10, 10, 10, 10, 10 };
+    static const int constantes[7] = { 1, 3, 1, 3, 5, 7, 9 };
+
+    ParcelaBellard *parcela = (ParcelaBellard*)argumento;
+    Fixo128 soma = 0;
+    for (long long k = parcela->k_inicio; k < parcela->k_fim; k += BBP_FAIXAS) {
+        for (int j = 0; j < 7; j++) {
+            // BBP_FAIXAS valores consecutivos de k com a mesma parcela j
+            long long e[BBP_FAIXAS];
+            uint64_t expoentes[BBP_FAIXAS], modulos[BBP_FAIXAS], restos[BBP_FAIXAS];
+            int rapido = (k + BBP_FAIXAS <= parcela->k_fim);
+            for (int i = 0; i < BBP_FAIXAS; i++) {
+                e[i] = 4 * parcela->posicao - 6 - 10 * (k + i) + deslocamentos[j];
+                modulos[i] = (uint64_t)multiplicadores[j] * (uint64_t)(k + i) + (uint64_t)constantes[j];
+                expoentes[i] = (uint64_t)e[i];
+                rapido = rapido && e[i] >= 0 && modulos[i] > 1;
+            }
+            if (rapido) potencias_de_2_mod(expoentes, modulos, restos);
+
+            for (int i = 0; i < BBP_FAIXAS && k + i < parcela->k_fim; i++) {
+                Fixo128 termo = rapido ? fracao_de_resto(restos[i], modulos[i]) : fracao_termo(e[i], modulos[i]);
+                // (-1)^k vezes o sinal da parcela
+                if (negativos[j] ^ (int)((k + i) & 1)) soma -= termo;
+                else soma += termo;
+            }
+        }
     }
+    parcela->soma = soma;
+}
 
-    liberar_grande_numero(raiz);
-    liberar_grande_numero(base_raiz);
-    liberar_grande_numero(numerador);
-    liberar_grande_numero(pi);
-    liberar_termos(&final);
-    
-    return buffer;
+// frac(16^posicao · π) em ponto fixo de 128 bits
+static Fixo128 fracao_pi_hex(long long posicao) {
+    // Até aqui o menor expoente do termo k (4n - 6 - 10k) ainda passa de -128
+    long long termos = (4 * posicao + 128) / 10 + 1;
+    int num_tarefas = pool_tarefas_ativo() ? numero_threads_pool() * BBP_TAREFAS_POR_THREAD : 1;
+    if (num_tarefas > termos) num_tarefas = (int)termos;
+
+    ParcelaBellard *parcelas = (ParcelaBellard*)calloc((size_t)num_tarefas, sizeof(ParcelaBellard));
+    Tarefa *tarefas = (Tarefa*)calloc((size_t)num_tarefas, sizeof(Tarefa));
+    if (parcelas == NULL || tarefas == NULL) {
+        // Sem memória para dividir: uma parcela única, na pilha
+        free(parcelas);
+        free(tarefas);
+        ParcelaBellard unica = { posicao, 0, termos, 0 };
+        executar_parcela_bellard(&unica);
+        return unica.soma;
+    }
+    for (int i = 0; i < num_tarefas; i++) {
+        parcelas[i].posicao = posicao;
+        parcelas[i].k_inicio = termos * i / num_tarefas;
+        parcelas[i].k_fim = termos * (i + 1) / num_tarefas;
+        tarefa_criar(&tarefas[i], executar_parcela_bellard, &parcelas[i]);
+    }
+    Fixo128 soma = 0;
+    for (int i = 0; i < num_tarefas; i++) {
+        tarefa_aguardar(&tarefas[i]);
+        soma += parcelas[i].soma;
+    }
+    free(parcelas);
+    free(tarefas);
+    return soma;
+}
+
+char* calcular_pi_hex(long long posicao, int quantidade) {
+    if (posicao < 0 || posicao > BBP_POSICAO_MAXIMA || quantidade < 0) {
+        printf("ERRO: Posição hexadecimal inválida: %lld (máximo %lld)\n", posicao, BBP_POSICAO_MAXIMA);
+        return NULL;
+    }
+    char *digitos = (char*)malloc((size_t)quantidade + 1);
+    if (digitos == NULL) {
+        printf("ERRO: Falha ao alocar memória para o resultado!\n");
+        return NULL;
+    }
+
+    double inicio = relogio_monotonico();
+    if (numero_threads > 1) iniciar_pool_tarefas(numero_threads);
+    static const char hexadecimais[] = "0123456789ABCDEF";
+    for (int feitos = 0; feitos < quantidade; feitos += BBP_DIGITOS_POR_AVALIACAO) {
+        Fixo128 fracao = fracao_pi_hex(posicao + feitos);
+        for (int i = 0; i < BBP_DIGITOS_POR_AVALIACAO && feitos + i < quantidade; i++) {
+            digitos[feitos + i] = hexadecimais[(int)(fracao >> 124)];
+            fracao <<= 4;
+        }
+    }
+    digitos[quantidade] = '\0';
+    finalizar_pool_tarefas();
+
+    memset(&tempos_ultimo_pi, 0, sizeof(tempos_ultimo_pi));
+    memset(&memoria_ultimo_pi, 0, sizeof(memoria_ultimo_pi));
+    tempos_ultimo_pi.total = relogio_monotonico() - inicio;
+    return digitos;
 }
@@ -1,35 +1,495 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
 #include "ltpi2.h"
+#include "planejador.h"
+#include "servidor_digitos.h"
+#include "cliente_digitos.h"
+#include "digitos_compactos.h"
+#include "nucleos.h"
+
+#define DIGITOS_PADRAO 100000
+#define SAIDA_PADRAO "pi_100k_ltpi2.txt"
+
+static struct {
+    int digitos;
+    const char *saida;
+    int threads;
+    const char *checkpoint;     // Diretório de checkpoint (NULL = desligado)
+    double intervalo;
+    int retomar;
+    long long hex;              // Posição hexadecimal (-1 = calcula os dígitos decimais)
+    int quantidade;
+    int verificar;              // Últimos dígitos conferidos pela série de Ramanujan (0 = não confere)
+    int sem_calculo;            // Só confere o arquivo já existente
+    int planejar;               // Só imprime o plano
+    size_t memoria;             // Limite de memória do plano (0 = sem plano)
+    const char *disco;          // Diretório para vetores em disco, se o plano pedir
+    int threads_definidas;
+    const char *cache;          // Arquivo do cache de dígitos (NULL = sem cache)
+    const char *servir;         // Socket do servidor de dígitos (NULL = não serve)
+    const char *consultar;      // Socket de um servidor a consultar (NULL = não consulta)
+    unsigned long long inicio, fim;   // Faixa de --consultar e --extrair
+    int compacto;               // Saída no formato compacto (digitos_compactos.h)
+    const char *converter;      // Arquivo a converter entre texto e compacto (NULL = não converte)
+    const char *extrair;        // Arquivo compacto de onde imprimir --faixa (NULL = não extrai)
+    int fatia, fatias;          // --fatia I/N: só calcula a fatia I (fatias = 0: cálculo inteiro)
+    int combinar;               // --combinar N: fatias já gravadas em --checkpoint (0 = não combina)
+    const char *nucleos;        // Versão dos núcleos SIMD (NULL = a escolhida por cpuid)
+    int fatores;                // Força o binary splitting com fatores (senão o plano decide)
+} config = {
+    // Os demais campos começam zerados (NULL, desligado)
+    .digitos = DIGITOS_PADRAO,
+    .saida = SAIDA_PADRAO,
+    .threads = 1,
+    .hex = -1,
+    .quantidade = 16,
+};
+
+static void uso(const char *programa) {
+    printf("Uso: %s [opções]\n", programa);
+    printf("  --digitos N          dígitos decimais de Pi (padrão %d)\n", DIGITOS_PADRAO);
+    printf("  --saida ARQUIVO      arquivo de saída (padrão %s)\n", SAIDA_PADRAO);
+    printf("  --threads N          threads do cálculo (padrão 1)\n");
+    printf("  --checkpoint DIR     grava subárvores da série em DIR durante o cálculo\n");
+    printf("  --intervalo S        espaço mínimo entre checkpoints, em segundos (padrão: automático)\n");
+    printf("  --retomar            retoma a partir dos checkpoints já presentes em DIR\n");
+    printf("  --hex POS            só os dígitos hexadecimais a partir de POS (0 = 243F6A88...), pela fórmula de Bellard\n");
+    printf("  --quantidade N       dígitos hexadecimais de --hex (padrão 16)\n");
+    printf("  --verificar K        confere os últimos K dígitos por uma segunda fórmula (Ramanujan)\n");
+    printf("  --sem-calculo        com --verificar, só confere o arquivo de --saida já existente\n");
+    printf("  --planejar           só estima memória e tempo e mostra a estratégia escolhida\n");
+    printf("  --fatores            binary splitting com fatores (mdc removido a cada merge), mesmo resultado\n");
+    printf("  --memoria LIMITE     limite de memória (ex.: 16G, 512M); o cálculo segue o plano\n");
+    printf("  --disco DIR          diretório para arquivos mapeados, se o plano não couber na RAM\n");
+    printf("  --cache ARQUIVO      serve os dígitos do cache se ele já tem casas suficientes; senão calcula e o estende\n");
+    printf("  --servir SOCKET      serve faixas de dígitos do cache (ou de --saida) no socket Unix, até SIGINT/SIGTERM\n");
+    printf("  --consultar SOCKET   imprime as casas de --faixa pedidas a um servidor\n");
+    printf("  --faixa I:J          casas [I, J) de --consultar e --extrair (0 = primeira depois do ponto)\n");
+    printf("  --formato F          texto (padrão) ou compacto: 19 casas por palavra de 64 bits, com índice\n");
+    printf("  --converter ARQUIVO  converte ARQUIVO de texto para compacto, ou de compacto para texto, em --saida\n");
+    printf("  --extrair ARQUIVO    imprime as casas de --faixa de um arquivo compacto\n");
+    printf("  --fatia I/N          só calcula a fatia I (0..N-1) da série e a grava no diretório de --checkpoint\n");
+    printf("  --combinar N         combina as N fatias gravadas no diretório de --checkpoint e termina o cálculo\n");
+    printf("  --nucleos NOME       força a versão dos núcleos de blocos (escalar, avx2, avx512, avx512ifma)\n");
+}
+
+// "16G", "512M", "64K" ou bytes
+static int ler_tamanho(const char *texto, size_t *bytes) {
+    char *fim;
+    double valor = strtod(texto, &fim);
+    if (fim == texto || valor < 0) return -1;
+    switch (*fim) {
+        case 'G': case 'g': valor *= 1024.0 * 1024.0 * 1024.0; fim++; break;
+        case 'M': case 'm': valor *= 1024.0 * 1024.0; fim++; break;
+        case 'K': case 'k': valor *= 1024.0; fim++; break;
+        default: break;
+    }
+    if (*fim != '\0') return -1;
+    *bytes = (size_t)valor;
+    return 0;
+}
+
+static int ler_argumentos(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        const char *opcao = argv[i];
+        const char *valor = (i + 1 < argc) ? argv[i + 1] : NULL;
+        int ok = 1;
+        if (strcmp(opcao, "--ajuda") == 0 || strcmp(opcao, "-h") == 0) {
+            uso(argv[0]);
+            exit(0);
+        } else if (strcmp(opcao, "--retomar") == 0) {
+            config.retomar = 1;
+            continue;
+        } else if (strcmp(opcao, "--sem-calculo") == 0) {
+            config.sem_calculo = 1;
+            continue;
+        } else if (strcmp(opcao, "--planejar") == 0) {
+            config.planejar = 1;
+            continue;
+        } else if (strcmp(opcao, "--fatores") == 0) {
+            config.fatores = 1;
+            continue;
+        } else if (valor == NULL) {
+            ok = 0;
+        } else if (strcmp(opcao, "--digitos") == 0) {
+            config.digitos = atoi(valor);
+            ok = (config.digitos >= 1);
+        } else if (strcmp(opcao, "--saida") == 0) {
+            config.saida = valor;
+        } else if (strcmp(opcao, "--threads") == 0) {
+            config.threads = atoi(valor);
+            config.threads_definidas = 1;
+        } else if (strcmp(opcao, "--memoria") == 0) {
+            ok = (ler_tamanho(valor, &config.memoria) == 0);
+        } else if (strcmp(opcao, "--disco") == 0) {
+            config.disco = valor;
+        } else if (strcmp(opcao, "--cache") == 0) {
+            config.cache = valor;
+        } else if (strcmp(opcao, "--servir") == 0) {
+            config.servir = valor;
+        } else if (strcmp(opcao, "--consultar") == 0) {
+            config.consultar = valor;
+        } else if (strcmp(opcao, "--formato") == 0) {
+            config.compacto = (strcmp(valor, "compacto") == 0);
+            ok = config.compacto || strcmp(valor, "texto") == 0;
+        } else if (strcmp(opcao, "--converter") == 0) {
+            config.converter = valor;
+        } else if (strcmp(opcao, "--extrair") == 0) {
+            config.extrair = valor;
+        } else if (strcmp(opcao, "--faixa") == 0) {
+            ok = (sscanf(valor, "%llu:%llu", &config.inicio, &config.fim) == 2 && config.inicio <= config.fim);
+        } else if (strcmp(opcao, "--fatia") == 0) {
+            ok = (sscanf(valor, "%d/%d", &config.fatia, &config.fatias) == 2 &&
+                  config.fatias >= 1 && config.fatia >= 0 && config.fatia < config.fatias);
+        } else if (strcmp(opcao, "--combinar") == 0) {
+            config.combinar = atoi(valor);
+            ok = (config.combinar >= 1);
+        } else if (strcmp(opcao, "--checkpoint") == 0) {
+            config.checkpoint = valor;
+        } else if (strcmp(opcao, "--intervalo") == 0) {
+            config.intervalo = atof(valor);
+        } else if (strcmp(opcao, "--nucleos") == 0) {
+            config.nucleos = valor;
+        } else if (strcmp(opcao, "--hex") == 0) {
+            config.hex = atoll(valor);
+            ok = (config.hex >= 0);
+        } else if (strcmp(opcao, "--verificar") == 0) {
+            config.verificar = atoi(valor);
+            ok = (config.verificar >= 1);
+        } else if (strcmp(opcao, "--quantidade") == 0) {
+            config.quantidade = atoi(valor);
+            ok = (config.quantidade >= 1);
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            printf("ERRO: Opção inválida ou sem valor: %s\n", opcao);
+            uso(argv[0]);
+            return -1;
+        }
+        i++;
+    }
+    if (config.retomar && config.checkpoint == NULL) {
+        printf("ERRO: --retomar exige --checkpoint DIR\n");
+        return -1;
+    }
+    if ((config.fatias > 0 || config.combinar > 0) && config.checkpoint == NULL) {
+        printf("ERRO: --fatia e --combinar exigem --checkpoint DIR (o diretório das fatias)\n");
+        return -1;
+    }
+    if (config.sem_calculo && config.verificar == 0) {
+        printf("ERRO: --sem-calculo exige --verificar K\n");
+        return -1;
+    }
+    if ((config.consultar != NULL || config.extrair != NULL) && config.fim == 0) {
+        printf("ERRO: --consultar e --extrair exigem --faixa I:J\n");
+        return -1;
+    }
+    if (config.nucleos != NULL && definir_nucleos(config.nucleos) != 0) {
+        const NucleosBlocos *versoes[8];
+        int n = listar_nucleos(versoes, 8);
+        printf("ERRO: Núcleos '%s' inexistentes ou não suportados por esta CPU; disponíveis:", config.nucleos);
+        for (int i = 0; i < n; i++) printf(" %s", versoes[i]->nome);
+        printf("\n");
+        return -1;
+    }
+    if (config.verificar > config.digitos) config.verificar = config.digitos;
+    return 0;
+}
+
+// Picos de memória dos números grandes, por fase, do último cálculo
+static void imprimir_memoria(void) {
+    MemoriaPi memoria;
+    obter_memoria_pi(&memoria);
+    const double MiB = 1024.0 * 1024.0;
+    printf("  pico de memória %.1f MiB (série %.1f, fechamento %.1f, conversão %.1f)\n",
+           memoria.total / MiB, memoria.serie / MiB, memoria.fechamento / MiB, memoria.conversao / MiB);
+    if (memoria.disco > 0) printf("  pico em disco %.1f MiB\n", memoria.disco / MiB);
+}
+
+// Extração direta: não calcula (nem grava) os dígitos anteriores
+static int extrair_hex(void) {
+    definir_numero_threads(config.threads);
+    char *digitos = calcular_pi_hex(config.hex, config.quantidade);
+    if (digitos == NULL) return 1;
+    TemposPi tempos;
+    obter_tempos_pi(&tempos);
+    printf("Dígitos hexadecimais de Pi a partir da posição %lld: %s\n", config.hex, digitos);
+    printf("Calculados em %.2f segundos.\n", tempos.total);
+    free(digitos);
+    return 0;
+}
+
+// Casas [inicio, inicio + quantidade) do arquivo de --saida, em texto ou
+// compacto. Retorna 0, ou -1 se o arquivo não as tem.
+static int ler_casas_saida(unsigned long long inicio, size_t quantidade, char *destino) {
+    ArquivoCompacto compacto;
+    if (digitos_compactos_abrir(config.saida, &compacto) == 0) {
+        int falhou = digitos_compactos_ler(&compacto, inicio, inicio + quantidade, destino);
+        digitos_compactos_fechar(&compacto);
+        return falhou;
+    }
+    int fd = open(config.saida, O_RDONLY);
+    if (fd < 0) return -1;
+    ssize_t lidos = pread(fd, destino, quantidade, (off_t)inicio + 2);
+    close(fd);
+    return (lidos == (ssize_t)quantidade) ? 0 : -1;
+}
+
+// Lê os últimos dígitos do arquivo ("3." + digitos casas) e os recalcula por
+// outra fórmula. Retorna 0 se coincidem.
+static int verificar_arquivo(void) {
+    char *ultimos = (char*)malloc((size_t)config.verificar + 1);
+    if (ultimos == NULL || ler_casas_saida((unsigned long long)(config.digitos - config.verificar),
+                                           (size_t)config.verificar, ultimos) != 0) {
+        printf("ERRO: '%s' não tem %d casas decimais\n", config.saida, config.digitos);
+        free(ultimos);
+        return 1;
+    }
+    ultimos[config.verificar] = '\0';
+
+    printf("Verificando as últimas %d casas pela série de Ramanujan...\n", config.verificar);
+    definir_numero_threads(config.threads);
+    long long diferenca = verificar_pi(config.digitos, ultimos);
+    free(ultimos);
+
+    TemposPi tempos;
+    obter_tempos_pi(&tempos);
+    printf("  verificação em %.2fs (série %.2fs, fechamento %.2fs)\n", tempos.total, tempos.serie, tempos.fechamento);
+    imprimir_memoria();
+    if (diferenca == -2) return 1;
+    if (diferenca >= 0) {
+        printf("ERRO: Resultado difere da segunda fórmula a partir da casa decimal %lld\n", diferenca);
+        return 1;
+    }
+    printf("Verificação OK: as últimas %d casas coincidem.\n", config.verificar);
+    return 0;
+}
+
+// Faixa pedida a um servidor já em execução, direto para a saída padrão
+static int consultar_servidor(void) {
+    int conexao = conectar_servidor_digitos(config.consultar);
+    if (conexao < 0) {
+        printf("ERRO: Não foi possível conectar a '%s'\n", config.consultar);
+        return 1;
+    }
+    fflush(stdout);
+    int estado = pedir_digitos_fd(conexao, config.inicio, config.fim, STDOUT_FILENO);
+    desconectar_servidor_digitos(conexao);
+    if (estado == DIGITOS_ESTADO_FORA) {
+        printf("ERRO: O servidor não tem as casas [%llu, %llu)\n", config.inicio, config.fim);
+        return 1;
+    }
+    if (estado != 0) {
+        printf("\nERRO: Conexão com '%s' interrompida\n", config.consultar);
+        return 1;
+    }
+    printf("\n");
+    return 0;
+}
+
+// Cálculo comum, ou a combinação das fatias de --combinar
+static int calcular_em_fd(int fd) {
+    if (config.combinar > 0) return combinar_fatias_pi(config.digitos, config.combinar, config.checkpoint, fd);
+    return calcular_pi_fd(config.digitos, fd);
+}
+
+// Um trabalhador da série dividida: grava a fatia e termina
+static int calcular_fatia(void) {
+    int a, b;
+    if (faixa_fatia_pi(config.digitos, config.fatias, config.fatia, &a, &b) == 0) {
+        printf("Fatia %d de %d: termos [%d, %d) de %d dígitos...\n", config.fatia, config.fatias, a, b, config.digitos);
+    }
+    definir_numero_threads(config.threads);
+    if (calcular_fatia_pi(config.digitos, config.fatias, config.fatia, config.checkpoint) != 0) return 1;
+    TemposPi tempos;
+    obter_tempos_pi(&tempos);
+    printf("Fatia gravada em '%s' em %.2f segundos (série %.2fs, gravação %.2fs).\n",
+           config.checkpoint, tempos.total, tempos.serie, tempos.checkpoint);
+    imprimir_memoria();
+    return 0;
+}
+
+// Formato compacto: o texto de calcular_pi_fd passa por um pipe até uma
+// thread que o empacota, sem nunca existir em disco
+typedef struct {
+    int fd;
+    long long casas;
+} EmpacotamentoSaida;
+
+static void* empacotar_saida(void *argumento) {
+    EmpacotamentoSaida *empacotamento = (EmpacotamentoSaida*)argumento;
+    empacotamento->casas = digitos_compactos_de_texto(empacotamento->fd, config.saida);
+    // Depois de um erro o pipe ainda é esvaziado, para o cálculo não travar
+    char descarte[4096];
+    while (read(empacotamento->fd, descarte, sizeof(descarte)) > 0) {}
+    return NULL;
+}
+
+static int calcular_compacto(void) {
+    int canal[2];
+    if (pipe(canal) != 0) return 1;
+    EmpacotamentoSaida empacotamento = { canal[0], -1 };
+    pthread_t empacotador;
+    if (pthread_create(&empacotador, NULL, empacotar_saida, &empacotamento) != 0) {
+        close(canal[0]);
+        close(canal[1]);
+        return 1;
+    }
+    int falhou = calcular_em_fd(canal[1]);
+    close(canal[1]);
+    pthread_join(empacotador, NULL);
+    close(canal[0]);
+    return falhou || empacotamento.casas != config.digitos;
+}
+
+// Texto -> compacto ou compacto -> texto, conforme o formato da entrada
+static int converter_arquivo(void) {
+    ArquivoCompacto compacto;
+    if (digitos_compactos_abrir(config.converter, &compacto) == 0) {
+        int fd = open(config.saida, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        char inteira[16];
+        int tamanho = snprintf(inteira, sizeof(inteira), "%u.", compacto.parte_inteira);
+        int falhou = (fd < 0) || write(fd, inteira, (size_t)tamanho) != tamanho ||
+                     digitos_compactos_escrever_fd(&compacto, 0, compacto.casas, fd) != 0;
+        unsigned long long casas = compacto.casas;
+        digitos_compactos_fechar(&compacto);
+        if (fd >= 0 && close(fd) != 0) falhou = 1;
+        if (falhou) {
+            if (fd >= 0) unlink(config.saida);
+            printf("ERRO: Falha ao converter '%s' para texto (arquivo corrompido ou erro de escrita)\n", config.converter);
+            return 1;
+        }
+        printf("%llu casas convertidas para texto em '%s'.\n", casas, config.saida);
+        return 0;
+    }
+
+    int fd = open(config.converter, O_RDONLY);
+    long long casas = (fd >= 0) ? digitos_compactos_de_texto(fd, config.saida) : -1;
+    if (fd >= 0) close(fd);
+    if (casas < 0) {
+        printf("ERRO: '%s' não é um arquivo de dígitos (texto \"3.1415...\" ou compacto)\n", config.converter);
+        return 1;
+    }
+    printf("%lld casas compactadas em '%s'.\n", casas, config.saida);
+    return 0;
+}
+
+// Faixa de um arquivo compacto, direto para a saída padrão
+static int extrair_faixa(void) {
+    ArquivoCompacto compacto;
+    if (digitos_compactos_abrir(config.extrair, &compacto) != 0) {
+        printf("ERRO: '%s' não é um arquivo compacto de dígitos\n", config.extrair);
+        return 1;
+    }
+    fflush(stdout);
+    int falhou = digitos_compactos_escrever_fd(&compacto, config.inicio, config.fim, STDOUT_FILENO);
+    unsigned long long casas = compacto.casas;
+    digitos_compactos_fechar(&compacto);
+    if (falhou) {
+        printf("\nERRO: Faixa [%llu, %llu) fora das %llu casas de '%s', ou bloco corrompido\n",
+               config.inicio, config.fim, casas, config.extrair);
+        return 1;
+    }
+    printf("\n");
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (ler_argumentos(argc, argv) != 0) return 2;
+    if (config.consultar != NULL) return consultar_servidor();
+    if (config.converter != NULL) return converter_arquivo();
+    if (config.extrair != NULL) return extrair_faixa();
+    if (config.servir != NULL) {
+        return (servir_digitos(config.cache != NULL ? config.cache : config.saida, config.servir) == 0) ? 0 : 1;
+    }
+    if (config.hex >= 0) return extrair_hex();
+    if (config.sem_calculo) return verificar_arquivo();
+    // Antes das fatias: todos os processos de um cálculo usam o mesmo modo
+    if (config.fatores) definir_modo_fatores(1);
+    if (config.fatias > 0) return calcular_fatia();
+
+    // Plano: com --threads o limite superior é o pedido; sem, todas as CPUs
+    if (config.planejar || config.memoria > 0) {
+        PlanoPi plano;
+        planejar_pi(config.digitos, config.memoria, config.threads_definidas ? config.threads : 0, config.disco, &plano);
+        imprimir_plano_pi(&plano);
+        if (config.planejar) return plano.cabe ? 0 : 1;
+        if (aplicar_plano_pi(&plano, config.disco) != 0) return 1;
+        // O modo com fatores só encolhe os termos: cabe em qualquer plano sem ele
+        if (config.fatores) definir_modo_fatores(1);
+        config.threads = plano.threads;
+        printf("\n");
+    }
 
-int main() {
     printf("LTPi2 - Calculadora de Pi Sofisticada\n");
-    printf("Iniciando cálculo de 100.000 dígitos...\n");
+    printf("Iniciando cálculo de %d dígitos...\n", config.digitos);
     printf("Isso pode levar alguns minutos dependendo da máquina.\n");
+    if (config.nucleos != NULL) printf("Núcleos de blocos: %s\n", nucleos_ativos->nome);
+    if (config.fatores) printf("Binary splitting com fatores.\n");
+
+    if (config.memoria == 0) definir_numero_threads(config.threads);
+    if (config.cache != NULL) {
+        int disponiveis = configurar_cache_digitos(config.cache);
+        if (disponiveis < 0) return 1;
+        printf("Cache '%s': %d casas disponíveis.\n", config.cache, disponiveis);
+    }
+    if (config.checkpoint != NULL && config.combinar == 0) {
+        int salvas = configurar_checkpoint(config.checkpoint, config.intervalo, config.retomar);
+        if (salvas < 0) return 1;
+        if (config.retomar) printf("Retomando de '%s': %d subárvores salvas.\n", config.checkpoint, salvas);
+    }
+    if (config.combinar > 0) {
+        // Antes de abrir (e truncar) a saída
+        if (conferir_fatias_pi(config.digitos, config.combinar, config.checkpoint) != 0) {
+            printf("ERRO: Fatias incompletas em '%s'; nada foi calculado\n", config.checkpoint);
+            return 1;
+        }
+        printf("Combinando %d fatias de '%s'.\n", config.combinar, config.checkpoint);
+    }
 
-    clock_t inicio = clock();
-    
-    char *pi = calcular_pi(100);
-    
-    clock_t fim = clock();
-    double tempo_gasto = (double)(fim - inicio) / CLOCKS_PER_SEC;
-
-    printf("\nCálculo concluído em %.2f segundos.\n", tempo_gasto);
-    
-    // Salvar em arquivo
-    FILE *f = fopen("pi_100k_ltpi2.txt", "w");
-    if (f) {
-        fprintf(f, "%s", pi);
-        fclose(f);
-        printf("Resultado salvo em 'pi_100k_ltpi2.txt'.\n");
+    // Salvar em arquivo: os dígitos vão direto para o descritor, em fluxo
+    int falhou;
+    if (config.compacto) {
+        falhou = calcular_compacto();
     } else {
+        int fd = open(config.saida, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            printf("Erro ao salvar arquivo.\n");
+            return 1;
+        }
+        falhou = calcular_em_fd(fd);
+        if (close(fd) != 0) falhou = 1;
+    }
+
+    // Tempo de parede (clock() somaria a CPU de todas as threads)
+    TemposPi tempos;
+    obter_tempos_pi(&tempos);
+
+    if (config.cache != NULL && tempos.serie == 0 && !falhou) {
+        printf("\nServido do cache em %.4f segundos.\n", tempos.total);
+    } else {
+        printf("\nCálculo concluído em %.2f segundos.\n", tempos.total);
+        printf("  série %.2fs, fechamento %.2fs, conversão %.2fs\n", tempos.serie, tempos.fechamento, tempos.conversao);
+        if (config.checkpoint != NULL) printf("  checkpoints %.2fs (dentro da série)\n", tempos.checkpoint);
+        if (config.cache != NULL) printf("  cache estendido em %.2fs\n", tempos.cache);
+        imprimir_memoria();
+    }
+
+    if (falhou) {
         printf("Erro ao salvar arquivo.\n");
+        return 1;
     }
-    
-    // Mostrar primeiros e últimos dígitos
-    printf("Primeiros 50 dígitos: %.50s...\n", pi);
-    
-    free(pi);
-    return 0;
+    printf("Resultado salvo em '%s'.\n", config.saida);
+
+    // Mostrar primeiros dígitos (lidos de volta do arquivo)
+    char inicio_pi[51] = "3.";
+    int casas = (config.digitos < 48) ? config.digitos : 48;
+    if (ler_casas_saida(0, (size_t)casas, inicio_pi + 2) == 0) printf("Primeiros 50 dígitos: %.*s...\n", casas + 2, inicio_pi);
+
+    return (config.verificar > 0) ? verificar_arquivo() : 0;
 }
@@ -0,0 +1,277 @@
+#include "ntt.h"
+#include "grandes_numeros.h"
+#include "tarefas.h"
+#include "armazenamento.h"
+#include <stdlib.h>
+#include <string.h>
+
+// --- MULTIPLICAÇÃO POR TRANSFORMADA NUMÉRICA (NTT) ---
+/*
+ * Transformada de Fourier sobre corpos finitos Z/pZ.
+ *
+ * Teoria:
+ * O produto de dois números é a convolução dos seus vetores de blocos
+ * seguida da propagação de carry. A convolução pode ser calculada em
+ * O(N log N) via transformada: C = INTT(NTT(A) .* NTT(B)).
+ *
+ * Cada coeficiente da convolução é no máximo min(na, nb) * (2^32 - 1)^2,
+ * valor que não cabe em um único primo de 32 bits. Por isso a convolução é
+ * calculada módulo três primos da forma c*2^k + 1 e reconstruída pelo
+ * Teorema Chinês do Resto (algoritmo de Garner):
+ *   p0 = 15*2^27 + 1 = 2013265921  (raiz primitiva 31)
+ *   p1 =  7*2^26 + 1 =  469762049  (raiz primitiva 3)
+ *   p2 =  5*2^25 + 1 =  167772161  (raiz primitiva 3)
+ * p0*p1*p2 ~ 2^87: com o menor operando limitado a 2^22 blocos, cada
+ * coeficiente fica abaixo de 2^86 e é reconstruído sem ambiguidade.
+ *
+ * A aritmética modular usa redução de Montgomery (R = 2^32), evitando
+ * divisões no laço interno. A transformada direta é decimação em frequência
+ * (saída em ordem bit-reversa) e a inversa é decimação no tempo (entrada em
+ * ordem bit-reversa), de modo que nenhuma permutação explícita é necessária.
+ *
+ * Complexidade: O(N log N)
+ */
+
+typedef struct {
+    uint32_t p;           // Módulo primo
+    uint32_t p_inv_neg;   // -p^(-1) mod 2^32
+    uint32_t r2;          // R^2 mod p (para entrar na forma de Montgomery)
+    uint32_t um;          // R mod p (o valor 1 na forma de Montgomery)
+    uint32_t raiz;        // Raiz primitiva módulo p
+} PrimoNTT;
+
+#define NUM_PRIMOS_NTT 3
+
+static const uint32_t primos_ntt[NUM_PRIMOS_NTT] = { 2013265921u, 469762049u, 167772161u };
+static const uint32_t raizes_ntt[NUM_PRIMOS_NTT] = { 31u, 3u, 3u };
+
+static void inicializar_primo(PrimoNTT *pr, uint32_t p, uint32_t raiz) {
+    // Inverso de p módulo 2^32 por iteração de Newton (cada passo dobra os bits corretos)
+    uint32_t inv = p;
+    for (int i = 0; i < 4; i++) inv *= 2 - p * inv;
+
+    pr->p = p;
+    pr->p_inv_neg = (uint32_t)(0u - inv);
+    pr->um = (uint32_t)((1ULL << 32) % p);
+    pr->r2 = (uint32_t)((0ULL - (uint64_t)p) % p);  // 2^64 mod p
+    pr->raiz = raiz;
+}
+
+// Redução de Montgomery: retorna t * R^(-1) mod p, para t < p * R
+static inline uint32_t reduzir_montgomery(const PrimoNTT *pr, uint64_t t) {
+    uint32_t m = (uint32_t)t * pr->p_inv_neg;
+    uint32_t r = (uint32_t)((t + (uint64_t)m * pr->p) >> 32);
+    return (r >= pr->p) ? r - pr->p : r;
+}
+
+static inline uint32_t mult_mont(const PrimoNTT *pr, uint32_t a, uint32_t b) {
+    return reduzir_montgomery(pr, (uint64_t)a * b);
+}
+
+static inline uint32_t somar_mod(const PrimoNTT *pr, uint32_t a, uint32_t b) {
+    uint32_t s = a + b;
+    return (s >= pr->p) ? s - pr->p : s;
+}
+
+static inline uint32_t subtrair_mod(const PrimoNTT *pr, uint32_t a, uint32_t b) {
+    return (a >= b) ? a - b : a + pr->p - b;
+}
+
+static inline uint32_t para_montgomery(const PrimoNTT *pr, uint32_t a) {
+    return mult_mont(pr, a, pr->r2);
+}
+
+static uint32_t potencia_mont(const PrimoNTT *pr, uint32_t base_mont, uint64_t expoente) {
+    uint32_t res = pr->um;
+    while (expoente > 0) {
+        if (expoente & 1) res = mult_mont(pr, res, base_mont);
+        base_mont = mult_mont(pr, base_mont, base_mont);
+        expoente >>= 1;
+    }
+    return res;
+}
+
+// Inverso modular simples (exponenciação por p-2), fora da forma de Montgomery
+static uint32_t inverso_mod(uint32_t a, uint32_t p) {
+    uint64_t res = 1, base = a % p;
+    uint32_t e = p - 2;
+    while (e > 0) {
+        if (e & 1) res = res * base % p;
+        base = base * base % p;
+        e >>= 1;
+    }
+    return (uint32_t)res;
+}
+
+// Tabela de raízes: para cada estágio de meio-comprimento 'len', as posições
+// [len, 2*len) guardam w^j, j = 0..len-1, onde w é raiz primitiva de ordem 2*len.
+// Todas as entradas ficam na forma de Montgomery.
+static void preparar_raizes(const PrimoNTT *pr, uint32_t *tabela, int n, int inversa) {
+    uint32_t g = para_montgomery(pr, pr->raiz);
+    for (int len = 1; len < n; len <<= 1) {
+        uint32_t w = potencia_mont(pr, g, (pr->p - 1) / (2 * (uint64_t)len));
+        if (inversa) w = potencia_mont(pr, w, 2 * (uint64_t)len - 1);
+        uint32_t atual = pr->um;
+        for (int j = 0; j < len; j++) {
+            tabela[len + j] = atual;
+            atual = mult_mont(pr, atual, w);
+        }
+    }
+}
+
+// Transformada direta (Gentleman-Sande): entrada natural, saída bit-reversa
+static void ntt_direta(const PrimoNTT *pr, uint32_t *a, int n, const uint32_t *raizes) {
+    for (int len = n >> 1; len >= 1; len >>= 1) {
+        const uint32_t *w = raizes + len;
+        for (int i = 0; i < n; i += 2 * len) {
+            uint32_t *x = a + i;
+            uint32_t *y = a + i + len;
+            for (int j = 0; j < len; j++) {
+                uint32_t u = x[j];
+                uint32_t v = y[j];
+                x[j] = somar_mod(pr, u, v);
+                y[j] = mult_mont(pr, subtrair_mod(pr, u, v), w[j]);
+            }
+        }
+    }
+}
+
+// Transformada inversa (Cooley-Tukey): entrada bit-reversa, saída natural (sem o fator 1/n)
+static void ntt_inversa(const PrimoNTT *pr, uint32_t *a, int n, const uint32_t *raizes) {
+    for (int len = 1; len < n; len <<= 1) {
+        const uint32_t *w = raizes + len;
+        for (int i = 0; i < n; i += 2 * len) {
+            uint32_t *x = a + i;
+            uint32_t *y = a + i + len;
+            for (int j = 0; j < len; j++) {
+                uint32_t u = x[j];
+                uint32_t v = mult_mont(pr, y[j], w[j]);
+                x[j] = somar_mod(pr, u, v);
+                y[j] = subtrair_mod(pr, u, v);
+            }
+        }
+    }
+}
+
+// Convolução completa módulo um primo. Resultado (fora da forma de Montgomery) em 'saida'.
+// Com b == NULL calcula o quadrado de a: uma única transformada direta, sem 'temp'.
+static void convolucao_primo(const PrimoNTT *pr, const uint32_t *a, int na, const uint32_t *b, int nb,
+                             uint32_t *saida, uint32_t *temp, uint32_t *raizes, int n) {
+    for (int i = 0; i < na; i++) saida[i] = para_montgomery(pr, a[i]);
+    memset(saida + na, 0, (size_t)(n - na) * sizeof(uint32_t));
+
+    preparar_raizes(pr, raizes, n, 0);
+    ntt_direta(pr, saida, n, raizes);
+
+    if (b == NULL) {
+        for (int i = 0; i < n; i++) saida[i] = mult_mont(pr, saida[i], saida[i]);
+    } else {
+        for (int i = 0; i < nb; i++) temp[i] = para_montgomery(pr, b[i]);
+        memset(temp + nb, 0, (size_t)(n - nb) * sizeof(uint32_t));
+        ntt_direta(pr, temp, n, raizes);
+        for (int i = 0; i < n; i++) saida[i] = mult_mont(pr, saida[i], temp[i]);
+    }
+
+    preparar_raizes(pr, raizes, n, 1);
+    ntt_inversa(pr, saida, n, raizes);
+
+    // Multiplicar por n^(-1) (forma normal) e sair da forma de Montgomery numa só redução
+    uint32_t n_inv = inverso_mod((uint32_t)(n % pr->p), pr->p);
+    for (int i = 0; i < n; i++) saida[i] = mult_mont(pr, saida[i], n_inv);
+}
+
+// Argumentos de uma convolução módulo um primo executada como tarefa do pool
+typedef struct {
+    PrimoNTT primo;
+    const uint32_t *a, *b;
+    int na, nb, n;
+    uint32_t *saida, *temp, *raizes;
+} ConvolucaoPrimo;
+
+static void executar_convolucao_primo(void *argumento) {
+    ConvolucaoPrimo *c = (ConvolucaoPrimo*)argumento;
+    convolucao_primo(&c->primo, c->a, c->na, c->b, c->nb, c->saida, c->temp, c->raizes, c->n);
+}
+
+int multiplicar_ntt_blocos(const uint32_t *a, int na, const uint32_t *b, int nb, uint32_t *resultado) {
+    int tamanho_produto = na + nb;
+    if (tamanho_produto > NTT_TAMANHO_MAXIMO) return -1;
+    if ((na < nb ? na : nb) > NTT_MENOR_OPERANDO_MAXIMO) return -1;
+
+    int n = 1;
+    while (n < tamanho_produto - 1) n <<= 1;
+
+    // Quadrados dispensam a segunda transformada direta (e o buffer dela)
+    int quadrado = (a == b && na == nb);
+
+    // Com o pool de tarefas ativo, os três primos são independentes e rodam em
+    // paralelo (cada um com seus próprios buffers); no modo serial os buffers
+    // auxiliares são compartilhados para economizar memória
+    int paralelo = pool_tarefas_ativo();
+    int buffers_auxiliares = paralelo ? NUM_PRIMOS_NTT : 1;
+
+    uint32_t *residuos = armazenamento_alocar_rascunho((size_t)NUM_PRIMOS_NTT * n);
+    uint32_t *temp = quadrado ? NULL : armazenamento_alocar_rascunho((size_t)buffers_auxiliares * n);
+    uint32_t *raizes = armazenamento_alocar_rascunho((size_t)buffers_auxiliares * n);
+    if (residuos == NULL || (temp == NULL && !quadrado) || raizes == NULL) {
+        armazenamento_liberar(residuos);
+        armazenamento_liberar(temp);
+        armazenamento_liberar(raizes);
+        return -1;
+    }
+
+    ConvolucaoPrimo convolucoes[NUM_PRIMOS_NTT];
+    Tarefa tarefas[NUM_PRIMOS_NTT];
+    for (int k = 0; k < NUM_PRIMOS_NTT; k++) {
+        ConvolucaoPrimo *c = &convolucoes[k];
+        inicializar_primo(&c->primo, primos_ntt[k], raizes_ntt[k]);
+        c->a = a;
+        c->na = na;
+        c->b = quadrado ? NULL : b;
+        c->nb = nb;
+        c->n = n;
+        c->saida = residuos + (size_t)k * n;
+        c->temp = quadrado ? NULL : temp + (size_t)(paralelo ? k : 0) * n;
+        c->raizes = raizes + (size_t)(paralelo ? k : 0) * n;
+    }
+    if (paralelo) {
+        for (int k = 1; k < NUM_PRIMOS_NTT; k++) tarefa_criar(&tarefas[k], executar_convolucao_primo, &convolucoes[k]);
+        executar_convolucao_primo(&convolucoes[0]);
+        for (int k = 1; k < NUM_PRIMOS_NTT; k++) tarefa_aguardar(&tarefas[k]);
+    } else {
+        for (int k = 0; k < NUM_PRIMOS_NTT; k++) executar_convolucao_primo(&convolucoes[k]);
+    }
+
+    // Reconstrução CRT (Garner) e propagação de carry na base 2^32
+    const uint64_t p0 = primos_ntt[0], p1 = primos_ntt[1], p2 = primos_ntt[2];
+    const uint64_t inv_p0_mod_p1 = inverso_mod((uint32_t)(p0 % p1), (uint32_t)p1);
+    const uint64_t inv_p0_mod_p2 = inverso_mod((uint32_t)(p0 % p2), (uint32_t)p2);
+    const uint64_t inv_p1_mod_p2 = inverso_mod((uint32_t)(p1 % p2), (uint32_t)p2);
+    const uint32_t *r0 = residuos;
+    const uint32_t *r1 = residuos + n;
+    const uint32_t *r2 = residuos + 2 * (size_t)n;
+
+    unsigned __int128 carry = 0;
+    for (int i = 0; i < tamanho_produto; i++) {
+        unsigned __int128 cur = carry;
+        if (i < tamanho_produto - 1) {
+            uint64_t v0 = r0[i];
+            uint64_t v1 = (r1[i] + p1 - v0 % p1) % p1 * inv_p0_mod_p1 % p1;
+            uint64_t v2 = (r2[i] + p2 - v0 % p2) % p2 * inv_p0_mod_p2 % p2;
+            v2 = (v2 + p2 - v1 % p2) % p2 * inv_p1_mod_p2 % p2;
+            cur += v0 + (unsigned __int128)v1 * p0 + (unsigned __int128)v2 * (p0 * p1);
+        }
+
+        resultado[i] = (uint32_t)cur;
+        carry = cur >> BITS_POR_BLOCO;
+    }
+
+    armazenamento_liberar(residuos);
+    armazenamento_liberar(temp);
+    armazenamento_liberar(raizes);
+    return 0;
+}
+
+int elevar_ao_quadrado_ntt_blocos(const uint32_t *a, int na, uint32_t *resultado) {
+    return multiplicar_ntt_blocos(a, na, a, na, resultado);
+}
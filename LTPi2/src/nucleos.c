@@ -0,0 +1,646 @@
+#include "nucleos.h"
+#include "grandes_numeros.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define NUCLEOS_X86 1
+#include <immintrin.h>
+#endif
+
+// --- NÚCLEOS BÁSICOS COM SIMD ---
+/*
+ * Soma e subtração: cada faixa do vetor soma seus blocos de forma
+ * independente; o carry entre faixas sai de duas máscaras de bits, g (a
+ * faixa estourou sozinha) e p (a faixa estoura se receber +1, soma ==
+ * 0xFFFFFFFF). O carry que entra em cada faixa é exatamente o carry da soma
+ * binária (g | p) + g + carry_entrada, então uma soma escalar sobre as
+ * máscaras resolve a cadeia do vetor inteiro, e as faixas marcadas recebem +1.
+ *
+ * Multiplicação por um bloco: os produtos de 64 bits de cada faixa são
+ * separados em metade baixa e alta; a alta vai para a faixa seguinte, e a
+ * soma das duas usa a mesma propagação de carry.
+ *
+ * Multiplicação e quadrado O(n·m): acumulação por colunas com carry adiado.
+ * Um vetor cobre W colunas consecutivas do produto; para cada bloco l_i do
+ * operando maior (difundido), as W faixas recebem l_i · s_(coluna - i), lidos
+ * de uma cópia do operando menor com W - 1 zeros de cada lado. As metades
+ * baixa e alta de cada produto de 32x32 bits são somadas em acumuladores de
+ * 64 bits separados, que comportam 2^32 parcelas sem estourar; os carries só
+ * são resolvidos uma vez por coluna, numa passada escalar que também escreve
+ * o resultado. Nada é gravado na memória no laço interno. A versão escalar
+ * faz o mesmo uma coluna por vez (Comba) quando os dois operandos têm pelo
+ * menos COMBA_MINIMO blocos.
+ *
+ * Com IFMA, vpmadd52luq/vpmadd52huq multiplicam e acumulam as partes baixa
+ * (52 bits) e alta do produto numa instrução cada. A parte alta pesa
+ * 2^52 = 2^32 · 2^20 e vai para a coluna seguinte deslocada de 20 bits.
+ *
+ * As versões são escolhidas na carga do programa por cpuid
+ * (__builtin_cpu_supports); as funções usam atributos target, então o resto
+ * do projeto continua compilado para a arquitetura base.
+ */
+
+// Acima disto (blocos do operando menor) os acumuladores de coluna poderiam estourar
+#define COLUNA_MAXIMA (1 << 28)
+// Com IFMA cada parcela baixa tem até 52 bits: no máximo 2^11 parcelas por coluna
+#define COLUNA_MAXIMA_IFMA 2048
+// Cópias com bordas de até este tamanho ficam na pilha
+#define BORDAS_PILHA 1024
+// Abaixo disto (blocos do operando menor) a versão escalar multiplica por linhas
+#define COMBA_MINIMO 12
+
+// --- VERSÃO ESCALAR ---
+
+static uint32_t somar_escalar(uint32_t *r, const uint32_t *a, const uint32_t *b, int n, uint32_t carry) {
+    uint64_t c = carry;
+    for (int i = 0; i < n; i++) {
+        uint64_t soma = (uint64_t)a[i] + b[i] + c;
+        r[i] = (uint32_t)soma;
+        c = soma >> BITS_POR_BLOCO;
+    }
+    return (uint32_t)c;
+}
+
+static uint32_t subtrair_escalar(uint32_t *r, const uint32_t *a, const uint32_t *b, int n, uint32_t emprestimo) {
+    uint64_t e = emprestimo;
+    for (int i = 0; i < n; i++) {
+        uint64_t diff = (uint64_t)a[i] - b[i] - e;
+        r[i] = (uint32_t)diff;
+        e = diff >> 63;
+    }
+    return (uint32_t)e;
+}
+
+static uint32_t multiplicar_1_escalar(uint32_t *r, const uint32_t *a, int n, uint32_t m) {
+    uint64_t carry = 0;
+    for (int i = 0; i < n; i++) {
+        uint64_t prod = (uint64_t)a[i] * m + carry;
+        r[i] = (uint32_t)prod;
+        carry = prod >> BITS_POR_BLOCO;
+    }
+    return (uint32_t)carry;
+}
+
+// Por linhas: uma passada sobre o operando maior l para cada bloco do menor
+// s; a primeira linha escreve, as demais acumulam
+static void multiplicar_linhas(uint32_t *r, const uint32_t *s, int ns, const uint32_t *l, int nl) {
+    r[nl] = multiplicar_1_escalar(r, l, nl, s[0]);
+
+    for (int i = 1; i < ns; i++) {
+        uint64_t si = s[i];
+        uint64_t carry = 0;
+        for (int j = 0; j < nl; j++) {
+            uint64_t cur = r[i + j] + si * l[j] + carry;
+            r[i + j] = (uint32_t)cur;
+            carry = cur >> BITS_POR_BLOCO;
+        }
+        r[i + nl] = (uint32_t)carry;
+    }
+}
+
+// Comba (varredura por produto): a coluna c soma a_i·b_(c-i) em dois
+// acumuladores de 64 bits, metades baixa e alta dos produtos, como nas
+// versões vetoriais. Cada bloco do resultado é normalizado e gravado uma
+// única vez, e o laço interno não lê nem escreve r nem tem desvios (os
+// limites da coluna vêm antes dele). Com o operando menor abaixo de
+// COMBA_MINIMO as colunas são curtas demais para pagar o fechamento de cada
+// uma, e as linhas ficam mais rápidas.
+static void multiplicar_escalar(uint32_t *r, const uint32_t *a, int na, const uint32_t *b, int nb) {
+    if (na < COMBA_MINIMO || nb < COMBA_MINIMO) {
+        if (na <= nb) multiplicar_linhas(r, a, na, b, nb);
+        else multiplicar_linhas(r, b, nb, a, na);
+        return;
+    }
+
+    uint64_t hi_anterior = 0, carry = 0;
+    int total = na + nb;
+    for (int c = 0; c < total; c++) {
+        int i0 = (c - nb + 1 > 0) ? c - nb + 1 : 0;
+        int i1 = (c < na - 1) ? c : na - 1;
+        uint64_t lo = 0, hi = 0;
+        for (int i = i0; i <= i1; i++) {
+            uint64_t p = (uint64_t)a[i] * b[c - i];
+            lo += (uint32_t)p;
+            hi += p >> BITS_POR_BLOCO;
+        }
+        uint64_t v = lo + hi_anterior + carry;
+        r[c] = (uint32_t)v;
+        carry = v >> BITS_POR_BLOCO;
+        hi_anterior = hi;
+    }
+}
+
+// Produtos cruzados calculados uma vez, depois dobrados junto com a diagonal
+static void quadrado_escalar(uint32_t *r, const uint32_t *a, int n) {
+    // Produtos cruzados: sum(a_i·a_j·B^(i+j), i < j)
+    memset(r, 0, 2 * (size_t)n * sizeof(uint32_t));
+    for (int i = 0; i < n - 1; i++) {
+        uint64_t ai = a[i];
+        uint64_t carry = 0;
+        for (int j = i + 1; j < n; j++) {
+            uint64_t cur = r[i + j] + ai * a[j] + carry;
+            r[i + j] = (uint32_t)cur;
+            carry = cur >> BITS_POR_BLOCO;
+        }
+        r[i + n] = (uint32_t)carry;
+    }
+
+    // Dobrar e somar a diagonal a_i² em uma passada
+    uint32_t bit_alto = 0;
+    uint64_t carry = 0;
+    for (int i = 0; i < n; i++) {
+        uint64_t quadrado = (uint64_t)a[i] * a[i];
+        uint32_t baixo = r[2 * i], alto = r[2 * i + 1];
+
+        uint64_t cur = (uint64_t)((baixo << 1) | bit_alto) + (uint32_t)quadrado + carry;
+        r[2 * i] = (uint32_t)cur;
+        carry = cur >> BITS_POR_BLOCO;
+
+        cur = (uint64_t)((alto << 1) | (baixo >> 31)) + (quadrado >> BITS_POR_BLOCO) + carry;
+        r[2 * i + 1] = (uint32_t)cur;
+        carry = cur >> BITS_POR_BLOCO;
+        bit_alto = alto >> 31;
+    }
+}
+
+static const NucleosBlocos nucleos_escalar = {
+    "escalar", somar_escalar, subtrair_escalar, multiplicar_1_escalar, multiplicar_escalar, quadrado_escalar
+};
+
+#ifdef NUCLEOS_X86
+
+// --- AUXILIARES COMUNS ÀS VERSÕES VETORIAIS ---
+
+// Resolve a cadeia de carry de 'faixas' faixas (ver o comentário do topo).
+// Retorna a máscara das faixas que recebem +1 e atualiza *carry com o que sai.
+static inline unsigned propagar_carry(unsigned g, unsigned p, uint32_t *carry, int faixas) {
+    unsigned z = (g | p) + g + *carry;
+    *carry = (z >> faixas) & 1;
+    return (z ^ p) & ((1u << faixas) - 1);
+}
+
+// Cópia de s[0..n) com 'borda' zeros antes e depois; NULL se faltou memória
+static uint32_t* copiar_com_bordas(const uint32_t *s, int n, int borda, uint32_t *pilha) {
+    size_t tamanho = (size_t)n + 2 * (size_t)borda;
+    uint32_t *copia = (tamanho <= BORDAS_PILHA) ? pilha : (uint32_t*)malloc(tamanho * sizeof(uint32_t));
+    if (copia == NULL) return NULL;
+    memset(copia, 0, (size_t)borda * sizeof(uint32_t));
+    memcpy(copia + borda, s, (size_t)n * sizeof(uint32_t));
+    memset(copia + borda + n, 0, (size_t)borda * sizeof(uint32_t));
+    return copia;
+}
+
+static void liberar_bordas(uint32_t *copia, uint32_t *pilha) {
+    if (copia != pilha) free(copia);
+}
+
+// Resolve os carries de até W colunas já acumuladas: coluna = lo + alto da
+// coluna anterior (deslocado de 'ajuste' bits) + carry
+static inline void fechar_colunas(uint32_t *r, const uint64_t *lo, const uint64_t *hi, int quantidade,
+                                  int ajuste, uint64_t *hi_anterior, uint64_t *carry) {
+    for (int k = 0; k < quantidade; k++) {
+        uint64_t v = lo[k] + (*hi_anterior << ajuste) + *carry;
+        r[k] = (uint32_t)v;
+        *carry = v >> BITS_POR_BLOCO;
+        *hi_anterior = hi[k];
+    }
+}
+
+// Como fechar_colunas, para os produtos cruzados de um quadrado: a coluna
+// vale o dobro dos cruzados mais a metade correspondente de a_(col/2)²
+static inline void fechar_colunas_quadrado(uint32_t *r, const uint32_t *a, int coluna, const uint64_t *lo, const uint64_t *hi,
+                                           int quantidade, uint64_t *hi_anterior, uint64_t *carry) {
+    for (int k = 0; k < quantidade; k++) {
+        int col = coluna + k;
+        uint64_t diagonal = (uint64_t)a[col >> 1] * a[col >> 1];
+        uint32_t parte = (col & 1) ? (uint32_t)(diagonal >> BITS_POR_BLOCO) : (uint32_t)diagonal;
+        uint64_t v = 2 * (lo[k] + *hi_anterior) + parte + *carry;
+        r[col] = (uint32_t)v;
+        *carry = v >> BITS_POR_BLOCO;
+        *hi_anterior = hi[k];
+    }
+}
+
+// --- VERSÃO AVX2 (8 faixas de 32 bits, 4 colunas de 64 bits) ---
+
+#define ALVO_AVX2 __attribute__((target("avx2")))
+
+// Vetor com todos os bits ligados nas faixas marcadas em 'mascara'
+ALVO_AVX2 static inline __m256i expandir_mascara_avx2(unsigned mascara) {
+    const __m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    return _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32((int)mascara), bits), bits);
+}
+
+// Máscara de bits de x < y (sem sinal), faixa a faixa
+ALVO_AVX2 static inline unsigned menor_sem_sinal_avx2(__m256i x, __m256i y) {
+    const __m256i sinal = _mm256_set1_epi32(INT32_MIN);
+    __m256i menor = _mm256_cmpgt_epi32(_mm256_xor_si256(y, sinal), _mm256_xor_si256(x, sinal));
+    return (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(menor));
+}
+
+ALVO_AVX2 static inline unsigned iguais_avx2(__m256i x, __m256i y) {
+    return (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(x, y)));
+}
+
+ALVO_AVX2 static uint32_t somar_avx2(uint32_t *r, const uint32_t *a, const uint32_t *b, int n, uint32_t carry) {
+    const __m256i uns = _mm256_set1_epi32(-1);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        __m256i s = _mm256_add_epi32(va, vb);
+        unsigned c = propagar_carry(menor_sem_sinal_avx2(s, va), iguais_avx2(s, uns), &carry, 8);
+        _mm256_storeu_si256((__m256i*)(r + i), _mm256_sub_epi32(s, expandir_mascara_avx2(c)));
+    }
+    return somar_escalar(r + i, a + i, b + i, n - i, carry);
+}
+
+ALVO_AVX2 static uint32_t subtrair_avx2(uint32_t *r, const uint32_t *a, const uint32_t *b, int n, uint32_t emprestimo) {
+    const __m256i zero = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        __m256i d = _mm256_sub_epi32(va, vb);
+        unsigned c = propagar_carry(menor_sem_sinal_avx2(va, vb), iguais_avx2(d, zero), &emprestimo, 8);
+        _mm256_storeu_si256((__m256i*)(r + i), _mm256_add_epi32(d, expandir_mascara_avx2(c)));
+    }
+    return subtrair_escalar(r + i, a + i, b + i, n - i, emprestimo);
+}
+
+ALVO_AVX2 static uint32_t multiplicar_1_avx2(uint32_t *r, const uint32_t *a, int n, uint32_t m) {
+    const __m256i vm = _mm256_set1_epi32((int)m);
+    const __m256i uns = _mm256_set1_epi32(-1);
+    const __m256i rotacao = _mm256_setr_epi32(7, 0, 1, 2, 3, 4, 5, 6);
+    __m256i hi_anterior = _mm256_setzero_si256();
+    uint32_t carry = 0;
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i pares = _mm256_mul_epu32(va, vm);
+        __m256i impares = _mm256_mul_epu32(_mm256_srli_epi64(va, 32), vm);
+        __m256i lo = _mm256_blend_epi32(pares, _mm256_slli_epi64(impares, 32), 0xAA);
+        __m256i hi = _mm256_blend_epi32(_mm256_srli_epi64(pares, 32), impares, 0xAA);
+
+        // A metade alta de cada faixa soma na seguinte; a faixa 0 recebe a última do vetor anterior
+        __m256i deslocado = _mm256_blend_epi32(_mm256_permutevar8x32_epi32(hi, rotacao),
+                                               _mm256_permutevar8x32_epi32(hi_anterior, rotacao), 0x01);
+        __m256i s = _mm256_add_epi32(lo, deslocado);
+        unsigned c = propagar_carry(menor_sem_sinal_avx2(s, lo), iguais_avx2(s, uns), &carry, 8);
+        _mm256_storeu_si256((__m256i*)(r + i), _mm256_sub_epi32(s, expandir_mascara_avx2(c)));
+        hi_anterior = hi;
+    }
+
+    // O restante segue no escalar, com o alto pendente da última faixa
+    uint64_t pendente = (uint64_t)(uint32_t)_mm256_extract_epi32(hi_anterior, 7) + carry;
+    for (; i < n; i++) {
+        uint64_t prod = (uint64_t)a[i] * m + pendente;
+        r[i] = (uint32_t)prod;
+        pendente = prod >> BITS_POR_BLOCO;
+    }
+    return (uint32_t)pendente;
+}
+
+ALVO_AVX2 static void multiplicar_avx2(uint32_t *r, const uint32_t *a, int na, const uint32_t *b, int nb) {
+    // O menor operando é lido em vetores; o maior é difundido bloco a bloco
+    const uint32_t *s = a, *l = b;
+    int ns = na, nl = nb;
+    if (ns > nl) {
+        s = b; ns = nb;
+        l = a; nl = na;
+    }
+    uint32_t pilha[BORDAS_PILHA];
+    uint32_t *copia = (ns >= 4 && ns <= COLUNA_MAXIMA) ? copiar_com_bordas(s, ns, 3, pilha) : NULL;
+    if (copia == NULL) {
+        multiplicar_escalar(r, a, na, b, nb);
+        return;
+    }
+
+    const __m256i mascara = _mm256_set1_epi64x(0xFFFFFFFF);
+    uint64_t hi_anterior = 0, carry = 0;
+    int total = ns + nl;
+    for (int c = 0; c < total; c += 4) {
+        int i0 = (c - ns + 1 > 0) ? c - ns + 1 : 0;
+        int i1 = (c + 3 < nl - 1) ? c + 3 : nl - 1;
+        const uint32_t *base = copia + 3 + c;   // faixa k de l_i usa s[c + k - i]
+
+        __m256i acc_lo = _mm256_setzero_si256(), acc_hi = _mm256_setzero_si256();
+        for (int i = i0; i <= i1; i++) {
+            __m256i vs = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)(base - i)));
+            __m256i p = _mm256_mul_epu32(vs, _mm256_set1_epi32((int)l[i]));
+            acc_lo = _mm256_add_epi64(acc_lo, _mm256_and_si256(p, mascara));
+            acc_hi = _mm256_add_epi64(acc_hi, _mm256_srli_epi64(p, 32));
+        }
+
+        uint64_t lo[4], hi[4];
+        _mm256_storeu_si256((__m256i*)lo, acc_lo);
+        _mm256_storeu_si256((__m256i*)hi, acc_hi);
+        fechar_colunas(r + c, lo, hi, (total - c < 4) ? total - c : 4, 0, &hi_anterior, &carry);
+    }
+    liberar_bordas(copia, pilha);
+}
+
+ALVO_AVX2 static void quadrado_avx2(uint32_t *r, const uint32_t *a, int n) {
+    uint32_t pilha[BORDAS_PILHA];
+    uint32_t *copia = (n >= 8 && n <= COLUNA_MAXIMA) ? copiar_com_bordas(a, n, 3, pilha) : NULL;
+    if (copia == NULL) {
+        quadrado_escalar(r, a, n);
+        return;
+    }
+
+    const __m256i mascara = _mm256_set1_epi64x(0xFFFFFFFF);
+    const __m256i faixa = _mm256_setr_epi64x(0, 1, 2, 3);
+    uint64_t hi_anterior = 0, carry = 0;
+    int total = 2 * n;
+    for (int c = 0; c < total; c += 4) {
+        // Só os cruzados a_i·a_j com j = coluna - i > i, isto é, faixa > 2i - c
+        int i = (c - n + 1 > 0) ? c - n + 1 : 0;
+        const uint32_t *base = copia + 3 + c;
+
+        __m256i acc_lo = _mm256_setzero_si256(), acc_hi = _mm256_setzero_si256();
+        for (; 2 * i + 1 <= c; i++) {
+            __m256i vs = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)(base - i)));
+            __m256i p = _mm256_mul_epu32(vs, _mm256_set1_epi32((int)a[i]));
+            acc_lo = _mm256_add_epi64(acc_lo, _mm256_and_si256(p, mascara));
+            acc_hi = _mm256_add_epi64(acc_hi, _mm256_srli_epi64(p, 32));
+        }
+        for (; 2 * i - c < 3 && i < n; i++) {
+            __m256i validas = _mm256_cmpgt_epi64(faixa, _mm256_set1_epi64x(2 * i - c));
+            __m256i vs = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)(base - i)));
+            __m256i p = _mm256_and_si256(_mm256_mul_epu32(vs, _mm256_set1_epi32((int)a[i])), validas);
+            acc_lo = _mm256_add_epi64(acc_lo, _mm256_and_si256(p, mascara));
+            acc_hi = _mm256_add_epi64(acc_hi, _mm256_srli_epi64(p, 32));
+        }
+
+        uint64_t lo[4], hi[4];
+        _mm256_storeu_si256((__m256i*)lo, acc_lo);
+        _mm256_storeu_si256((__m256i*)hi, acc_hi);
+        fechar_colunas_quadrado(r, a, c, lo, hi, (total - c < 4) ? total - c : 4, &hi_anterior, &carry);
+    }
+    liberar_bordas(copia, pilha);
+}
+
+static const NucleosBlocos nucleos_avx2 = {
+    "avx2", somar_avx2, subtrair_avx2, multiplicar_1_avx2, multiplicar_avx2, quadrado_avx2
+};
+
+// --- VERSÃO AVX-512 (16 faixas de 32 bits, 8 colunas de 64 bits) ---
+
+#define ALVO_AVX512 __attribute__((target("avx512f,avx512bw,avx512dq,avx512vl")))
+#define ALVO_IFMA __attribute__((target("avx512f,avx512bw,avx512dq,avx512vl,avx512ifma")))
+
+// Máscara das 'faixas' primeiras faixas (até 16)
+static inline unsigned mascara_faixas(int faixas) {
+    return (faixas >= 16) ? 0xFFFFu : (1u << faixas) - 1;
+}
+
+ALVO_AVX512 static uint32_t somar_avx512(uint32_t *r, const uint32_t *a, const uint32_t *b, int n, uint32_t carry) {
+    const __m512i uns = _mm512_set1_epi32(-1);
+    for (int i = 0; i < n; i += 16) {
+        int faixas = (n - i < 16) ? n - i : 16;
+        __mmask16 m = (__mmask16)mascara_faixas(faixas);
+        __m512i va = _mm512_maskz_loadu_epi32(m, a + i);
+        __m512i vb = _mm512_maskz_loadu_epi32(m, b + i);
+        __m512i s = _mm512_add_epi32(va, vb);
+        unsigned g = _mm512_mask_cmplt_epu32_mask(m, s, va);
+        unsigned p = _mm512_mask_cmpeq_epi32_mask(m, s, uns);
+        __mmask16 c = (__mmask16)propagar_carry(g, p, &carry, faixas);
+        _mm512_mask_storeu_epi32(r + i, m, _mm512_mask_sub_epi32(s, c, s, uns));
+    }
+    return carry;
+}
+
+ALVO_AVX512 static uint32_t subtrair_avx512(uint32_t *r, const uint32_t *a, const uint32_t *b, int n, uint32_t emprestimo) {
+    const __m512i uns = _mm512_set1_epi32(-1);
+    const __m512i zero = _mm512_setzero_si512();
+    for (int i = 0; i < n; i += 16) {
+        int faixas = (n - i < 16) ? n - i : 16;
+        __mmask16 m = (__mmask16)mascara_faixas(faixas);
+        __m512i va = _mm512_maskz_loadu_epi32(m, a + i);
+        __m512i vb = _mm512_maskz_loadu_epi32(m, b + i);
+        __m512i d = _mm512_sub_epi32(va, vb);
+        unsigned g = _mm512_mask_cmplt_epu32_mask(m, va, vb);
+        unsigned p = _mm512_mask_cmpeq_epi32_mask(m, d, zero);
+        __mmask16 c = (__mmask16)propagar_carry(g, p, &emprestimo, faixas);
+        _mm512_mask_storeu_epi32(r + i, m, _mm512_mask_add_epi32(d, c, d, uns));
+    }
+    return emprestimo;
+}
+
+ALVO_AVX512 static inline uint32_t faixa_avx512(__m512i v, int k) {
+    return (uint32_t)_mm_cvtsi128_si32(_mm512_castsi512_si128(_mm512_permutexvar_epi32(_mm512_set1_epi32(k), v)));
+}
+
+ALVO_AVX512 static uint32_t multiplicar_1_avx512(uint32_t *r, const uint32_t *a, int n, uint32_t m) {
+    const __m512i vm = _mm512_set1_epi32((int)m);
+    const __m512i uns = _mm512_set1_epi32(-1);
+    __m512i hi_anterior = _mm512_setzero_si512();
+    uint32_t carry = 0;
+    for (int i = 0; i < n; i += 16) {
+        int faixas = (n - i < 16) ? n - i : 16;
+        __mmask16 mascara = (__mmask16)mascara_faixas(faixas);
+        __m512i va = _mm512_maskz_loadu_epi32(mascara, a + i);
+        __m512i pares = _mm512_mul_epu32(va, vm);
+        __m512i impares = _mm512_mul_epu32(_mm512_srli_epi64(va, 32), vm);
+        __m512i lo = _mm512_mask_blend_epi32(0xAAAA, pares, _mm512_slli_epi64(impares, 32));
+        __m512i hi = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(pares, 32), impares);
+
+        // Faixa 0 recebe a última metade alta do vetor anterior
+        __m512i deslocado = _mm512_alignr_epi32(hi, hi_anterior, 15);
+        __m512i s = _mm512_add_epi32(lo, deslocado);
+        unsigned g = _mm512_mask_cmplt_epu32_mask(mascara, s, lo);
+        unsigned p = _mm512_mask_cmpeq_epi32_mask(mascara, s, uns);
+        __mmask16 c = (__mmask16)propagar_carry(g, p, &carry, faixas);
+        _mm512_mask_storeu_epi32(r + i, mascara, _mm512_mask_sub_epi32(s, c, s, uns));
+
+        // Vetor parcial: o bloco mais alto é a metade alta da última faixa mais o carry
+        if (faixas < 16) return faixa_avx512(hi, faixas - 1) + carry;
+        hi_anterior = hi;
+    }
+    return faixa_avx512(hi_anterior, 15) + carry;
+}
+
+ALVO_AVX512 static void multiplicar_avx512(uint32_t *r, const uint32_t *a, int na, const uint32_t *b, int nb) {
+    const uint32_t *s = a, *l = b;
+    int ns = na, nl = nb;
+    if (ns > nl) {
+        s = b; ns = nb;
+        l = a; nl = na;
+    }
+    uint32_t pilha[BORDAS_PILHA];
+    uint32_t *copia = (ns >= 4 && ns <= COLUNA_MAXIMA) ? copiar_com_bordas(s, ns, 7, pilha) : NULL;
+    if (copia == NULL) {
+        multiplicar_escalar(r, a, na, b, nb);
+        return;
+    }
+
+    const __m512i mascara = _mm512_set1_epi64(0xFFFFFFFF);
+    uint64_t hi_anterior = 0, carry = 0;
+    int total = ns + nl;
+    for (int c = 0; c < total; c += 8) {
+        int i0 = (c - ns + 1 > 0) ? c - ns + 1 : 0;
+        int i1 = (c + 7 < nl - 1) ? c + 7 : nl - 1;
+        const uint32_t *base = copia + 7 + c;
+
+        __m512i acc_lo = _mm512_setzero_si512(), acc_hi = _mm512_setzero_si512();
+        for (int i = i0; i <= i1; i++) {
+            __m512i vs = _mm512_cvtepu32_epi64(_mm256_loadu_si256((const __m256i*)(base - i)));
+            __m512i p = _mm512_mul_epu32(vs, _mm512_set1_epi32((int)l[i]));
+            acc_lo = _mm512_add_epi64(acc_lo, _mm512_and_si512(p, mascara));
+            acc_hi = _mm512_add_epi64(acc_hi, _mm512_srli_epi64(p, 32));
+        }
+
+        uint64_t lo[8], hi[8];
+        _mm512_storeu_si512(lo, acc_lo);
+        _mm512_storeu_si512(hi, acc_hi);
+        fechar_colunas(r + c, lo, hi, (total - c < 8) ? total - c : 8, 0, &hi_anterior, &carry);
+    }
+    liberar_bordas(copia, pilha);
+}
+
+ALVO_AVX512 static void quadrado_avx512(uint32_t *r, const uint32_t *a, int n) {
+    uint32_t pilha[BORDAS_PILHA];
+    uint32_t *copia = (n >= 8 && n <= COLUNA_MAXIMA) ? copiar_com_bordas(a, n, 7, pilha) : NULL;
+    if (copia == NULL) {
+        quadrado_escalar(r, a, n);
+        return;
+    }
+
+    const __m512i mascara = _mm512_set1_epi64(0xFFFFFFFF);
+    uint64_t hi_anterior = 0, carry = 0;
+    int total = 2 * n;
+    for (int c = 0; c < total; c += 8) {
+        int i = (c - n + 1 > 0) ? c - n + 1 : 0;
+        const uint32_t *base = copia + 7 + c;
+
+        __m512i acc_lo = _mm512_setzero_si512(), acc_hi = _mm512_setzero_si512();
+        for (; 2 * i + 1 <= c; i++) {
+            __m512i vs = _mm512_cvtepu32_epi64(_mm256_loadu_si256((const __m256i*)(base - i)));
+            __m512i p = _mm512_mul_epu32(vs, _mm512_set1_epi32((int)a[i]));
+            acc_lo = _mm512_add_epi64(acc_lo, _mm512_and_si512(p, mascara));
+            acc_hi = _mm512_add_epi64(acc_hi, _mm512_srli_epi64(p, 32));
+        }
+        for (; 2 * i - c < 7 && i < n; i++) {
+            // Faixas k > 2i - c
+            __mmask8 validas = (__mmask8)(0xFFu << (2 * i - c + 1));
+            __m512i vs = _mm512_cvtepu32_epi64(_mm256_loadu_si256((const __m256i*)(base - i)));
+            __m512i p = _mm512_maskz_mul_epu32(validas, vs, _mm512_set1_epi32((int)a[i]));
+            acc_lo = _mm512_add_epi64(acc_lo, _mm512_and_si512(p, mascara));
+            acc_hi = _mm512_add_epi64(acc_hi, _mm512_srli_epi64(p, 32));
+        }
+
+        uint64_t lo[8], hi[8];
+        _mm512_storeu_si512(lo, acc_lo);
+        _mm512_storeu_si512(hi, acc_hi);
+        fechar_colunas_quadrado(r, a, c, lo, hi, (total - c < 8) ? total - c : 8, &hi_anterior, &carry);
+    }
+    liberar_bordas(copia, pilha);
+}
+
+ALVO_IFMA static void multiplicar_ifma(uint32_t *r, const uint32_t *a, int na, const uint32_t *b, int nb) {
+    const uint32_t *s = a, *l = b;
+    int ns = na, nl = nb;
+    if (ns > nl) {
+        s = b; ns = nb;
+        l = a; nl = na;
+    }
+    if (ns > COLUNA_MAXIMA_IFMA) {
+        multiplicar_avx512(r, a, na, b, nb);
+        return;
+    }
+    uint32_t pilha[BORDAS_PILHA];
+    uint32_t *copia = (ns >= 4) ? copiar_com_bordas(s, ns, 7, pilha) : NULL;
+    if (copia == NULL) {
+        multiplicar_escalar(r, a, na, b, nb);
+        return;
+    }
+
+    // Acumuladores: lo com os 52 bits baixos de cada produto, hi com os bits 52..63
+    uint64_t hi_anterior = 0, carry = 0;
+    int total = ns + nl;
+    for (int c = 0; c < total; c += 8) {
+        int i0 = (c - ns + 1 > 0) ? c - ns + 1 : 0;
+        int i1 = (c + 7 < nl - 1) ? c + 7 : nl - 1;
+        const uint32_t *base = copia + 7 + c;
+
+        __m512i acc_lo = _mm512_setzero_si512(), acc_hi = _mm512_setzero_si512();
+        for (int i = i0; i <= i1; i++) {
+            __m512i vs = _mm512_cvtepu32_epi64(_mm256_loadu_si256((const __m256i*)(base - i)));
+            __m512i vl = _mm512_set1_epi64((long long)l[i]);
+            acc_lo = _mm512_madd52lo_epu64(acc_lo, vs, vl);
+            acc_hi = _mm512_madd52hi_epu64(acc_hi, vs, vl);
+        }
+
+        uint64_t lo[8], hi[8];
+        _mm512_storeu_si512(lo, acc_lo);
+        _mm512_storeu_si512(hi, acc_hi);
+        fechar_colunas(r + c, lo, hi, (total - c < 8) ? total - c : 8, 52 - BITS_POR_BLOCO, &hi_anterior, &carry);
+    }
+    liberar_bordas(copia, pilha);
+}
+
+static const NucleosBlocos nucleos_avx512 = {
+    "avx512", somar_avx512, subtrair_avx512, multiplicar_1_avx512, multiplicar_avx512, quadrado_avx512
+};
+
+static const NucleosBlocos nucleos_avx512ifma = {
+    "avx512ifma", somar_avx512, subtrair_avx512, multiplicar_1_avx512, multiplicar_ifma, quadrado_avx512
+};
+
+#endif // NUCLEOS_X86
+
+// --- ESCOLHA DA VERSÃO ---
+
+// Da mais simples para a mais larga
+static const NucleosBlocos *const todas_versoes[] = {
+    &nucleos_escalar,
+#ifdef NUCLEOS_X86
+    &nucleos_avx2,
+    &nucleos_avx512,
+    &nucleos_avx512ifma,
+#endif
+};
+#define NUM_VERSOES ((int)(sizeof(todas_versoes) / sizeof(todas_versoes[0])))
+
+const NucleosBlocos *nucleos_ativos = &nucleos_escalar;
+static int escolha_explicita = 0;
+
+static int versao_suportada(const NucleosBlocos *versao) {
+#ifdef NUCLEOS_X86
+    __builtin_cpu_init();
+    int avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+                 __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl");
+    if (versao == &nucleos_avx2) return __builtin_cpu_supports("avx2");
+    if (versao == &nucleos_avx512) return avx512;
+    if (versao == &nucleos_avx512ifma) return avx512 && __builtin_cpu_supports("avx512ifma");
+#endif
+    return versao == &nucleos_escalar;
+}
+
+int listar_nucleos(const NucleosBlocos **lista, int maximo) {
+    int n = 0;
+    for (int i = 0; i < NUM_VERSOES && n < maximo; i++) {
+        if (versao_suportada(todas_versoes[i])) lista[n++] = todas_versoes[i];
+    }
+    return n;
+}
+
+int definir_nucleos(const char *nome) {
+    for (int i = 0; i < NUM_VERSOES; i++) {
+        if (strcmp(todas_versoes[i]->nome, nome) == 0 && versao_suportada(todas_versoes[i])) {
+            nucleos_ativos = todas_versoes[i];
+            escolha_explicita = 1;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// Na carga do programa: a versão mais larga que a CPU suporta
+__attribute__((constructor)) static void escolher_nucleos(void) {
+    if (escolha_explicita) return;
+    const NucleosBlocos *lista[NUM_VERSOES];
+    int n = listar_nucleos(lista, NUM_VERSOES);
+    nucleos_ativos = lista[n - 1];
+}
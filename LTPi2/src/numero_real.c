@@ -0,0 +1,146 @@
+#include "numero_real.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+// --- NÚMEROS REAIS DE PRECISÃO FIXA ---
+/*
+ * A mantissa é um GrandeNumero comum e o expoente conta blocos de 32 bits.
+ *
+ * As operações truncadas não copiam os operandos: os blocos mais
+ * significativos de cada mantissa são lidos por uma "visão" (um GrandeNumero
+ * que aponta para o meio do vetor original), e só o resultado é alocado.
+ * Um bloco de guarda extra nos operandos absorve o erro do truncamento.
+ *
+ * Erro: cada operação com precisão p introduz erro relativo menor que
+ * β^-(p-1); uma sequência de k operações fica abaixo de k·β^-(p-1).
+ */
+
+int precisao_para_digitos(long digitos) {
+    return (int)ceil((double)digitos * log2(10.0) / BITS_POR_BLOCO) + 1;
+}
+
+NumeroReal* criar_numero_real(void) {
+    NumeroReal *numero = (NumeroReal*)malloc(sizeof(NumeroReal));
+    if (numero == NULL) return NULL;
+    numero->mantissa = criar_grande_numero(1);
+    numero->expoente = 0;
+    return numero;
+}
+
+void liberar_numero_real(NumeroReal *numero) {
+    if (numero != NULL) {
+        liberar_grande_numero(numero->mantissa);
+        free(numero);
+    }
+}
+
+// Visão (sem cópia) dos 'blocos' blocos mais significativos de 'valor';
+// 'corte' recebe quantos blocos inferiores ficaram de fora
+static GrandeNumero visao_superior(const GrandeNumero *valor, int blocos, long *corte) {
+    GrandeNumero visao = *valor;
+    int excesso = valor->quantidade_blocos - blocos;
+    *corte = 0;
+    if (excesso > 0) {
+        visao.blocos += excesso;
+        visao.quantidade_blocos = blocos;
+        visao.capacidade = blocos;
+        *corte = excesso;
+    }
+    return visao;
+}
+
+// Substitui a mantissa do resultado (que pode ser um dos operandos)
+static void trocar_mantissa(NumeroReal *numero, GrandeNumero *mantissa, long expoente) {
+    liberar_grande_numero(numero->mantissa);
+    numero->mantissa = mantissa;
+    numero->expoente = expoente;
+}
+
+void real_de_inteiro(NumeroReal *numero, int valor) {
+    definir_valor_inteiro(numero->mantissa, valor);
+    numero->expoente = 0;
+}
+
+void real_de_grande_numero(NumeroReal *numero, const GrandeNumero *valor, int precisao) {
+    long corte;
+    GrandeNumero visao = visao_superior(valor, precisao, &corte);
+    copiar_grande_numero(numero->mantissa, &visao);
+    numero->expoente = corte;
+}
+
+void real_deslocar_blocos(NumeroReal *numero, long k) {
+    numero->expoente += k;
+}
+
+void real_truncar(NumeroReal *numero, int precisao) {
+    int excesso = numero->mantissa->quantidade_blocos - precisao;
+    if (excesso > 0) {
+        deslocar_blocos(numero->mantissa, -excesso, numero->mantissa);
+        numero->expoente += excesso;
+    }
+}
+
+void real_multiplicar(const NumeroReal *a, const NumeroReal *b, NumeroReal *resultado, int precisao) {
+    long corte_a, corte_b;
+    GrandeNumero va = visao_superior(a->mantissa, precisao + 1, &corte_a);
+    GrandeNumero vb = visao_superior(b->mantissa, precisao + 1, &corte_b);
+
+    GrandeNumero *produto = criar_grande_numero(va.quantidade_blocos + vb.quantidade_blocos);
+    multiplicar_grandes_numeros(&va, &vb, produto);
+
+    trocar_mantissa(resultado, produto, a->expoente + corte_a + b->expoente + corte_b);
+    real_truncar(resultado, precisao);
+}
+
+void real_multiplicar_por_inteiro(const NumeroReal *a, int b, NumeroReal *resultado) {
+    multiplicar_por_inteiro(a->mantissa, b, resultado->mantissa);
+    resultado->expoente = a->expoente;
+}
+
+void real_dividir(const NumeroReal *a, const NumeroReal *b, NumeroReal *resultado, int precisao) {
+    long corte_a, corte_b;
+    GrandeNumero va = visao_superior(a->mantissa, precisao + 1, &corte_a);
+    GrandeNumero vb = visao_superior(b->mantissa, precisao + 1, &corte_b);
+
+    // Escalar o dividendo para que o quociente tenha ao menos precisao + 1 blocos
+    int k = (precisao + 1) + vb.quantidade_blocos - va.quantidade_blocos;
+    GrandeNumero *dividendo = criar_grande_numero(1);
+    deslocar_blocos(&va, k, dividendo);
+
+    GrandeNumero *quociente = criar_grande_numero(1);
+    dividir_grande_numero(dividendo, &vb, quociente);
+    liberar_grande_numero(dividendo);
+
+    trocar_mantissa(resultado, quociente, (a->expoente + corte_a) - k - (b->expoente + corte_b));
+    real_truncar(resultado, precisao);
+}
+
+void real_raiz_quadrada(const NumeroReal *a, NumeroReal *resultado, int precisao) {
+    // A raiz de p blocos vem de um radicando com 2p (+ guarda) blocos
+    long corte;
+    GrandeNumero va = visao_superior(a->mantissa, 2 * precisao + 2, &corte);
+    long expoente = a->expoente + corte;
+
+    // Completar até 2p + 2 blocos, deixando o expoente par
+    int k = 2 * precisao + 2 - va.quantidade_blocos;
+    if ((expoente - k) % 2 != 0) k++;
+    GrandeNumero *radicando = criar_grande_numero(1);
+    deslocar_blocos(&va, k, radicando);
+
+    GrandeNumero *raiz = criar_grande_numero(1);
+    raiz_quadrada(radicando, raiz);
+    liberar_grande_numero(radicando);
+
+    trocar_mantissa(resultado, raiz, (expoente - k) / 2);
+    real_truncar(resultado, precisao);
+}
+
+void real_parte_inteira(const NumeroReal *numero, GrandeNumero *resultado) {
+    long k = numero->expoente;
+    if (k < -(long)numero->mantissa->quantidade_blocos) {
+        definir_valor_inteiro(resultado, 0);
+        return;
+    }
+    deslocar_blocos(numero->mantissa, (int)k, resultado);
+}
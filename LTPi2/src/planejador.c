@@ -0,0 +1,358 @@
+#include "planejador.h"
+#include "ltpi2.h"
+#include "grandes_numeros.h"
+#include "numero_real.h"
+#include "ntt.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+// --- PLANEJAMENTO DE MEMÓRIA E TEMPO ---
+/*
+ * Tamanhos: o nó [a, b) da árvore de Chudnovsky tem
+ *   bits(P) ≈ (b-a)·log2(72) + 3·Σ log2 k
+ *   bits(Q) ≈ (b-a)·log2(C³/24) + 3·Σ log2 k,   bits(T) ≈ bits(Q)
+ * (k de a a b-1), e Σ log2 k = log2((b-1)!/(a-1)!) sai de lgamma sem
+ * percorrer os termos. O nó mais à direita de cada nível é o maior.
+ * No modo com fatores P encolhe ~4× e Q, T ~35% (ver definir_modo_fatores).
+ *
+ * Memória (modo serial): ao combinar um nó do nível L, estão vivos os
+ * irmãos esquerdos já prontos de todos os níveis acima e, do merge, no
+ * máximo os filhos com t2 ou T_esq, Q_dir, Q_esq, t2 e T (o nó mais à
+ * direita não calcula P), mais o rascunho do maior produto (NTT: 3 resíduos
+ * + buffers auxiliares sobre o comprimento da transformada; Karatsuba/Toom:
+ * ~6n). No paralelo, o merge da raiz roda os três produtos juntos, cada
+ * um com a NTT paralela (buffers por primo). No fechamento, P, Q e T da
+ * raiz continuam vivos até a divisão; a conversão guarda as potências de
+ * 10^(9·2^i) e a recursão dividir-para-conquistar.
+ *
+ * Tempo: M(n) (produto n×n) é medido em potências de 2 até 2^17 blocos e
+ * estendido como n·log n acima disso. A série custa Σ_L 2^L [M(p) + 3M(q)]
+ * com os tamanhos médios dos filhos em cada nível (o total de bits por
+ * nível é o da raiz); raiz, divisão, potência de 10 e conversão são
+ * múltiplos de M(precisão) ajustados contra execuções reais desta árvore.
+ */
+
+#define PLANO_MEDICAO_EXPOENTE_MINIMO 1
+#define PLANO_MEDICAO_EXPOENTE_MAXIMO 17
+#define PLANO_MEDICAO_SEGUNDOS 0.002      // Mínimo por ponto medido
+#define PLANO_MARGEM_CAPACIDADE 1.10      // Capacidade alocada além da quantidade usada
+#define PLANO_FOLGA_PROCESSO ((size_t)16 << 20)   // Pilhas, buffers de saída, crivo...
+#define PLANO_ORCAMENTO_MINIMO ((size_t)4 << 20)  // Memória dos vetores com disco, se o limite não cobre a folga
+
+// Custos do fechamento em múltiplos de M(precisão)
+#define PLANO_CUSTO_RAIZ 8.0
+#define PLANO_CUSTO_DIVISAO 12.0
+#define PLANO_CUSTO_ESCALA 6.0
+#define PLANO_CUSTO_CONVERSAO_NIVEL 4.5   // Por nível da conversão dividir-para-conquistar
+#define PLANO_CUSTO_FOLHA 12.0            // Folha da série, em múltiplos de M(2)
+#define PLANO_CUSTO_MERGE 1.3             // Somas, cópias e alocações em volta dos produtos
+#define PLANO_EFICIENCIA_PARALELA 0.85
+#define PLANO_PRIMOS_NTT 3                // Paralelismo máximo fora da série
+
+// log2 de (b-1)!/(a-1)!, isto é, Σ log2 k para k em [a, b)
+static double soma_log2(double a, double b) {
+    if (a < 1) a = 1;
+    if (b <= a) return 0;
+    return (lgamma(b) - lgamma(a)) / M_LN2;
+}
+
+static long long blocos_de_bits(double bits) {
+    return (long long)ceil(bits / BITS_POR_BLOCO) + 1;
+}
+
+// Rascunho (em blocos) do produto de dois operandos de n blocos
+static double rascunho_produto(double n, int paralelo) {
+    Limiares limiares;
+    obter_limiares(&limiares);
+    if (n >= limiares.ntt && 2 * n <= NTT_TAMANHO_MAXIMO && n <= NTT_MENOR_OPERANDO_MAXIMO) {
+        double comprimento = 1;
+        while (comprimento < 2 * n - 1) comprimento *= 2;
+        return comprimento * (paralelo ? 3 + 2 * 3 : 3 + 2);
+    }
+    return 6 * n + 64 * 40;
+}
+
+// --- MODELO DE CUSTO M(n) ---
+
+static double tempo_produto[PLANO_MEDICAO_EXPOENTE_MAXIMO + 1];
+static int maior_medido = 0;
+
+static double relogio(void) {
+    struct timespec agora;
+    clock_gettime(CLOCK_MONOTONIC, &agora);
+    return (double)agora.tv_sec + (double)agora.tv_nsec * 1e-9;
+}
+
+static void medir_produtos(int expoente_maximo) {
+    if (expoente_maximo > PLANO_MEDICAO_EXPOENTE_MAXIMO) expoente_maximo = PLANO_MEDICAO_EXPOENTE_MAXIMO;
+    if (expoente_maximo < PLANO_MEDICAO_EXPOENTE_MINIMO + 1) expoente_maximo = PLANO_MEDICAO_EXPOENTE_MINIMO + 1;
+    if (maior_medido >= expoente_maximo) return;
+
+    uint32_t semente = 12345;
+    for (int e = PLANO_MEDICAO_EXPOENTE_MINIMO; e <= expoente_maximo; e++) {
+        int n = 1 << e;
+        GrandeNumero *a = criar_grande_numero(n);
+        GrandeNumero *b = criar_grande_numero(n);
+        GrandeNumero *r = criar_grande_numero(2 * n);
+        for (int i = 0; i < n; i++) {
+            semente = semente * 1664525u + 1013904223u;
+            a->blocos[i] = semente;
+            semente = semente * 1664525u + 1013904223u;
+            b->blocos[i] = semente | 1u;
+        }
+        a->quantidade_blocos = b->quantidade_blocos = n;
+
+        multiplicar_grandes_numeros(a, b, r);   // Aquecimento
+        int repeticoes = 0;
+        double inicio = relogio(), decorrido;
+        do {
+            multiplicar_grandes_numeros(a, b, r);
+            repeticoes++;
+            decorrido = relogio() - inicio;
+        } while (decorrido < PLANO_MEDICAO_SEGUNDOS);
+        tempo_produto[e] = decorrido / repeticoes;
+
+        liberar_grande_numero(a);
+        liberar_grande_numero(b);
+        liberar_grande_numero(r);
+    }
+    maior_medido = expoente_maximo;
+}
+
+// M(n): interpolação log-log entre as medições; n·log n acima da maior
+static double custo_produto(double n) {
+    if (n < 2) n = 2;
+    double x = log2(n);
+    int e = (int)floor(x);
+    if (e < PLANO_MEDICAO_EXPOENTE_MINIMO) e = PLANO_MEDICAO_EXPOENTE_MINIMO;
+    if (e >= maior_medido) {
+        double n_maximo = (double)(1 << maior_medido);
+        return tempo_produto[maior_medido] * (n / n_maximo) * (x / maior_medido);
+    }
+    double f = x - e;
+    return exp2((1 - f) * log2(tempo_produto[e]) + f * log2(tempo_produto[e + 1]));
+}
+
+// --- PLANO ---
+
+static void dimensionar_arvore(PlanoPi *plano, int modo_fatores) {
+    double fator_p = modo_fatores ? 0.25 : 1.0;
+    double fator_qt = modo_fatores ? 0.65 : 1.0;
+    double log2_72 = log2(72.0), log2_c3 = log2(10939058860032000.0);
+
+    int a = 0, b = plano->termos, nivel = 0;
+    while (nivel < PLANO_NIVEIS_MAXIMOS) {
+        NivelPlano *n = &plano->nivel[nivel];
+        double termos = (double)(b - a), logs = 3 * soma_log2(a, b);
+        n->nos = (nivel < 30 && (1 << nivel) < plano->termos) ? (1 << nivel) : plano->termos;
+        n->termos_por_no = b - a;
+        n->blocos_p = blocos_de_bits(fator_p * (termos * log2_72 + logs));
+        n->blocos_q = blocos_de_bits(fator_qt * (termos * log2_c3 + logs));
+        n->blocos_t = n->blocos_q + 1;
+        nivel++;
+        if (b - a <= 1) break;
+        a = (a + b) / 2;
+    }
+    plano->niveis = nivel;
+}
+
+static double bytes_de_blocos(double blocos) {
+    return blocos * sizeof(uint32_t);
+}
+
+static void estimar_memoria(PlanoPi *plano, int threads) {
+    double pico_arvore = 0, irmaos = 0;
+    for (int L = 0; L + 1 < plano->niveis; L++) {
+        const NivelPlano *filho = &plano->nivel[L + 1];
+        // Nó da borda direita: o filho direito chega sem P e o P do nó não é
+        // calculado (ver combinar_termos)
+        double p = filho->blocos_p, q = filho->blocos_q;
+        double rascunho = rascunho_produto(q, threads > 1);
+        double merge;
+        if (threads > 1 && L == 0) {
+            // Os três produtos da raiz juntos, com filhos e saídas vivos
+            merge = (p + 4 * q) + (2 * q + (p + q) + 2 * q) + 3 * rascunho;
+        } else {
+            // Serial: t2 com os filhos todos vivos, depois T com T_esq, Q e Q_dir
+            double t2 = (2 * p + 5 * q), t = (p + 6 * q);
+            merge = ((t2 > t) ? t2 : t) + rascunho;
+        }
+        double total = irmaos + merge;
+        if (total > pico_arvore) pico_arvore = total;
+        irmaos += filho->blocos_p + filho->blocos_q + filho->blocos_t;
+    }
+
+    const NivelPlano *raiz = &plano->nivel[0];
+    double p = plano->precisao;
+    double arvore_final = raiz->blocos_p + raiz->blocos_q + raiz->blocos_t;
+    double pico_raiz = arvore_final + 5 * p + rascunho_produto(p, threads > 1);
+    double pico_divisao = arvore_final + 9 * p + rascunho_produto(p, threads > 1);
+    double pico_conversao = 6 * p + rascunho_produto(p / 2, threads > 1);
+
+    plano->pico_arvore = (size_t)(bytes_de_blocos(pico_arvore) * PLANO_MARGEM_CAPACIDADE);
+    plano->pico_raiz = (size_t)(bytes_de_blocos(pico_raiz) * PLANO_MARGEM_CAPACIDADE);
+    plano->pico_divisao = (size_t)(bytes_de_blocos(pico_divisao) * PLANO_MARGEM_CAPACIDADE);
+    plano->pico_conversao = (size_t)(bytes_de_blocos(pico_conversao) * PLANO_MARGEM_CAPACIDADE);
+
+    size_t pico = plano->pico_arvore;
+    if (plano->pico_raiz > pico) pico = plano->pico_raiz;
+    if (plano->pico_divisao > pico) pico = plano->pico_divisao;
+    if (plano->pico_conversao > pico) pico = plano->pico_conversao;
+    plano->pico = pico + PLANO_FOLGA_PROCESSO;
+}
+
+static void estimar_tempo(PlanoPi *plano, int threads) {
+    const NivelPlano *raiz = &plano->nivel[0];
+    double serie = plano->termos * PLANO_CUSTO_FOLHA * custo_produto(2);
+    for (int L = 0; L + 1 < plano->niveis; L++) {
+        double nos = plano->nivel[L].nos;
+        double p = (double)raiz->blocos_p / (2 * nos), q = (double)raiz->blocos_q / (2 * nos);
+        serie += nos * PLANO_CUSTO_MERGE * (custo_produto(p) + 3 * custo_produto(q));
+    }
+
+    double p = plano->precisao;
+    double fechamento = (PLANO_CUSTO_RAIZ + PLANO_CUSTO_DIVISAO + PLANO_CUSTO_ESCALA) * custo_produto(p);
+    Limiares limiares;
+    obter_limiares(&limiares);
+    double niveis_conversao = log2(p / (limiares.conversao > 0 ? limiares.conversao : 1));
+    if (niveis_conversao < 1) niveis_conversao = 1;
+    double conversao = PLANO_CUSTO_CONVERSAO_NIVEL * niveis_conversao * custo_produto(p / 2);
+
+    if (threads > 1) {
+        int fora_da_serie = (threads < PLANO_PRIMOS_NTT) ? threads : PLANO_PRIMOS_NTT;
+        serie /= threads * PLANO_EFICIENCIA_PARALELA;
+        fechamento /= fora_da_serie * PLANO_EFICIENCIA_PARALELA;
+        conversao /= fora_da_serie * PLANO_EFICIENCIA_PARALELA;
+    }
+    plano->tempo_serie = serie;
+    plano->tempo_fechamento = fechamento;
+    plano->tempo_conversao = conversao;
+    plano->tempo_total = serie + fechamento + conversao;
+}
+
+// Monta o plano para uma estratégia; retorna 1 se cabe no limite
+static int avaliar(PlanoPi *plano, int threads, int modo_fatores) {
+    dimensionar_arvore(plano, modo_fatores);
+    estimar_memoria(plano, threads);
+    estimar_tempo(plano, threads);
+    plano->threads = threads;
+    plano->modo_fatores = modo_fatores;
+    plano->usar_disco = 0;
+    plano->orcamento_memoria = 0;
+    // Mesma conta do grão automático de calcular_pi
+    plano->grao = (threads > 1) ? plano->termos / (threads * 16) : 0;
+    if (threads > 1 && plano->grao < 16) plano->grao = 16;
+    return plano->memoria_limite == 0 || plano->pico <= plano->memoria_limite;
+}
+
+int planejar_pi(int digitos, size_t memoria_limite, int threads_maximas, const char *diretorio_disco, PlanoPi *plano) {
+    if (digitos < 1 || plano == NULL) return -1;
+    memset(plano, 0, sizeof(*plano));
+    plano->digitos = digitos;
+    plano->memoria_limite = memoria_limite;
+    plano->termos = PI_TERMOS_PARA_DIGITOS(digitos);
+    plano->precisao = precisao_para_digitos(digitos) + 2;
+    if (threads_maximas <= 0) threads_maximas = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads_maximas < 1) threads_maximas = 1;
+
+    medir_produtos((int)ceil(log2((double)plano->precisao)) + 1);
+
+    // Candidatas: todas as threads com e sem fatores (P ~4× menor, e em
+    // geral mais rápido), depois menos threads (menos rascunhos simultâneos).
+    // Fica a mais rápida que cabe.
+    plano->cabe = 1;
+    PlanoPi melhor;
+    int achou = 0;
+    for (int modo = 0; modo <= 1; modo++) {
+        for (int threads = threads_maximas; threads >= 1; threads = (threads > 1) ? threads / 2 : 0) {
+            if (!avaliar(plano, threads, modo)) continue;
+            if (!achou || plano->tempo_total < melhor.tempo_total) melhor = *plano;
+            achou = 1;
+            break;   // Com menos threads só fica mais lento
+        }
+    }
+    if (achou) {
+        *plano = melhor;
+        return 0;
+    }
+
+    // Nada cabe na RAM: os vetores acima do orçamento vão para arquivos
+    // mapeados, com todas as threads e o modo com fatores (menos E/S). Sem
+    // disco, fica a estratégia mais econômica, marcada como fora do limite.
+    // Um limite que não cobre nem a folga fixa do processo também fica fora
+    // dele, mas com o disco e o menor orçamento de memória.
+    if (diretorio_disco != NULL) {
+        avaliar(plano, threads_maximas, 1);
+        plano->usar_disco = 1;
+        if (memoria_limite > PLANO_FOLGA_PROCESSO + PLANO_ORCAMENTO_MINIMO) {
+            plano->orcamento_memoria = memoria_limite - PLANO_FOLGA_PROCESSO;
+        } else {
+            plano->orcamento_memoria = PLANO_ORCAMENTO_MINIMO;
+            plano->cabe = 0;
+        }
+    } else {
+        avaliar(plano, 1, 1);
+        plano->cabe = 0;
+    }
+    return 0;
+}
+
+static void imprimir_bytes(const char *rotulo, size_t bytes) {
+    printf("  %-22s %10.1f MiB\n", rotulo, (double)bytes / (1 << 20));
+}
+
+void imprimir_plano_pi(const PlanoPi *plano) {
+    printf("Plano para %d dígitos: %d termos, %d níveis, fechamento com %d blocos\n",
+           plano->digitos, plano->termos, plano->niveis, plano->precisao);
+    printf("  %5s %10s %12s %14s %14s %14s\n", "nível", "nós", "termos/nó", "blocos P", "blocos Q", "blocos T");
+    for (int L = 0; L < plano->niveis; L++) {
+        const NivelPlano *n = &plano->nivel[L];
+        // Os níveis de baixo são muitos e pequenos: só os de cima e o último
+        if (L >= 12 && L + 1 < plano->niveis) continue;
+        printf("  %5d %10d %12d %14lld %14lld %14lld\n", L, n->nos, n->termos_por_no, n->blocos_p, n->blocos_q, n->blocos_t);
+    }
+
+    printf("Memória estimada (vetores de blocos):\n");
+    imprimir_bytes("árvore", plano->pico_arvore);
+    imprimir_bytes("raiz quadrada", plano->pico_raiz);
+    imprimir_bytes("divisão", plano->pico_divisao);
+    imprimir_bytes("conversão", plano->pico_conversao);
+    imprimir_bytes("pico (com folga)", plano->pico);
+    if (plano->memoria_limite > 0) imprimir_bytes("limite", plano->memoria_limite);
+
+    printf("Tempo estimado: %.2fs (série %.2fs, fechamento %.2fs, conversão %.2fs)\n",
+           plano->tempo_total, plano->tempo_serie, plano->tempo_fechamento, plano->tempo_conversao);
+
+    printf("Estratégia: %d thread%s", plano->threads, plano->threads > 1 ? "s" : "");
+    if (plano->threads > 1) printf(", grão %d termos", plano->grao);
+    printf(", modo com fatores %s", plano->modo_fatores ? "ligado" : "desligado");
+    if (plano->usar_disco) printf(", disco acima de %.1f MiB na memória", (double)plano->orcamento_memoria / (1 << 20));
+    else printf(", tudo na memória");
+    printf("\n");
+    if (plano->usar_disco) printf("  (tempo sem contar a E/S dos arquivos mapeados)\n");
+    if (plano->cabe) return;
+    if (plano->usar_disco) {
+        printf("AVISO: O limite de %.1f MiB não cobre a folga fixa do processo (%.0f MiB) mais %.0f MiB para os vetores; "
+               "o uso real vai passar dele\n", (double)plano->memoria_limite / (1 << 20),
+               (double)PLANO_FOLGA_PROCESSO / (1 << 20), (double)PLANO_ORCAMENTO_MINIMO / (1 << 20));
+    } else if (plano->memoria_limite <= PLANO_FOLGA_PROCESSO) {
+        printf("AVISO: O limite de %.1f MiB não cobre nem a folga fixa do processo (%.0f MiB); indique um diretório "
+               "para o disco e um limite maior\n", (double)plano->memoria_limite / (1 << 20), (double)PLANO_FOLGA_PROCESSO / (1 << 20));
+    } else {
+        printf("AVISO: O pico estimado passa do limite; indique um diretório para o disco\n");
+    }
+}
+
+int aplicar_plano_pi(const PlanoPi *plano, const char *diretorio_disco) {
+    definir_numero_threads(plano->threads);
+    definir_grao_paralelo(plano->grao);
+    definir_modo_fatores(plano->modo_fatores);
+    if (plano->usar_disco) {
+        return configurar_armazenamento_disco(diretorio_disco, 0, plano->orcamento_memoria);
+    }
+    return 0;
+}
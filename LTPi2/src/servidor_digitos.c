@@ -0,0 +1,348 @@
+#define _GNU_SOURCE
+#include "servidor_digitos.h"
+#include "cliente_digitos.h"
+#include "cache_digitos.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+// --- SERVIDOR DE FAIXAS DE DÍGITOS ---
+/*
+ * Uma thread, um epoll em modo de nível. Cada conexão tem um buffer de
+ * entrada (pedidos encadeados chegam juntos e são lidos num recv só) e no
+ * máximo uma resposta em andamento: os 16 bytes do cabeçalho, enviados com
+ * MSG_MORE, e a faixa do arquivo, enviada por sendfile direto do cache de
+ * páginas. Quando o socket enche (EAGAIN), a conexão passa a esperar
+ * EPOLLOUT e continua de onde parou; sem resposta pendente, volta a
+ * esperar EPOLLIN.
+ *
+ * Para não deixar uma conexão com muitos pedidos encadeados monopolizar o
+ * laço, cada evento atende no máximo SERVIDOR_PEDIDOS_POR_EVENTO pedidos;
+ * os que sobram no buffer mantêm a conexão em EPOLLOUT (o socket está
+ * livre para escrita, então ela volta na próxima volta do laço).
+ *
+ * O arquivo fica aberto durante todo o serviço e sendfile lê as faixas do
+ * descritor, no cache de páginas do kernel: há uma única cópia para todos
+ * os consumidores, e as páginas ficam lá enquanto o kernel quiser (nada é
+ * travado na memória). Um cache de dígitos é mapeado só para ser conferido
+ * por inteiro na abertura; de um texto basta ler o "3." e o fim.
+ */
+
+#define SERVIDOR_EVENTOS_POR_ESPERA 256
+#define SERVIDOR_BUFFER_ENTRADA (64 * DIGITOS_BYTES_PEDIDO)
+#define SERVIDOR_PEDIDOS_POR_EVENTO 64
+
+typedef struct {
+    int fd;
+    uint32_t eventos;                    // Interesse registrado no epoll
+    unsigned char entrada[SERVIDOR_BUFFER_ENTRADA];
+    int usados;
+    unsigned char cabecalho[DIGITOS_BYTES_RESPOSTA];
+    int cabecalho_enviado;               // -1 = nenhuma resposta em andamento
+    off_t posicao;                       // Próximo byte do arquivo a enviar
+    uint64_t restantes;
+} ConexaoDigitos;
+
+static struct {
+    int fd_arquivo;
+    off_t inicio_texto;                  // Deslocamento da casa 0 no arquivo
+    uint64_t casas;
+    int epoll;
+    int escuta;
+    int conexoes;
+    int escuta_pausada;
+    unsigned long long pedidos;
+    unsigned long long bytes_enviados;
+} servidor;
+
+static volatile sig_atomic_t encerrar_servidor = 0;
+
+static void pedir_encerramento(int sinal) {
+    (void)sinal;
+    encerrar_servidor = 1;
+}
+
+static void escrever_u32(unsigned char *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static void escrever_u64(unsigned char *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static uint64_t ler_u64(const unsigned char *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+// Abre o arquivo e localiza a casa 0: depois do "3." de um texto de
+// calcular_pi_fd, ou no texto de um cache de dígitos
+static int abrir_arquivo_digitos(const char *arquivo) {
+    servidor.fd_arquivo = open(arquivo, O_RDONLY | O_CLOEXEC);
+    if (servidor.fd_arquivo < 0) {
+        printf("ERRO: Não foi possível abrir '%s'\n", arquivo);
+        return -1;
+    }
+
+    long long casas_cache = cache_digitos_disponiveis(arquivo);
+    if (casas_cache > 0) {
+        // O cache pode ter sido trocado entre o open e o mapeamento: o
+        // descritor e a visão têm de ser do mesmo arquivo
+        struct stat do_fd, do_caminho;
+        VisaoDigitosPi visao;
+        int conferido = (cache_digitos_mapear(arquivo, casas_cache, &visao) == 0);
+        if (conferido) cache_digitos_fechar(&visao);
+        if (!conferido || fstat(servidor.fd_arquivo, &do_fd) != 0 || stat(arquivo, &do_caminho) != 0 ||
+            do_fd.st_ino != do_caminho.st_ino || do_fd.st_dev != do_caminho.st_dev) {
+            printf("ERRO: Cache de dígitos '%s' corrompido ou trocado durante a abertura\n", arquivo);
+            close(servidor.fd_arquivo);
+            return -1;
+        }
+        servidor.inicio_texto = CACHE_DESLOCAMENTO_TEXTO + 2;
+        servidor.casas = (uint64_t)casas_cache;
+        return 0;
+    }
+
+    struct stat info;
+    char inicio[2];
+    if (fstat(servidor.fd_arquivo, &info) != 0 || info.st_size < 2 ||
+        pread(servidor.fd_arquivo, inicio, 2, 0) != 2 || memcmp(inicio, "3.", 2) != 0) {
+        printf("ERRO: '%s' não é um arquivo de dígitos (\"3.1415...\")\n", arquivo);
+        close(servidor.fd_arquivo);
+        return -1;
+    }
+    // Quebras de linha no fim não são casas
+    off_t fim = info.st_size;
+    char ultimo;
+    while (fim > 2 && pread(servidor.fd_arquivo, &ultimo, 1, fim - 1) == 1 && (ultimo == '\n' || ultimo == '\r')) fim--;
+    servidor.inicio_texto = 2;
+    servidor.casas = fim - 2;
+    return 0;
+}
+
+static void fechar_arquivo_digitos(void) {
+    close(servidor.fd_arquivo);
+}
+
+static int abrir_escuta(const char *caminho_socket) {
+    struct sockaddr_un endereco;
+    if (strlen(caminho_socket) >= sizeof(endereco.sun_path)) {
+        printf("ERRO: Caminho de socket longo demais: '%s'\n", caminho_socket);
+        return -1;
+    }
+    // Só um socket antigo é substituído, nunca outro tipo de arquivo
+    struct stat info;
+    if (lstat(caminho_socket, &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            printf("ERRO: '%s' já existe e não é um socket\n", caminho_socket);
+            return -1;
+        }
+        unlink(caminho_socket);
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    strcpy(endereco.sun_path, caminho_socket);
+    if (bind(fd, (struct sockaddr*)&endereco, sizeof(endereco)) != 0 || listen(fd, SOMAXCONN) != 0) {
+        printf("ERRO: Não foi possível escutar em '%s'\n", caminho_socket);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void registrar_interesse(ConexaoDigitos *c, uint32_t eventos) {
+    if (c->eventos == eventos) return;
+    struct epoll_event evento = { .events = eventos, .data.ptr = c };
+    epoll_ctl(servidor.epoll, EPOLL_CTL_MOD, c->fd, &evento);
+    c->eventos = eventos;
+}
+
+static void pausar_escuta(int pausar) {
+    if (servidor.escuta_pausada == pausar) return;
+    struct epoll_event evento = { .events = pausar ? 0 : EPOLLIN, .data.ptr = NULL };
+    epoll_ctl(servidor.epoll, EPOLL_CTL_MOD, servidor.escuta, &evento);
+    servidor.escuta_pausada = pausar;
+}
+
+static void fechar_conexao(ConexaoDigitos *c) {
+    epoll_ctl(servidor.epoll, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    free(c);
+    servidor.conexoes--;
+    pausar_escuta(0);
+}
+
+static void aceitar_conexoes(void) {
+    while (servidor.conexoes < SERVIDOR_CONEXOES_MAXIMAS) {
+        int fd = accept4(servidor.escuta, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            // EAGAIN: fila vazia. EMFILE/ENFILE: sem descritores; as
+            // conexões esperam na fila até alguma ser fechada
+            if (errno == EMFILE || errno == ENFILE) pausar_escuta(1);
+            return;
+        }
+        ConexaoDigitos *c = (ConexaoDigitos*)calloc(1, sizeof(ConexaoDigitos));
+        struct epoll_event evento = { .events = EPOLLIN, .data.ptr = c };
+        if (c == NULL || epoll_ctl(servidor.epoll, EPOLL_CTL_ADD, fd, &evento) != 0) {
+            free(c);
+            close(fd);
+            continue;
+        }
+        c->fd = fd;
+        c->eventos = EPOLLIN;
+        c->cabecalho_enviado = -1;
+        servidor.conexoes++;
+    }
+    pausar_escuta(1);
+}
+
+// Consome um pedido do buffer e prepara a resposta
+static void iniciar_resposta(ConexaoDigitos *c) {
+    uint64_t inicio = ler_u64(c->entrada);
+    uint64_t fim = ler_u64(c->entrada + 8);
+    c->usados -= DIGITOS_BYTES_PEDIDO;
+    memmove(c->entrada, c->entrada + DIGITOS_BYTES_PEDIDO, (size_t)c->usados);
+
+    int valido = (inicio <= fim && fim <= servidor.casas && fim - inicio <= DIGITOS_MAXIMO_POR_PEDIDO);
+    c->restantes = valido ? fim - inicio : 0;
+    c->posicao = servidor.inicio_texto + (off_t)inicio;
+    escrever_u32(c->cabecalho, valido ? DIGITOS_ESTADO_OK : DIGITOS_ESTADO_FORA);
+    escrever_u32(c->cabecalho + 4, 0);
+    escrever_u64(c->cabecalho + 8, c->restantes);
+    c->cabecalho_enviado = 0;
+    servidor.pedidos++;
+}
+
+// Avança a resposta em andamento. Retorna 1 se terminou, 0 se o socket
+// encheu, -1 se a conexão caiu.
+static int continuar_resposta(ConexaoDigitos *c) {
+    while (c->cabecalho_enviado < DIGITOS_BYTES_RESPOSTA) {
+        int mais = (c->restantes > 0) ? MSG_MORE : 0;
+        ssize_t enviados = send(c->fd, c->cabecalho + c->cabecalho_enviado,
+                                (size_t)(DIGITOS_BYTES_RESPOSTA - c->cabecalho_enviado), MSG_NOSIGNAL | mais);
+        if (enviados < 0) {
+            if (errno == EINTR) continue;
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+        }
+        c->cabecalho_enviado += (int)enviados;
+    }
+    while (c->restantes > 0) {
+        size_t pedaco = (c->restantes > ((size_t)1 << 30)) ? ((size_t)1 << 30) : (size_t)c->restantes;
+        ssize_t enviados = sendfile(c->fd, servidor.fd_arquivo, &c->posicao, pedaco);
+        if (enviados < 0) {
+            if (errno == EINTR) continue;
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+        }
+        if (enviados == 0) return -1;   // Arquivo encurtado por fora
+        c->restantes -= (uint64_t)enviados;
+        servidor.bytes_enviados += (unsigned long long)enviados;
+    }
+    c->cabecalho_enviado = -1;
+    return 1;
+}
+
+// Lê e responde o que der sem bloquear. Retorna -1 para fechar a conexão.
+static int atender_conexao(ConexaoDigitos *c) {
+    int atendidos = 0;
+    for (;;) {
+        if (c->cabecalho_enviado >= 0) {
+            int estado = continuar_resposta(c);
+            if (estado < 0) return -1;
+            if (estado == 0) {
+                registrar_interesse(c, EPOLLOUT);
+                return 0;
+            }
+        }
+        if (c->usados >= DIGITOS_BYTES_PEDIDO) {
+            if (atendidos == SERVIDOR_PEDIDOS_POR_EVENTO) {
+                registrar_interesse(c, EPOLLOUT);
+                return 0;
+            }
+            iniciar_resposta(c);
+            atendidos++;
+            continue;
+        }
+        ssize_t lidos = recv(c->fd, c->entrada + c->usados, sizeof(c->entrada) - (size_t)c->usados, 0);
+        if (lidos == 0) return -1;
+        if (lidos < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) return -1;
+            registrar_interesse(c, EPOLLIN);
+            return 0;
+        }
+        c->usados += (int)lidos;
+    }
+}
+
+int servir_digitos(const char *arquivo, const char *caminho_socket) {
+    memset(&servidor, 0, sizeof(servidor));
+    if (abrir_arquivo_digitos(arquivo) != 0) return -1;
+    servidor.escuta = abrir_escuta(caminho_socket);
+    servidor.epoll = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event evento = { .events = EPOLLIN, .data.ptr = NULL };
+    if (servidor.escuta < 0 || servidor.epoll < 0 ||
+        epoll_ctl(servidor.epoll, EPOLL_CTL_ADD, servidor.escuta, &evento) != 0) {
+        if (servidor.escuta >= 0) {
+            close(servidor.escuta);
+            unlink(caminho_socket);
+        }
+        if (servidor.epoll >= 0) close(servidor.epoll);
+        fechar_arquivo_digitos();
+        return -1;
+    }
+
+    // Um cliente que fecha no meio de uma resposta não pode derrubar o servidor
+    struct sigaction acao;
+    memset(&acao, 0, sizeof(acao));
+    acao.sa_handler = pedir_encerramento;
+    sigaction(SIGINT, &acao, NULL);
+    sigaction(SIGTERM, &acao, NULL);
+    signal(SIGPIPE, SIG_IGN);
+    encerrar_servidor = 0;
+
+    printf("Servindo %llu casas de '%s' em '%s'\n", (unsigned long long)servidor.casas, arquivo, caminho_socket);
+    fflush(stdout);
+
+    struct epoll_event eventos[SERVIDOR_EVENTOS_POR_ESPERA];
+    while (!encerrar_servidor) {
+        int prontos = epoll_wait(servidor.epoll, eventos, SERVIDOR_EVENTOS_POR_ESPERA, -1);
+        if (prontos < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        for (int i = 0; i < prontos; i++) {
+            ConexaoDigitos *c = (ConexaoDigitos*)eventos[i].data.ptr;
+            if (c == NULL) {
+                aceitar_conexoes();
+                continue;
+            }
+            if ((eventos[i].events & (EPOLLERR | EPOLLHUP)) && !(eventos[i].events & EPOLLIN)) {
+                fechar_conexao(c);
+            } else if (atender_conexao(c) != 0) {
+                fechar_conexao(c);
+            }
+        }
+    }
+
+    // As conexões abertas são fechadas junto com o processo; aqui só o socket
+    close(servidor.escuta);
+    unlink(caminho_socket);
+    close(servidor.epoll);
+    fechar_arquivo_digitos();
+    printf("Servidor encerrado: %llu pedidos, %llu bytes enviados\n", servidor.pedidos, servidor.bytes_enviados);
+    return 0;
+}
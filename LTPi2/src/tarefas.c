@@ -0,0 +1,240 @@
+#include "tarefas.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// --- POOL DE TAREFAS COM ROUBO DE TRABALHO ---
+/*
+ * Modelo fork-join:
+ *   tarefa_criar(&t, f, arg);   // publica f(arg) na fila da thread atual
+ *   ... trabalho local ...
+ *   tarefa_aguardar(&t);        // se ninguém roubou, executa f(arg) aqui mesmo
+ *
+ * Enquanto espera, a thread não fica parada: executa primeiro as tarefas da
+ * própria fila e depois rouba das filas das outras. Isso garante progresso
+ * mesmo com recursão profunda e mantém todos os núcleos ocupados.
+ *
+ * As filas são protegidas por um mutex cada; as tarefas publicadas aqui são
+ * grossas (subárvores do binary splitting, produtos grandes), então a
+ * contenção é desprezível diante do custo de cada tarefa.
+ */
+
+typedef struct {
+    Tarefa **itens;
+    int capacidade;
+    int inicio;   // Topo (lado dos ladrões)
+    int fim;      // Fundo (lado da dona)
+    pthread_mutex_t trava;
+} FilaTrabalho;
+
+typedef struct {
+    int num_threads;
+    int num_filas;                   // Filas iniciadas (>= num_threads se uma thread falhou)
+    pthread_t *threads;
+    FilaTrabalho *filas;
+    atomic_int ativo;
+    atomic_int encerrar;
+    atomic_int pendentes;            // Tarefas publicadas e ainda não retiradas
+    pthread_mutex_t trava_ociosos;
+    pthread_cond_t sinal_ociosos;
+} PoolTarefas;
+
+static PoolTarefas pool;
+static __thread int indice_trabalhador = -1;
+
+static void empilhar(FilaTrabalho *fila, Tarefa *tarefa) {
+    pthread_mutex_lock(&fila->trava);
+    if (fila->fim == fila->capacidade) {
+        if (fila->inicio > 0) {
+            // Compactar antes de crescer
+            int n = fila->fim - fila->inicio;
+            for (int i = 0; i < n; i++) fila->itens[i] = fila->itens[fila->inicio + i];
+            fila->inicio = 0;
+            fila->fim = n;
+        }
+        if (fila->fim == fila->capacidade) {
+            int nova_capacidade = fila->capacidade * 2;
+            Tarefa **novos = (Tarefa**)realloc(fila->itens, nova_capacidade * sizeof(Tarefa*));
+            if (novos == NULL) {
+                pthread_mutex_unlock(&fila->trava);
+                // Sem memória para publicar: executar na hora
+                tarefa->funcao(tarefa->argumento);
+                atomic_store_explicit(&tarefa->concluida, 1, memory_order_release);
+                return;
+            }
+            fila->itens = novos;
+            fila->capacidade = nova_capacidade;
+        }
+    }
+    fila->itens[fila->fim++] = tarefa;
+    atomic_fetch_add(&pool.pendentes, 1);
+    pthread_mutex_unlock(&fila->trava);
+
+    pthread_mutex_lock(&pool.trava_ociosos);
+    pthread_cond_signal(&pool.sinal_ociosos);
+    pthread_mutex_unlock(&pool.trava_ociosos);
+}
+
+static Tarefa* desempilhar_fundo(FilaTrabalho *fila) {
+    Tarefa *tarefa = NULL;
+    pthread_mutex_lock(&fila->trava);
+    if (fila->fim > fila->inicio) {
+        tarefa = fila->itens[--fila->fim];
+        if (fila->fim == fila->inicio) fila->inicio = fila->fim = 0;
+        atomic_fetch_sub(&pool.pendentes, 1);
+    }
+    pthread_mutex_unlock(&fila->trava);
+    return tarefa;
+}
+
+static Tarefa* roubar_topo(FilaTrabalho *fila) {
+    Tarefa *tarefa = NULL;
+    pthread_mutex_lock(&fila->trava);
+    if (fila->fim > fila->inicio) {
+        tarefa = fila->itens[fila->inicio++];
+        if (fila->fim == fila->inicio) fila->inicio = fila->fim = 0;
+        atomic_fetch_sub(&pool.pendentes, 1);
+    }
+    pthread_mutex_unlock(&fila->trava);
+    return tarefa;
+}
+
+// Procura trabalho: primeiro na própria fila, depois roubando das outras
+static Tarefa* buscar_tarefa(int indice) {
+    Tarefa *tarefa = desempilhar_fundo(&pool.filas[indice]);
+    if (tarefa != NULL) return tarefa;
+
+    for (int k = 1; k < pool.num_threads; k++) {
+        int vitima = (indice + k) % pool.num_threads;
+        tarefa = roubar_topo(&pool.filas[vitima]);
+        if (tarefa != NULL) return tarefa;
+    }
+    return NULL;
+}
+
+static void executar_tarefa(Tarefa *tarefa) {
+    tarefa->funcao(tarefa->argumento);
+    atomic_store_explicit(&tarefa->concluida, 1, memory_order_release);
+}
+
+static void* laco_trabalhador(void *argumento) {
+    indice_trabalhador = (int)(long)argumento;
+
+    while (!atomic_load(&pool.encerrar)) {
+        Tarefa *tarefa = buscar_tarefa(indice_trabalhador);
+        if (tarefa != NULL) {
+            executar_tarefa(tarefa);
+            continue;
+        }
+
+        // Nada para fazer: dormir até alguém publicar uma tarefa
+        pthread_mutex_lock(&pool.trava_ociosos);
+        while (atomic_load(&pool.pendentes) == 0 && !atomic_load(&pool.encerrar)) {
+            pthread_cond_wait(&pool.sinal_ociosos, &pool.trava_ociosos);
+        }
+        pthread_mutex_unlock(&pool.trava_ociosos);
+    }
+    return NULL;
+}
+
+static void liberar_filas(void) {
+    for (int i = 0; i < pool.num_filas; i++) {
+        free(pool.filas[i].itens);
+        pthread_mutex_destroy(&pool.filas[i].trava);
+    }
+    free(pool.filas);
+    free(pool.threads);
+    pool.filas = NULL;
+    pool.threads = NULL;
+    pool.num_filas = 0;
+}
+
+int iniciar_pool_tarefas(int num_threads) {
+    if (num_threads <= 1 || atomic_load(&pool.ativo)) return 0;
+
+    pool.num_threads = num_threads;
+    pool.filas = (FilaTrabalho*)calloc(num_threads, sizeof(FilaTrabalho));
+    pool.threads = (pthread_t*)calloc(num_threads, sizeof(pthread_t));
+    if (pool.filas == NULL || pool.threads == NULL) {
+        free(pool.filas);
+        free(pool.threads);
+        return -1;
+    }
+
+    pool.num_filas = 0;
+    for (int i = 0; i < num_threads; i++) {
+        pool.filas[i].capacidade = 64;
+        pool.filas[i].itens = (Tarefa**)malloc(64 * sizeof(Tarefa*));
+        if (pool.filas[i].itens == NULL) {
+            liberar_filas();
+            return -1;
+        }
+        pthread_mutex_init(&pool.filas[i].trava, NULL);
+        pool.num_filas = i + 1;
+    }
+    pthread_mutex_init(&pool.trava_ociosos, NULL);
+    pthread_cond_init(&pool.sinal_ociosos, NULL);
+    atomic_store(&pool.pendentes, 0);
+    atomic_store(&pool.encerrar, 0);
+
+    indice_trabalhador = 0;
+    for (int i = 1; i < num_threads; i++) {
+        if (pthread_create(&pool.threads[i], NULL, laco_trabalhador, (void*)(long)i) != 0) {
+            printf("AVISO: Falha ao criar thread %d do pool\n", i);
+            pool.num_threads = i;
+            break;
+        }
+    }
+    atomic_store(&pool.ativo, 1);
+    return 0;
+}
+
+void finalizar_pool_tarefas(void) {
+    if (!atomic_load(&pool.ativo)) return;
+
+    pthread_mutex_lock(&pool.trava_ociosos);
+    atomic_store(&pool.encerrar, 1);
+    pthread_cond_broadcast(&pool.sinal_ociosos);
+    pthread_mutex_unlock(&pool.trava_ociosos);
+
+    for (int i = 1; i < pool.num_threads; i++) pthread_join(pool.threads[i], NULL);
+    // Todas as filas iniciadas, mesmo as de threads que não chegaram a ser criadas
+    liberar_filas();
+    pthread_mutex_destroy(&pool.trava_ociosos);
+    pthread_cond_destroy(&pool.sinal_ociosos);
+    indice_trabalhador = -1;
+    atomic_store(&pool.ativo, 0);
+}
+
+int pool_tarefas_ativo(void) {
+    return atomic_load(&pool.ativo) && indice_trabalhador >= 0;
+}
+
+int numero_threads_pool(void) {
+    return atomic_load(&pool.ativo) ? pool.num_threads : 1;
+}
+
+void tarefa_criar(Tarefa *tarefa, FuncaoTarefa funcao, void *argumento) {
+    tarefa->funcao = funcao;
+    tarefa->argumento = argumento;
+    atomic_store(&tarefa->concluida, 0);
+
+    if (!pool_tarefas_ativo()) {
+        executar_tarefa(tarefa);
+        return;
+    }
+    empilhar(&pool.filas[indice_trabalhador], tarefa);
+}
+
+void tarefa_aguardar(Tarefa *tarefa) {
+    while (!atomic_load_explicit(&tarefa->concluida, memory_order_acquire)) {
+        Tarefa *outra = buscar_tarefa(indice_trabalhador);
+        if (outra != NULL) {
+            executar_tarefa(outra);
+        } else {
+            // A tarefa foi roubada e ainda está em execução em outra thread
+            sched_yield();
+        }
+    }
+}
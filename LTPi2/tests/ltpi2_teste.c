@@ -0,0 +1,571 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include "ltpi2.h"
+#include "nucleos.h"
+
+// --- TESTES DE CONSISTÊNCIA DA ARITMÉTICA ---
+/*
+ * Cada algoritmo rápido é conferido contra um mais simples, nos tamanhos
+ * em que a escolha entre eles muda: em cada limiar t (limiares.h, ou o
+ * arquivo regravado por make tune) os tamanhos t - 1, t e t + 1, com
+ * operandos aleatórios e com todos os bits em 1 (o pior caso dos carries).
+ * O algoritmo de cada lado é forçado com definir_limiares:
+ *
+ *   multiplicação   tradicional (produto escolar deste arquivo) contra
+ *                   Karatsuba, Toom-3 3x3/3x2/4x2, Toom-4 4x4/5x3/4x2/6x2 e,
+ *                   acima do limiar da NTT, Karatsuba contra NTT; a NTT
+ *                   também é forçada em tamanhos pequenos contra o escolar
+ *   quadrados       os mesmos quatro limiares próprios
+ *   divisão         Newton contra o Algoritmo D (quociente e resto iguais,
+ *                   e N = Q·D + R com 0 <= R < D)
+ *   raiz quadrada   S² + R = N com 0 <= R <= 2S, e quadrados exatos
+ *   divisão exata   Hensel (eliminação e inverso por Newton) contra Q·D / D
+ *   núcleos SIMD    cada versão de listar_nucleos contra a escalar, bit a
+ *                   bit: todos os tamanhos de 1 a 300 blocos, carry de
+ *                   entrada (também atravessando todos os blocos), r = a e r = b, as duas ordens dos operandos e
+ *                   o limite de colunas do IFMA (2048 blocos, e 4097, que
+ *                   estouraria o acumulador)
+ *   Pi              10000 casas contra dígitos conhecidos
+ *
+ * A sequência aleatória é fixa, então uma falha se repete. Sai com código 1
+ * se alguma verificação falhar (make test).
+ */
+
+#define DESLIGADO (1 << 30)
+#define LIMIAR_MAXIMO_TESTADO (1 << 16)   // Acima disto o limiar está desligado
+#define PI_DIGITOS_TESTE 10000
+
+#define OPERANDO_ALEATORIO 0
+#define OPERANDO_UNS 1
+#define OPERANDO_CADEIA 2   // Só em somar/subtrair: o carry de entrada atravessa todos os blocos
+
+// Primeiras e últimas casas de Pi com PI_DIGITOS_TESTE casas
+static const char *pi_inicio = "3.1415926535897932384626433832795028841971693993751058209749445923";
+static const char *pi_fim = "46101264836999892256959688159205600101655256375678";
+
+static Limiares padrao;
+static int verificacoes = 0;
+static int falhas = 0;
+
+static uint64_t estado_aleatorio = 0x9E3779B97F4A7C15ULL;
+
+static uint32_t aleatorio32(void) {
+    estado_aleatorio ^= estado_aleatorio << 13;
+    estado_aleatorio ^= estado_aleatorio >> 7;
+    estado_aleatorio ^= estado_aleatorio << 17;
+    return (uint32_t)estado_aleatorio;
+}
+
+static GrandeNumero* operando(int blocos, int tipo) {
+    GrandeNumero *x = criar_grande_numero(blocos);
+    for (int i = 0; i < blocos; i++) x->blocos[i] = (tipo == OPERANDO_UNS) ? 0xFFFFFFFFu : aleatorio32();
+    if (x->blocos[blocos - 1] == 0) x->blocos[blocos - 1] = 1;
+    x->quantidade_blocos = blocos;
+    return x;
+}
+
+static const char* nome_operando(int tipo) {
+    return (tipo == OPERANDO_UNS) ? "uns" : (tipo == OPERANDO_CADEIA) ? "cadeia de carry" : "aleatório";
+}
+
+static void conferir(int ok, const char *formato, ...) {
+    verificacoes++;
+    if (ok) return;
+    falhas++;
+    va_list args;
+    va_start(args, formato);
+    printf("FALHA: ");
+    vprintf(formato, args);
+    printf("\n");
+    va_end(args);
+}
+
+static int limiar_testavel(int limiar) {
+    return limiar > 1 && limiar <= LIMIAR_MAXIMO_TESTADO;
+}
+
+// --- Configurações de limiares ---
+
+static Limiares sem_ntt(void) {
+    Limiares l = padrao;
+    l.ntt = l.quadrado_ntt = DESLIGADO;
+    return l;
+}
+
+static Limiares so_karatsuba(void) {
+    Limiares l = sem_ntt();
+    l.toom3 = l.toom4 = l.quadrado_toom3 = l.quadrado_toom4 = DESLIGADO;
+    return l;
+}
+
+// --- Multiplicação e quadrados ---
+
+// Produto escolar independente dos núcleos da biblioteca
+static GrandeNumero* produto_escolar(const GrandeNumero *a, const GrandeNumero *b) {
+    int n = a->quantidade_blocos + b->quantidade_blocos;
+    GrandeNumero *r = criar_grande_numero(n);
+    memset(r->blocos, 0, (size_t)n * sizeof(uint32_t));
+    for (int i = 0; i < a->quantidade_blocos; i++) {
+        uint64_t carry = 0;
+        for (int j = 0; j < b->quantidade_blocos; j++) {
+            uint64_t t = (uint64_t)a->blocos[i] * b->blocos[j] + r->blocos[i + j] + carry;
+            r->blocos[i + j] = (uint32_t)t;
+            carry = t >> 32;
+        }
+        r->blocos[i + b->quantidade_blocos] = (uint32_t)carry;
+    }
+    while (n > 1 && r->blocos[n - 1] == 0) n--;
+    r->quantidade_blocos = n;
+    return r;
+}
+
+// b == NULL: quadrado. referencia == NULL: produto escolar.
+static void conferir_produto(const char *nome, const GrandeNumero *a, const GrandeNumero *b, int tipo,
+                             const Limiares *testado, const Limiares *referencia) {
+    GrandeNumero *r = criar_grande_numero(1);
+    GrandeNumero *esperado;
+    definir_limiares(testado);
+    if (b == NULL) elevar_ao_quadrado(a, r);
+    else multiplicar_grandes_numeros(a, b, r);
+
+    if (referencia == NULL) {
+        esperado = produto_escolar(a, (b == NULL) ? a : b);
+    } else {
+        esperado = criar_grande_numero(1);
+        definir_limiares(referencia);
+        if (b == NULL) elevar_ao_quadrado(a, esperado);
+        else multiplicar_grandes_numeros(a, b, esperado);
+    }
+    definir_limiares(&padrao);
+
+    conferir(comparar_grandes_numeros(r, esperado) == 0, "%s %d x %d blocos (%s)",
+             nome, a->quantidade_blocos, (b == NULL) ? a->quantidade_blocos : b->quantidade_blocos,
+             nome_operando(tipo));
+    liberar_grande_numero(r);
+    liberar_grande_numero(esperado);
+}
+
+static void conferir_tamanhos(const char *nome, int na, int nb, int tipo, const Limiares *testado, const Limiares *referencia) {
+    GrandeNumero *a = operando(na, tipo);
+    GrandeNumero *b = (nb > 0) ? operando(nb, tipo) : NULL;
+    conferir_produto(nome, a, b, tipo, testado, referencia);
+    liberar_grande_numero(a);
+    if (b != NULL) liberar_grande_numero(b);
+}
+
+typedef struct {
+    const char *nome;
+    int toom4;          // 0 = limiar de Toom-3, 1 = de Toom-4
+    int num, den;       // na / nb que escolhe o formato em formato_toom
+} FormatoToom;
+
+static const FormatoToom formatos_toom[] = {
+    { "Toom-3 3x3", 0, 1, 1 },
+    { "Toom-3 3x2", 0, 3, 2 },
+    { "Toom-3 4x2", 0, 2, 1 },
+    { "Toom-4 4x4", 1, 1, 1 },
+    { "Toom-4 5x3", 1, 5, 3 },
+    { "Toom-4 4x2", 1, 2, 1 },
+    { "Toom-4 6x2", 1, 3, 1 },
+};
+
+static void testar_multiplicacao(void) {
+    Limiares toom = sem_ntt(), karatsuba = so_karatsuba();
+
+    for (int tipo = OPERANDO_ALEATORIO; tipo <= OPERANDO_UNS; tipo++) {
+        // Tradicional x Karatsuba, balanceado e desbalanceado
+        if (limiar_testavel(padrao.karatsuba)) {
+            for (int n = padrao.karatsuba - 1; n <= padrao.karatsuba + 1; n++) {
+                conferir_tamanhos("Karatsuba", n, n, tipo, &karatsuba, NULL);
+                conferir_tamanhos("Karatsuba", 3 * n + 1, n, tipo, &karatsuba, NULL);
+            }
+        }
+
+        // Cada formato de Toom no seu limiar (o menor operando decide)
+        for (size_t f = 0; f < sizeof(formatos_toom) / sizeof(formatos_toom[0]); f++) {
+            const FormatoToom *formato = &formatos_toom[f];
+            int limiar = formato->toom4 ? padrao.toom4 : padrao.toom3;
+            if (!limiar_testavel(limiar)) continue;
+            for (int nb = limiar - 1; nb <= limiar + 1; nb++) {
+                conferir_tamanhos(formato->nome, nb * formato->num / formato->den, nb, tipo, &toom, NULL);
+            }
+        }
+
+        // NTT no seu limiar, contra Karatsuba
+        if (limiar_testavel(padrao.ntt)) {
+            for (int n = padrao.ntt - 1; n <= padrao.ntt + 1; n++) {
+                conferir_tamanhos("NTT", n, n, tipo, &padrao, &karatsuba);
+            }
+            conferir_tamanhos("NTT", 2 * padrao.ntt + 1, padrao.ntt, tipo, &padrao, &karatsuba);
+        }
+
+        // NTT forçada em tamanhos pequenos, contra o escolar
+        Limiares ntt = sem_ntt();
+        ntt.ntt = ntt.quadrado_ntt = 16;
+        static const int pequenos[][2] = { { 16, 16 }, { 17, 16 }, { 100, 33 }, { 257, 255 }, { 1000, 999 } };
+        for (size_t i = 0; i < sizeof(pequenos) / sizeof(pequenos[0]); i++) {
+            conferir_tamanhos("NTT forçada", pequenos[i][0], pequenos[i][1], tipo, &ntt, NULL);
+            conferir_tamanhos("NTT forçada (quadrado)", pequenos[i][0], 0, tipo, &ntt, NULL);
+        }
+    }
+}
+
+static void testar_quadrados(void) {
+    struct { const char *nome; int limiar; int ntt; } limiares_quadrado[] = {
+        { "quadrado Karatsuba", padrao.quadrado_karatsuba, 0 },
+        { "quadrado Toom-3", padrao.quadrado_toom3, 0 },
+        { "quadrado Toom-4", padrao.quadrado_toom4, 0 },
+        { "quadrado NTT", padrao.quadrado_ntt, 1 },
+    };
+    Limiares toom = sem_ntt(), karatsuba = so_karatsuba();
+
+    for (int tipo = OPERANDO_ALEATORIO; tipo <= OPERANDO_UNS; tipo++) {
+        for (size_t i = 0; i < sizeof(limiares_quadrado) / sizeof(limiares_quadrado[0]); i++) {
+            int limiar = limiares_quadrado[i].limiar;
+            if (!limiar_testavel(limiar)) continue;
+            for (int n = limiar - 1; n <= limiar + 1; n++) {
+                if (limiares_quadrado[i].ntt) conferir_tamanhos(limiares_quadrado[i].nome, n, 0, tipo, &padrao, &karatsuba);
+                else conferir_tamanhos(limiares_quadrado[i].nome, n, 0, tipo, &toom, NULL);
+            }
+        }
+    }
+}
+
+// --- Divisão ---
+
+// N = Q·D + R com 0 <= R < D
+static int divisao_consistente(const GrandeNumero *n, const GrandeNumero *d, const GrandeNumero *q, const GrandeNumero *r) {
+    GrandeNumero *reconstruido = criar_grande_numero(1);
+    multiplicar_grandes_numeros(q, d, reconstruido);
+    somar_grandes_numeros(reconstruido, r, reconstruido);
+    int ok = comparar_grandes_numeros(reconstruido, n) == 0 && r->sinal > 0 && comparar_grandes_numeros(r, d) < 0;
+    liberar_grande_numero(reconstruido);
+    return ok;
+}
+
+static void conferir_divisao(const char *nome, int nq, int nd, int tipo, const Limiares *testado) {
+    Limiares knuth = padrao;
+    knuth.divisao_newton = DESLIGADO;
+    GrandeNumero *n = operando(nq + nd, tipo);
+    GrandeNumero *d = operando(nd, tipo);
+    GrandeNumero *q = criar_grande_numero(1), *r = criar_grande_numero(1);
+    GrandeNumero *q_knuth = criar_grande_numero(1), *r_knuth = criar_grande_numero(1);
+
+    definir_limiares(testado);
+    dividir_com_resto(n, d, q, r);
+    definir_limiares(&knuth);
+    dividir_com_resto(n, d, q_knuth, r_knuth);
+    definir_limiares(&padrao);
+
+    conferir(comparar_grandes_numeros(q, q_knuth) == 0 && comparar_grandes_numeros(r, r_knuth) == 0 &&
+             divisao_consistente(n, d, q, r),
+             "%s: %d / %d blocos (%s)", nome, nq + nd, nd, nome_operando(tipo));
+
+    liberar_grande_numero(n);
+    liberar_grande_numero(d);
+    liberar_grande_numero(q);
+    liberar_grande_numero(r);
+    liberar_grande_numero(q_knuth);
+    liberar_grande_numero(r_knuth);
+}
+
+static void testar_divisao(void) {
+    Limiares newton = padrao;
+    newton.divisao_newton = 16;
+    int t = padrao.divisao_newton;
+
+    for (int tipo = OPERANDO_ALEATORIO; tipo <= OPERANDO_UNS; tipo++) {
+        // Newton vale quando divisor e quociente passam do limiar
+        if (limiar_testavel(t)) {
+            for (int k = t - 1; k <= t + 1; k++) {
+                conferir_divisao("Newton x Algoritmo D", k, k, tipo, &padrao);
+                conferir_divisao("Newton x Algoritmo D", k, t + 1, tipo, &padrao);
+                conferir_divisao("Newton x Algoritmo D", t + 1, k, tipo, &padrao);
+            }
+            conferir_divisao("Newton x Algoritmo D", 3 * t, t + 1, tipo, &padrao);
+        }
+        // Newton forçado em tamanhos pequenos
+        static const int pequenos[][2] = { { 16, 16 }, { 17, 16 }, { 40, 17 }, { 17, 90 }, { 300, 200 } };
+        for (size_t i = 0; i < sizeof(pequenos) / sizeof(pequenos[0]); i++) {
+            conferir_divisao("Newton forçado x Algoritmo D", pequenos[i][0], pequenos[i][1], tipo, &newton);
+        }
+    }
+}
+
+// --- Raiz quadrada com resto ---
+
+static void conferir_raiz(const GrandeNumero *n, const char *descricao, int tipo) {
+    GrandeNumero *s = criar_grande_numero(1), *r = criar_grande_numero(1);
+    GrandeNumero *x = criar_grande_numero(1), *dobro = criar_grande_numero(1);
+    raiz_quadrada_resto(n, s, r);
+    elevar_ao_quadrado(s, x);
+    somar_grandes_numeros(x, r, x);
+    somar_grandes_numeros(s, s, dobro);
+    conferir(comparar_grandes_numeros(x, n) == 0 && r->sinal > 0 && comparar_grandes_numeros(r, dobro) <= 0,
+             "raiz quadrada %s de %d blocos (%s)", descricao, n->quantidade_blocos, nome_operando(tipo));
+    liberar_grande_numero(s);
+    liberar_grande_numero(r);
+    liberar_grande_numero(x);
+    liberar_grande_numero(dobro);
+}
+
+// Quadrados exatos: sqrt(X²) = X com resto 0, e sqrt(X² - 1) = X - 1 com resto 2X - 2
+static void conferir_raiz_exata(int blocos, int tipo) {
+    GrandeNumero *x = operando(blocos, tipo);
+    GrandeNumero *n = criar_grande_numero(1), *s = criar_grande_numero(1), *r = criar_grande_numero(1);
+    GrandeNumero *um = criar_grande_numero(1), *esperado = criar_grande_numero(1);
+    definir_valor_inteiro(um, 1);
+
+    elevar_ao_quadrado(x, n);
+    raiz_quadrada_resto(n, s, r);
+    conferir(comparar_grandes_numeros(s, x) == 0 && eh_zero(r),
+             "raiz quadrada exata de %d blocos (%s)", n->quantidade_blocos, nome_operando(tipo));
+
+    subtrair_grandes_numeros(n, um, n);
+    raiz_quadrada_resto(n, s, r);
+    subtrair_grandes_numeros(x, um, x);
+    somar_grandes_numeros(x, x, esperado);
+    conferir(comparar_grandes_numeros(s, x) == 0 && comparar_grandes_numeros(r, esperado) == 0,
+             "raiz quadrada de X² - 1 com %d blocos (%s)", n->quantidade_blocos, nome_operando(tipo));
+
+    liberar_grande_numero(x);
+    liberar_grande_numero(n);
+    liberar_grande_numero(s);
+    liberar_grande_numero(r);
+    liberar_grande_numero(um);
+    liberar_grande_numero(esperado);
+}
+
+static void testar_raiz(void) {
+    // A raiz de n blocos multiplica operandos de ~n/2 blocos: os limiares
+    // da multiplicação e da divisão aparecem em 2t
+    int limiares_raiz[] = { 1, padrao.karatsuba, padrao.quadrado_karatsuba, padrao.toom3,
+                            padrao.quadrado_toom3, padrao.divisao_newton };
+    for (int tipo = OPERANDO_ALEATORIO; tipo <= OPERANDO_UNS; tipo++) {
+        for (size_t i = 0; i < sizeof(limiares_raiz) / sizeof(limiares_raiz[0]); i++) {
+            int t = limiares_raiz[i];
+            if (!limiar_testavel(t)) continue;
+            for (int n = 2 * t - 1; n <= 2 * t + 1; n++) {
+                GrandeNumero *x = operando(n, tipo);
+                conferir_raiz(x, "com resto", tipo);
+                liberar_grande_numero(x);
+            }
+            conferir_raiz_exata(t, tipo);
+        }
+    }
+}
+
+// --- Divisão exata ---
+
+static void conferir_divisao_exata(const char *nome, int nq, int nd, int bits_pares, int tipo, const Limiares *testado) {
+    GrandeNumero *q = operando(nq, tipo), *d = operando(nd, tipo);
+    GrandeNumero *n = criar_grande_numero(1), *resultado = criar_grande_numero(1);
+    GrandeNumero *potencia = criar_grande_numero(1);
+
+    // Fatores 2 no divisor passam pelo deslocamento antes da divisão
+    potencia_inteira(2, bits_pares, potencia);
+    multiplicar_grandes_numeros(d, potencia, d);
+    multiplicar_grandes_numeros(q, d, n);
+
+    definir_limiares(testado);
+    dividir_exato(n, d, resultado);
+    definir_limiares(&padrao);
+    conferir(comparar_grandes_numeros(resultado, q) == 0, "%s: quociente de %d blocos, divisor de %d blocos * 2^%d (%s)",
+             nome, nq, nd, bits_pares, nome_operando(tipo));
+
+    liberar_grande_numero(q);
+    liberar_grande_numero(d);
+    liberar_grande_numero(n);
+    liberar_grande_numero(resultado);
+    liberar_grande_numero(potencia);
+}
+
+static void testar_divisao_exata(void) {
+    Limiares basica = padrao, hensel = padrao;
+    basica.divisao_exata = DESLIGADO;
+    hensel.divisao_exata = 4;
+    int t = padrao.divisao_exata;
+
+    for (int tipo = OPERANDO_ALEATORIO; tipo <= OPERANDO_UNS; tipo++) {
+        if (limiar_testavel(t)) {
+            for (int k = t - 1; k <= t + 1; k++) {
+                conferir_divisao_exata("divisão exata", k, k, 0, tipo, &padrao);
+                conferir_divisao_exata("divisão exata", k, t + 1, 37, tipo, &padrao);
+                conferir_divisao_exata("divisão exata", t + 1, k, 64, tipo, &padrao);
+                // Quociente em várias fatias do inverso
+                conferir_divisao_exata("divisão exata", 3 * k + 1, t + 1, 1, tipo, &padrao);
+                conferir_divisao_exata("divisão exata básica", k, k, 5, tipo, &basica);
+            }
+        }
+        conferir_divisao_exata("divisão exata por Newton", 5, 5, 0, tipo, &hensel);
+        conferir_divisao_exata("divisão exata por Newton", 100, 7, 3, tipo, &hensel);
+        conferir_divisao_exata("divisão exata por Newton", 33, 200, 32, tipo, &hensel);
+    }
+}
+
+// --- Núcleos SIMD contra o escalar ---
+
+// Palavras depois do resultado: uma escrita fora da faixa também é diferença
+#define GUARDA_NUCLEOS 8
+#define VALOR_GUARDA 0xA5A5A5A5u
+#define NUCLEOS_MAXIMO_PEQUENO 300
+
+static uint32_t* vetor_operando(int n, int tipo) {
+    uint32_t *v = (uint32_t*)malloc((size_t)n * sizeof(uint32_t));
+    for (int i = 0; i < n; i++) v[i] = (tipo == OPERANDO_UNS) ? 0xFFFFFFFFu : aleatorio32();
+    return v;
+}
+
+static uint32_t* vetor_saida(int n) {
+    uint32_t *v = (uint32_t*)malloc((size_t)(n + GUARDA_NUCLEOS) * sizeof(uint32_t));
+    for (int i = 0; i < n + GUARDA_NUCLEOS; i++) v[i] = VALOR_GUARDA;
+    return v;
+}
+
+static int vetores_iguais(const uint32_t *x, const uint32_t *y, int n) {
+    return memcmp(x, y, (size_t)(n + GUARDA_NUCLEOS) * sizeof(uint32_t)) == 0;
+}
+
+// somar/subtrair com carry 0 e 1, fora do lugar e com r = a e r = b
+static void conferir_soma_nucleo(const NucleosBlocos *escalar, const NucleosBlocos *versao, int subtrair, int n, int tipo) {
+    uint32_t *a = vetor_operando(n, tipo), *b = vetor_operando(n, tipo);
+    if (tipo == OPERANDO_CADEIA) {
+        // a + ~a = 2^32n - 1 e a - a = 0: todo bloco repassa o carry
+        for (int i = 0; i < n; i++) b[i] = subtrair ? a[i] : ~a[i];
+    }
+    uint32_t *r = vetor_saida(n), *esperado = vetor_saida(n);
+    const char *nome = subtrair ? "subtrair" : "somar";
+    for (int alias = 0; alias < 3; alias++) {
+        for (uint32_t carry = 0; carry <= 1; carry++) {
+            const uint32_t *x[2], *y[2];
+            uint32_t *saidas[2] = { esperado, r }, retorno[2];
+            const NucleosBlocos *versoes[2] = { escalar, versao };
+            for (int v = 0; v < 2; v++) {
+                x[v] = a;
+                y[v] = b;
+                if (alias == 1) { memcpy(saidas[v], a, (size_t)n * sizeof(uint32_t)); x[v] = saidas[v]; }
+                if (alias == 2) { memcpy(saidas[v], b, (size_t)n * sizeof(uint32_t)); y[v] = saidas[v]; }
+                retorno[v] = subtrair ? versoes[v]->subtrair(saidas[v], x[v], y[v], n, carry)
+                                      : versoes[v]->somar(saidas[v], x[v], y[v], n, carry);
+            }
+            conferir(retorno[0] == retorno[1] && vetores_iguais(esperado, r, n), "%s.%s com %d blocos, carry %u%s (%s)",
+                     nome, versao->nome, n, carry, alias == 1 ? ", r = a" : alias == 2 ? ", r = b" : "", nome_operando(tipo));
+        }
+    }
+    free(a);
+    free(b);
+    free(r);
+    free(esperado);
+}
+
+// multiplicar_1 com multiplicador aleatório e 2^32 - 1, fora do lugar e com r = a
+static void conferir_multiplicar_1_nucleo(const NucleosBlocos *escalar, const NucleosBlocos *versao, int n, int tipo) {
+    uint32_t *a = vetor_operando(n, tipo);
+    uint32_t *r = vetor_saida(n), *esperado = vetor_saida(n);
+    uint32_t multiplicadores[2] = { aleatorio32(), 0xFFFFFFFFu };
+    for (int alias = 0; alias < 2; alias++) {
+        for (int m = 0; m < 2; m++) {
+            if (alias) {
+                memcpy(esperado, a, (size_t)n * sizeof(uint32_t));
+                memcpy(r, a, (size_t)n * sizeof(uint32_t));
+            }
+            uint32_t topo_esperado = escalar->multiplicar_1(esperado, alias ? esperado : a, n, multiplicadores[m]);
+            uint32_t topo = versao->multiplicar_1(r, alias ? r : a, n, multiplicadores[m]);
+            conferir(topo == topo_esperado && vetores_iguais(esperado, r, n), "multiplicar_1.%s com %d blocos, m = %08x%s (%s)",
+                     versao->nome, n, multiplicadores[m], alias ? ", r = a" : "", nome_operando(tipo));
+        }
+    }
+    free(a);
+    free(r);
+    free(esperado);
+}
+
+// multiplicar nas duas ordens dos operandos, e quadrado quando na == nb
+static void conferir_produto_nucleo(const NucleosBlocos *escalar, const NucleosBlocos *versao, int na, int nb, int tipo) {
+    uint32_t *a = vetor_operando(na, tipo), *b = vetor_operando(nb, tipo);
+    uint32_t *r = vetor_saida(na + nb), *esperado = vetor_saida(na + nb);
+    escalar->multiplicar(esperado, a, na, b, nb);
+    versao->multiplicar(r, a, na, b, nb);
+    conferir(vetores_iguais(esperado, r, na + nb), "multiplicar.%s %d x %d blocos (%s)", versao->nome, na, nb, nome_operando(tipo));
+    if (na != nb) {
+        versao->multiplicar(r, b, nb, a, na);
+        conferir(vetores_iguais(esperado, r, na + nb), "multiplicar.%s %d x %d blocos (%s)", versao->nome, nb, na, nome_operando(tipo));
+    } else {
+        escalar->quadrado(esperado, a, na);
+        versao->quadrado(r, a, na);
+        conferir(vetores_iguais(esperado, r, 2 * na), "quadrado.%s com %d blocos (%s)", versao->nome, na, nome_operando(tipo));
+    }
+    free(a);
+    free(b);
+    free(r);
+    free(esperado);
+}
+
+static void testar_nucleos(void) {
+    const NucleosBlocos *versoes[8];
+    int num_versoes = listar_nucleos(versoes, 8);
+    const NucleosBlocos *escalar = versoes[0];
+    // Em torno de COLUNA_MAXIMA_IFMA (nucleos.c), onde o menor operando
+    // decide o caminho, e logo acima de 4096 parcelas de 52 bits por coluna,
+    // que já estouram o acumulador de 64 bits com operandos todos em 1
+    static const int coluna_ifma[] = { 2040, 2047, 2048, 2049, 2056, 4097 };
+
+    for (int v = 1; v < num_versoes; v++) {
+        for (int tipo = OPERANDO_ALEATORIO; tipo <= OPERANDO_UNS; tipo++) {
+            for (int n = 1; n <= NUCLEOS_MAXIMO_PEQUENO; n++) {
+                conferir_soma_nucleo(escalar, versoes[v], 0, n, tipo);
+                conferir_soma_nucleo(escalar, versoes[v], 1, n, tipo);
+                conferir_soma_nucleo(escalar, versoes[v], 0, n, OPERANDO_CADEIA);
+                conferir_soma_nucleo(escalar, versoes[v], 1, n, OPERANDO_CADEIA);
+                conferir_multiplicar_1_nucleo(escalar, versoes[v], n, tipo);
+                conferir_produto_nucleo(escalar, versoes[v], n, n, tipo);
+                conferir_produto_nucleo(escalar, versoes[v], n, n / 3 + 1, tipo);
+            }
+            for (size_t i = 0; i < sizeof(coluna_ifma) / sizeof(coluna_ifma[0]); i++) {
+                conferir_produto_nucleo(escalar, versoes[v], coluna_ifma[i], coluna_ifma[i], tipo);
+                conferir_produto_nucleo(escalar, versoes[v], coluna_ifma[i] + 517, coluna_ifma[i], tipo);
+            }
+        }
+    }
+}
+
+// --- Pi ---
+
+static void testar_pi(void) {
+    char *pi = calcular_pi(PI_DIGITOS_TESTE);
+    size_t fim = strlen(pi_fim);
+    conferir(pi != NULL && strlen(pi) == (size_t)PI_DIGITOS_TESTE + 2 &&
+             strncmp(pi, pi_inicio, strlen(pi_inicio)) == 0 &&
+             strcmp(pi + PI_DIGITOS_TESTE + 2 - fim, pi_fim) == 0,
+             "Pi com %d casas difere dos dígitos conhecidos", PI_DIGITOS_TESTE);
+    free(pi);
+}
+
+int main(void) {
+    obter_limiares(&padrao);
+    printf("Núcleos: %s\n", nucleos_ativos->nome);
+    printf("Limiares: karatsuba %d, toom3 %d, toom4 %d, ntt %d, quadrados %d/%d/%d/%d, newton %d, exata %d\n",
+           padrao.karatsuba, padrao.toom3, padrao.toom4, padrao.ntt,
+           padrao.quadrado_karatsuba, padrao.quadrado_toom3, padrao.quadrado_toom4, padrao.quadrado_ntt,
+           padrao.divisao_newton, padrao.divisao_exata);
+
+    struct { const char *nome; void (*executar)(void); } grupos[] = {
+        { "multiplicação", testar_multiplicacao },
+        { "quadrados", testar_quadrados },
+        { "divisão", testar_divisao },
+        { "raiz quadrada", testar_raiz },
+        { "divisão exata", testar_divisao_exata },
+        { "núcleos SIMD", testar_nucleos },
+        { "Pi", testar_pi },
+    };
+    for (size_t i = 0; i < sizeof(grupos) / sizeof(grupos[0]); i++) {
+        int antes = verificacoes, falhas_antes = falhas;
+        grupos[i].executar();
+        printf("  %5d verificações, %d falhas: %s\n", verificacoes - antes, falhas - falhas_antes, grupos[i].nome);
+    }
+
+    printf("%d verificações, %d falhas\n", verificacoes, falhas);
+    return (falhas > 0) ? 1 : 0;
+}